@@ -0,0 +1,51 @@
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t t_allocationCount;
+
+// (the aligned variants are not replaced, hence not counted)
+
+void* operator new(size_t size)
+{
+	++t_allocationCount;
+	if (void* memory = std::malloc(size != 0 ? size : 1))
+	{
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace benchmarks
+{
+	uint64_t GetThreadAllocationCount()
+	{
+		return t_allocationCount;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cinttypes>
+
+namespace benchmarks
+{
+	/// <summary>
+	/// Gets how many times the current thread has called operator new.
+	/// </summary>
+	uint64_t GetThreadAllocationCount();
+
+	/// <summary>
+	/// Counts the allocations made by the current thread in a benchmark loop,
+	/// so that they are reported as "allocs/op".
+	/// </summary>
+	class AllocationCounter
+	{
+	private:
+
+		benchmark::State& m_state;
+		const uint64_t m_initialCount;
+
+	public:
+
+		AllocationCounter(benchmark::State& state)
+			: m_state(state)
+			, m_initialCount(GetThreadAllocationCount())
+		{
+		}
+
+		~AllocationCounter()
+		{
+			m_state.counters["allocs/op"] = benchmark::Counter(
+				static_cast<double>(GetThreadAllocationCount() - m_initialCount),
+				benchmark::Counter::kAvgIterations);
+		}
+	};
+}
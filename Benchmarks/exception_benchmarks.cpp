@@ -0,0 +1,105 @@
+#include "allocation_counter.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#	include <MinCppXtra/call_stack.hpp>
+#	include <MinCppXtra/traceable_exception.hpp>
+#endif
+
+#ifdef _MSC_VER
+#	define NOINLINE __declspec(noinline)
+#else
+#	define NOINLINE __attribute__((noinline))
+#endif
+
+namespace benchmarks
+{
+	static const int64_t DEPTHS[] = { 1, 8, 32 };
+
+	template <typename Exception>
+	static NOINLINE void ThrowAt(int64_t depth)
+	{
+		if (depth > 1)
+		{
+			ThrowAt<Exception>(depth - 1);
+			benchmark::ClobberMemory(); // prevents tail call
+			return;
+		}
+		throw Exception("benchmark");
+	}
+
+	template <typename Exception>
+	static void ThrowAndCatch(benchmark::State& state)
+	{
+		AllocationCounter allocationCounter(state);
+		for (auto _ : state)
+		{
+			try
+			{
+				ThrowAt<Exception>(state.range(0));
+			}
+			catch (std::exception& ex)
+			{
+				benchmark::DoNotOptimize(ex.what());
+			}
+		}
+	}
+
+	static void AddThrowArgs(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgName("depth");
+		for (int64_t depth : DEPTHS)
+		{
+			benchmark->Arg(depth);
+		}
+		benchmark->ThreadRange(1, 8)->UseRealTime();
+	}
+
+	BENCHMARK_TEMPLATE(ThrowAndCatch, std::runtime_error)->Apply(AddThrowArgs);
+
+#ifdef _WIN32
+	BENCHMARK_TEMPLATE(ThrowAndCatch, mincpp::TraceableException)->Apply(AddThrowArgs);
+
+	static NOINLINE std::string GetTraceAt(int64_t depth)
+	{
+		if (depth > 1)
+		{
+			std::string trace = GetTraceAt(depth - 1);
+			benchmark::ClobberMemory();
+			return trace;
+		}
+		return mincpp::CallStack::GetTrace();
+	}
+
+	static void CallStackGetTrace(benchmark::State& state)
+	{
+		AllocationCounter allocationCounter(state);
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(GetTraceAt(state.range(0)));
+		}
+	}
+
+	BENCHMARK(CallStackGetTrace)->ArgName("depth")->Arg(1)->Arg(8)->Arg(32);
+
+	static void TraceableExceptionSerialize(benchmark::State& state)
+	{
+		try
+		{
+			ThrowAt<mincpp::TraceableException>(state.range(0));
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			AllocationCounter allocationCounter(state);
+			for (auto _ : state)
+			{
+				benchmark::DoNotOptimize(ex.Serialize());
+			}
+		}
+	}
+
+	BENCHMARK(TraceableExceptionSerialize)->ArgName("depth")->Arg(1)->Arg(8)->Arg(32);
+#endif
+}
@@ -0,0 +1,270 @@
+#include "exception_storm.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#	include <MinCppXtra/traceable_exception.hpp>
+#	include <MinCppXtra/trace_metrics.hpp>
+#endif
+
+#ifdef _MSC_VER
+#	define NOINLINE __declspec(noinline)
+#else
+#	define NOINLINE __attribute__((noinline))
+#endif
+
+namespace benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct StormOptions
+	{
+		std::vector<uint32_t> threadCounts{ 1, 2, 4, 8, 16, 32, 64 };
+		uint32_t depth = 8;
+		uint32_t throwsPerSecond = 0;
+		std::chrono::milliseconds duration{ 2000 };
+		bool useTraceableException = true;
+	};
+
+	struct StormResult
+	{
+		uint32_t threadCount;
+		uint64_t throwCount;
+		double throwsPerSecond;
+		uint64_t p50Nanoseconds;
+		uint64_t p99Nanoseconds;
+		uint64_t p999Nanoseconds;
+		uint64_t lockWaitNanosecondsPerThrow;
+		uint64_t lockWaitP99Nanoseconds;
+	};
+
+	static std::vector<uint32_t> ParseList(std::string_view text)
+	{
+		std::vector<uint32_t> values;
+		std::istringstream iss{ std::string(text) };
+		std::string item;
+		while (std::getline(iss, item, ','))
+		{
+			values.push_back(static_cast<uint32_t>(std::stoul(item)));
+		}
+		return values;
+	}
+
+	static StormOptions ParseOptions(int argc, char* argv[])
+	{
+		StormOptions options;
+		for (int idx = 1; idx < argc; ++idx)
+		{
+			const std::string_view arg(argv[idx]);
+			const size_t separator = arg.find('=');
+			const std::string_view name = arg.substr(0, separator);
+			const std::string value(separator != arg.npos ? arg.substr(separator + 1) : "");
+
+			if (name == "--threads")
+			{
+				options.threadCounts = ParseList(value);
+			}
+			else if (name == "--depth")
+			{
+				options.depth = static_cast<uint32_t>(std::stoul(value));
+			}
+			else if (name == "--rate")
+			{
+				options.throwsPerSecond = static_cast<uint32_t>(std::stoul(value));
+			}
+			else if (name == "--duration")
+			{
+				options.duration = std::chrono::milliseconds(
+					static_cast<int64_t>(std::stod(value) * 1000));
+			}
+			else if (name == "--exception")
+			{
+				options.useTraceableException = (value != "std");
+			}
+			else if (name != "--storm")
+			{
+				throw std::invalid_argument("unknown option " + std::string(arg));
+			}
+		}
+
+#ifndef _WIN32
+		options.useTraceableException = false; // (not available here)
+#endif
+		return options;
+	}
+
+	template <typename Exception>
+	static NOINLINE void ThrowAt(uint32_t depth)
+	{
+		if (depth > 1)
+		{
+			ThrowAt<Exception>(depth - 1);
+			std::atomic_signal_fence(std::memory_order_seq_cst); // prevents tail call
+			return;
+		}
+		throw Exception("storm");
+	}
+
+	static void ThrowAndCatch(const StormOptions& options)
+	{
+		try
+		{
+#ifdef _WIN32
+			if (options.useTraceableException)
+			{
+				ThrowAt<mincpp::TraceableException>(options.depth);
+			}
+#endif
+			ThrowAt<std::runtime_error>(options.depth);
+		}
+		catch (std::exception&)
+		{
+		}
+	}
+
+	static void RunThread(const StormOptions& options,
+						  const std::atomic<bool>& isStarted,
+						  Clock::time_point deadline,
+						  std::vector<uint32_t>& latencies)
+	{
+		while (!isStarted.load(std::memory_order_acquire))
+		{
+			std::this_thread::yield();
+		}
+
+		const auto interval = options.throwsPerSecond != 0
+			? Clock::duration(std::chrono::seconds(1)) / options.throwsPerSecond
+			: Clock::duration::zero();
+
+		auto nextThrowTime = Clock::now();
+		while (nextThrowTime < deadline)
+		{
+			if (interval != Clock::duration::zero())
+			{
+				std::this_thread::sleep_until(nextThrowTime);
+				nextThrowTime += interval;
+			}
+
+			const auto startTime = Clock::now();
+			ThrowAndCatch(options);
+			const auto endTime = Clock::now();
+
+			latencies.push_back(static_cast<uint32_t>(std::min<int64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count(),
+				UINT32_MAX)));
+
+			if (interval == Clock::duration::zero())
+			{
+				nextThrowTime = endTime;
+			}
+		}
+	}
+
+	static uint64_t GetPercentile(const std::vector<uint32_t>& sortedValues, double percentile)
+	{
+		if (sortedValues.empty())
+		{
+			return 0;
+		}
+		const auto rank = static_cast<size_t>(percentile / 100.0 * (sortedValues.size() - 1));
+		return sortedValues[rank];
+	}
+
+	static StormResult RunStorm(const StormOptions& options, uint32_t threadCount)
+	{
+#ifdef _WIN32
+		mincpp::TraceMetrics::Reset();
+		mincpp::TraceMetrics::Enable(true);
+#endif
+		std::vector<std::vector<uint32_t>> latenciesPerThread(threadCount);
+		for (auto& latencies : latenciesPerThread)
+		{
+			latencies.reserve(1 << 16);
+		}
+
+		std::atomic<bool> isStarted(false);
+		std::vector<std::thread> threads;
+		const auto startTime = Clock::now() + std::chrono::milliseconds(50);
+		const auto deadline = startTime + options.duration;
+		for (uint32_t idx = 0; idx < threadCount; ++idx)
+		{
+			threads.emplace_back(RunThread,
+								 std::cref(options),
+								 std::cref(isStarted),
+								 deadline,
+								 std::ref(latenciesPerThread[idx]));
+		}
+
+		std::this_thread::sleep_until(startTime);
+		isStarted.store(true, std::memory_order_release);
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+		const std::chrono::duration<double> elapsed = Clock::now() - startTime;
+
+		std::vector<uint32_t> latencies;
+		for (const auto& threadLatencies : latenciesPerThread)
+		{
+			latencies.insert(latencies.end(), threadLatencies.begin(), threadLatencies.end());
+		}
+		std::sort(latencies.begin(), latencies.end());
+
+		StormResult result{};
+		result.threadCount = threadCount;
+		result.throwCount = latencies.size();
+		result.throwsPerSecond = latencies.size() / elapsed.count();
+		result.p50Nanoseconds = GetPercentile(latencies, 50);
+		result.p99Nanoseconds = GetPercentile(latencies, 99);
+		result.p999Nanoseconds = GetPercentile(latencies, 99.9);
+
+#ifdef _WIN32
+		mincpp::TraceMetrics::Enable(false);
+		const auto lockWait = mincpp::TraceMetrics::GetHistogram(mincpp::TraceMetric::LockWaitNanoseconds);
+		result.lockWaitNanosecondsPerThrow = result.throwCount != 0 ? lockWait.sum / result.throwCount : 0;
+		result.lockWaitP99Nanoseconds = lockWait.GetPercentile(99);
+#endif
+		return result;
+	}
+
+	int RunExceptionStorm(int argc, char* argv[])
+	{
+		try
+		{
+			const StormOptions options = ParseOptions(argc, argv);
+			std::cout << "exception,depth,threads,throws,throws_per_s,p50_ns,p99_ns,p999_ns,"
+						 "lock_wait_ns_per_throw,lock_wait_p99_ns" << std::endl;
+
+			for (uint32_t threadCount : options.threadCounts)
+			{
+				const StormResult result = RunStorm(options, threadCount);
+				std::cout << (options.useTraceableException ? "traceable" : "std") << ','
+						  << options.depth << ','
+						  << result.threadCount << ','
+						  << result.throwCount << ','
+						  << static_cast<uint64_t>(result.throwsPerSecond) << ','
+						  << result.p50Nanoseconds << ','
+						  << result.p99Nanoseconds << ','
+						  << result.p999Nanoseconds << ','
+						  << result.lockWaitNanosecondsPerThrow << ','
+						  << result.lockWaitP99Nanoseconds << std::endl;
+			}
+			return 0;
+		}
+		catch (std::exception& ex)
+		{
+			std::cerr << "Exception storm failed: " << ex.what() << std::endl;
+			return 1;
+		}
+	}
+}
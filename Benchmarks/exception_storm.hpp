@@ -0,0 +1,18 @@
+#pragma once
+
+namespace benchmarks
+{
+	/// <summary>
+	/// Runs the exception storm: for each count of threads, they all throw and catch
+	/// exceptions at once, then a line of the scaling curve is printed (CSV) with
+	/// throughput, percentiles of throw latency and time waiting for locks.
+	/// Options:
+	///   --threads=1,2,4,8,16,32,64  counts of threads in the curve
+	///   --depth=8                   stack depth of the throw
+	///   --rate=0                    throws per second per thread (0 = unlimited)
+	///   --duration=2                seconds per count of threads
+	///   --exception=traceable       or "std" for std::runtime_error
+	/// </summary>
+	/// <returns>The exit code of the program.</returns>
+	int RunExceptionStorm(int argc, char* argv[]);
+}
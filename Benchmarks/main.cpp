@@ -0,0 +1,34 @@
+#include "exception_storm.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+
+#ifdef _WIN32
+#	include <MinCppXtra/call_stack_access_scope.hpp>
+#endif
+
+// Run with --benchmark_out=<file> --benchmark_out_format=json
+// in order to get results that can be compared across versions,
+// or with --storm for the exception storm (see exception_storm.hpp).
+int main(int argc, char* argv[])
+{
+#ifdef _WIN32
+	mincpp::CallStackAccessScope callStackAccessScope;
+#endif
+
+	if (argc > 1 && std::string_view(argv[1]) == "--storm")
+	{
+		return benchmarks::RunExceptionStorm(argc, argv);
+	}
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+	{
+		return 1;
+	}
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
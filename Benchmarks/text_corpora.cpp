@@ -0,0 +1,88 @@
+#include "text_corpora.hpp"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace benchmarks
+{
+	std::string_view GetName(TextCorpus corpus)
+	{
+		switch (corpus)
+		{
+		case TextCorpus::Ascii:
+			return "ascii";
+		case TextCorpus::Latin:
+			return "latin";
+		case TextCorpus::Cjk:
+			return "cjk";
+		case TextCorpus::Emoji:
+			return "emoji";
+		default:
+			return "unknown";
+		}
+	}
+
+	static std::string_view GetSample(TextCorpus corpus)
+	{
+		switch (corpus)
+		{
+		case TextCorpus::Latin:
+			return "Größenwahn im Café: naïveté, señor, Ærøskøbing, Œuvre. ";
+		case TextCorpus::Cjk:
+			return "漢字仮名交じり文と한국어 문장을 섞은 텍스트입니다。中文字符也在这里。";
+		case TextCorpus::Emoji:
+			return "😀🚀🌍🎉👍🏽❤️🔥🧪 ";
+		default:
+			return "The quick brown fox jumps over the lazy dog. 0123456789 ";
+		}
+	}
+
+	static std::string MakeUtf8Text(TextCorpus corpus, size_t maxSize)
+	{
+		const std::string_view sample = GetSample(corpus);
+		std::string text;
+		text.reserve(maxSize + sample.size());
+		while (text.size() < maxSize)
+		{
+			text += sample;
+		}
+
+		// do not split a code point
+		size_t size = maxSize;
+		while (size > 0 && (static_cast<unsigned char>(text[size]) & 0xC0) == 0x80)
+		{
+			--size;
+		}
+		text.resize(size);
+		return text;
+	}
+
+	const std::string& GetUtf8Text(TextCorpus corpus, size_t maxSize)
+	{
+		static std::mutex mutex;
+		static std::map<std::pair<TextCorpus, size_t>, std::string> cache;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto& text = cache[{ corpus, maxSize }];
+		if (text.empty())
+		{
+			text = MakeUtf8Text(corpus, maxSize);
+		}
+		return text;
+	}
+
+	void AddTextCorpusArgs(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgNames({ "corpus", "bytes" });
+		benchmark->ArgsProduct({
+			{
+				static_cast<int64_t>(TextCorpus::Ascii),
+				static_cast<int64_t>(TextCorpus::Latin),
+				static_cast<int64_t>(TextCorpus::Cjk),
+				static_cast<int64_t>(TextCorpus::Emoji)
+			},
+			benchmark::CreateRange(16, 16 << 20, 16)
+		});
+	}
+}
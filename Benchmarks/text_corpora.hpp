@@ -0,0 +1,37 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cinttypes>
+#include <string>
+#include <string_view>
+
+namespace benchmarks
+{
+	/// <summary>
+	/// Kinds of text, which differ in how many bytes their code points take.
+	/// </summary>
+	enum class TextCorpus : int64_t
+	{
+		Ascii,
+		Latin,
+		Cjk,
+		Emoji
+	};
+
+	std::string_view GetName(TextCorpus corpus);
+
+	/// <summary>
+	/// Gets UTF-8 encoded text of a kind, made by repeating a sample.
+	/// (It is generated once, then cached.)
+	/// </summary>
+	/// <param name="corpus">The kind of text.</param>
+	/// <param name="maxSize">The size in bytes, which is reduced so as not to split a code point.</param>
+	/// <returns>The text.</returns>
+	const std::string& GetUtf8Text(TextCorpus corpus, size_t maxSize);
+
+	/// <summary>
+	/// Adds arguments to a benchmark for all kinds of text at sizes from 16 B to 16 MB.
+	/// </summary>
+	void AddTextCorpusArgs(benchmark::internal::Benchmark* benchmark);
+}
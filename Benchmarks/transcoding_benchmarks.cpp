@@ -0,0 +1,261 @@
+#include "allocation_counter.hpp"
+#include "text_corpora.hpp"
+
+#include <string>
+
+#include <MinCppXtra/win32_api_strings.hpp>
+
+#ifndef _WIN32
+#	include <MinCppXtra/internal/utf_kernels.h>
+#endif
+
+namespace benchmarks
+{
+#ifdef _WIN32
+	using Utf16String = std::wstring;
+
+	static std::string ToUtf8(const Utf16String& text)
+	{
+		return mincpp::Win32ApiStrings::ToUtf8(text.data(), text.size());
+	}
+
+	static Utf16String ToUtf16(const std::string& text)
+	{
+		return mincpp::Win32ApiStrings::ToUtf16(std::string_view(text));
+	}
+#else
+	// wide-strings are UTF-32 here, so measure the UTF-16 kernels as Win32ApiStrings calls them in Windows
+	using Utf16String = std::u16string;
+
+	static std::string ToUtf8(const Utf16String& text)
+	{
+		std::string utf8str(mincpp::CountUtf8OfUtf16(text.data(), text.size()), '\0');
+		mincpp::TranscodeUtf16ToUtf8(text.data(), text.size(), utf8str.data(), utf8str.size());
+		return utf8str;
+	}
+
+	static Utf16String ToUtf16(const std::string& text)
+	{
+		Utf16String utf16str(mincpp::CountUtf16OfUtf8(text.data(), text.size()), u'\0');
+		mincpp::TranscodeUtf8ToUtf16(text.data(), text.size(), utf16str.data(), utf16str.size());
+		return utf16str;
+	}
+#endif
+
+	static size_t FindInvalidUtf8(const std::string& text)
+	{
+		return mincpp::Win32ApiStrings::FindInvalidUtf8(text);
+	}
+
+	static std::string ReplaceInvalidUtf8(const std::string& text)
+	{
+		return mincpp::Win32ApiStrings::ReplaceInvalidUtf8(text);
+	}
+
+	static void Utf8ToUtf16(benchmark::State& state)
+	{
+		const auto corpus = static_cast<TextCorpus>(state.range(0));
+		const std::string& text = GetUtf8Text(corpus, state.range(1));
+		state.SetLabel(std::string(GetName(corpus)));
+		{
+			AllocationCounter allocationCounter(state);
+			for (auto _ : state)
+			{
+				benchmark::DoNotOptimize(ToUtf16(text));
+			}
+		}
+		state.SetBytesProcessed(state.iterations() * text.size());
+	}
+
+	BENCHMARK(Utf8ToUtf16)->Apply(AddTextCorpusArgs);
+
+	static void Utf16ToUtf8(benchmark::State& state)
+	{
+		const auto corpus = static_cast<TextCorpus>(state.range(0));
+		const std::string& utf8Text = GetUtf8Text(corpus, state.range(1));
+		const Utf16String text = ToUtf16(utf8Text);
+		state.SetLabel(std::string(GetName(corpus)));
+		{
+			AllocationCounter allocationCounter(state);
+			for (auto _ : state)
+			{
+				benchmark::DoNotOptimize(ToUtf8(text));
+			}
+		}
+
+		// (throughput is measured in UTF-8 bytes, so both directions compare)
+		state.SetBytesProcessed(state.iterations() * utf8Text.size());
+	}
+
+	BENCHMARK(Utf16ToUtf8)->Apply(AddTextCorpusArgs);
+
+	/// <summary>
+	/// Gets 1 MB of text from a corpus, which is valid, or else adversarial:
+	/// an invalid byte is planted every 16 bytes, so that fast paths keep bailing out.
+	/// </summary>
+	static std::string GetValidationText(benchmark::State& state)
+	{
+		const auto corpus = static_cast<TextCorpus>(state.range(0));
+		std::string text = GetUtf8Text(corpus, 1 << 20);
+		const bool isAdversarial = state.range(1) != 0;
+		if (isAdversarial)
+		{
+			for (size_t idx = 7; idx < text.size(); idx += 16)
+				text[idx] = static_cast<char>(0xFF);
+		}
+		state.SetLabel(std::string(GetName(corpus)) + (isAdversarial ? " adversarial" : " valid"));
+		return text;
+	}
+
+	static void Utf8Validation(benchmark::State& state)
+	{
+		const std::string text = GetValidationText(state);
+		for (auto _ : state)
+		{
+			// (the whole text is scanned when it is valid, else up to the first invalid byte)
+			benchmark::DoNotOptimize(FindInvalidUtf8(text));
+		}
+		state.SetBytesProcessed(state.iterations() * text.size());
+	}
+
+	BENCHMARK(Utf8Validation)
+		->ArgNames({ "corpus", "adversarial" })
+		->ArgsProduct({ { 0, 1, 2, 3 }, { 0 } });
+
+	static void Utf8Replacement(benchmark::State& state)
+	{
+		const std::string text = GetValidationText(state);
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ReplaceInvalidUtf8(text));
+		}
+		state.SetBytesProcessed(state.iterations() * text.size());
+	}
+
+	BENCHMARK(Utf8Replacement)
+		->ArgNames({ "corpus", "adversarial" })
+		->ArgsProduct({ { 0, 1, 2, 3 }, { 0, 1 } });
+
+#ifdef _WIN32
+	/// <summary>
+	/// Transcodes a path into a string with inline capacity, which should not allocate.
+	/// </summary>
+	static void PathToSmallWString(benchmark::State& state)
+	{
+		const std::string path = reinterpret_cast<const char*>(
+			u8"C:\\Users\\Jürgen\\AppData\\Local\\Übersicht\\Berichte\\2025-06-30.json");
+
+		mincpp::SmallWString<> utf16str;
+		{
+			AllocationCounter allocationCounter(state);
+			for (auto _ : state)
+			{
+				mincpp::Win32ApiStrings::ToUtf16(path, utf16str);
+				benchmark::DoNotOptimize(utf16str.GetData());
+			}
+		}
+		state.SetBytesProcessed(state.iterations() * path.size());
+	}
+
+	BENCHMARK(PathToSmallWString);
+#endif
+
+	// These compare the transcoding kernels of every level of acceleration on 1 MB of text:
+
+	static bool LimitAcceleration(benchmark::State& state)
+	{
+		using mincpp::Win32ApiStrings;
+		const auto acceleration = static_cast<Win32ApiStrings::Acceleration>(state.range(1));
+		Win32ApiStrings::LimitAcceleration(acceleration);
+		if (Win32ApiStrings::GetAcceleration() != acceleration)
+		{
+			state.SkipWithError("acceleration not supported");
+			return false;
+		}
+		return true;
+	}
+
+	static void Utf8ToUtf16ByAcceleration(benchmark::State& state)
+	{
+		if (LimitAcceleration(state))
+		{
+			const auto corpus = static_cast<TextCorpus>(state.range(0));
+			const std::string& text = GetUtf8Text(corpus, 1 << 20);
+			state.SetLabel(std::string(GetName(corpus)));
+			for (auto _ : state)
+			{
+				benchmark::DoNotOptimize(ToUtf16(text));
+			}
+			state.SetBytesProcessed(state.iterations() * text.size());
+		}
+		mincpp::Win32ApiStrings::LimitAcceleration(mincpp::Win32ApiStrings::Acceleration::Avx2);
+	}
+
+	BENCHMARK(Utf8ToUtf16ByAcceleration)
+		->ArgNames({ "corpus", "acceleration" })
+		->ArgsProduct({ { 0, 1, 2, 3 }, { 0, 1, 2 } });
+
+	static void Utf16ToUtf8ByAcceleration(benchmark::State& state)
+	{
+		if (LimitAcceleration(state))
+		{
+			const auto corpus = static_cast<TextCorpus>(state.range(0));
+			const std::string& utf8Text = GetUtf8Text(corpus, 1 << 20);
+			const Utf16String text = ToUtf16(utf8Text);
+			state.SetLabel(std::string(GetName(corpus)));
+			for (auto _ : state)
+			{
+				benchmark::DoNotOptimize(ToUtf8(text));
+			}
+			state.SetBytesProcessed(state.iterations() * utf8Text.size());
+		}
+		mincpp::Win32ApiStrings::LimitAcceleration(mincpp::Win32ApiStrings::Acceleration::Avx2);
+	}
+
+	BENCHMARK(Utf16ToUtf8ByAcceleration)
+		->ArgNames({ "corpus", "acceleration" })
+		->ArgsProduct({ { 0, 1, 2, 3 }, { 0, 1, 2 } });
+
+#ifdef _WIN32
+	// These show how transcoding 64 MB of text scales with the count of threads:
+
+	static void Utf8ToUtf16Parallel(benchmark::State& state)
+	{
+		const auto corpus = static_cast<TextCorpus>(state.range(0));
+		const std::string& text = GetUtf8Text(corpus, 64 << 20);
+		mincpp::TranscodingParallelism parallelism;
+		parallelism.threadCount = static_cast<unsigned int>(state.range(1));
+		state.SetLabel(std::string(GetName(corpus)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(mincpp::Win32ApiStrings::ToUtf16Parallel(text, parallelism));
+		}
+		state.SetBytesProcessed(state.iterations() * text.size());
+	}
+
+	BENCHMARK(Utf8ToUtf16Parallel)
+		->ArgNames({ "corpus", "threads" })
+		->ArgsProduct({ { 0, 2 }, { 1, 2, 4, 8, 16 } })
+		->UseRealTime();
+
+	static void Utf16ToUtf8Parallel(benchmark::State& state)
+	{
+		const auto corpus = static_cast<TextCorpus>(state.range(0));
+		const std::string& utf8Text = GetUtf8Text(corpus, 64 << 20);
+		const Utf16String text = ToUtf16(utf8Text);
+		mincpp::TranscodingParallelism parallelism;
+		parallelism.threadCount = static_cast<unsigned int>(state.range(1));
+		state.SetLabel(std::string(GetName(corpus)));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(mincpp::Win32ApiStrings::ToUtf8Parallel(text, parallelism));
+		}
+		state.SetBytesProcessed(state.iterations() * utf8Text.size());
+	}
+
+	BENCHMARK(Utf16ToUtf8Parallel)
+		->ArgNames({ "corpus", "threads" })
+		->ArgsProduct({ { 0, 2 }, { 1, 2, 4, 8, 16 } })
+		->UseRealTime();
+#endif
+}
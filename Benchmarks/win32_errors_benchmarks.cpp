@@ -0,0 +1,29 @@
+#ifdef _WIN32
+
+#include "allocation_counter.hpp"
+
+#include <MinCppXtra/win32_errors.hpp>
+
+#include <windows.h>
+
+namespace benchmarks
+{
+	static void Win32ErrorsGetErrorMessage(benchmark::State& state)
+	{
+		const auto errCode = static_cast<uint32_t>(state.range(0));
+		AllocationCounter allocationCounter(state);
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(
+				mincpp::Win32Errors::GetErrorMessage(errCode, "CreateFileW"));
+		}
+	}
+
+	BENCHMARK(Win32ErrorsGetErrorMessage)
+		->ArgName("error")
+		->Arg(ERROR_FILE_NOT_FOUND)
+		->Arg(ERROR_ACCESS_DENIED)
+		->Arg(0xDEADBEEF); // unknown code
+}
+
+#endif // _WIN32
@@ -0,0 +1,51 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "breadcrumbs.hpp"
+
+#include <algorithm>
+
+namespace mincpp
+{
+    static_assert((Breadcrumbs::Capacity & (Breadcrumbs::Capacity - 1)) == 0,
+                  "capacity must be a power of 2");
+
+    static thread_local Breadcrumb t_breadcrumbs[Breadcrumbs::Capacity];
+    static thread_local uint32_t t_breadcrumbCount;
+
+    void Breadcrumbs::Drop(const char* label, int64_t value) noexcept
+    {
+        Breadcrumb& breadcrumb = t_breadcrumbs[t_breadcrumbCount++ & (Capacity - 1)];
+        breadcrumb.label = label;
+        breadcrumb.value = value;
+    }
+
+    uint32_t Breadcrumbs::CopyRecent(std::span<Breadcrumb> destination) noexcept
+    {
+        const uint32_t count = static_cast<uint32_t>(std::min<size_t>(
+            destination.size(), std::min(t_breadcrumbCount, Capacity)));
+
+        const uint32_t first = t_breadcrumbCount - count;
+        for (uint32_t idx = 0; idx < count; ++idx)
+        {
+            destination[idx] = t_breadcrumbs[(first + idx) & (Capacity - 1)];
+        }
+        return count;
+    }
+
+    void Breadcrumbs::Clear() noexcept
+    {
+        t_breadcrumbCount = 0;
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace mincpp
+{
+	/// <summary>
+	/// A mark left by a thread about what it was doing.
+	/// </summary>
+	struct Breadcrumb
+	{
+		/// <summary>
+		/// A label with static storage duration (such as a string literal).
+		/// </summary>
+		const char* label;
+
+		int64_t value;
+	};
+
+	/// <summary>
+	/// Keeps the most recent breadcrumbs of each thread in a fixed ring buffer,
+	/// so that leaving them costs neither locks nor allocations. They provide
+	/// context for exceptions without paying for logging on the success path.
+	/// </summary>
+	class Breadcrumbs
+	{
+	public:
+
+		/// <summary>
+		/// How many breadcrumbs are kept per thread.
+		/// </summary>
+		static constexpr uint32_t Capacity = 32;
+
+		/// <summary>
+		/// Leaves a breadcrumb in the current thread. Use MINCPP_BREADCRUMB instead.
+		/// </summary>
+		/// <param name="label">A label with static storage duration.</param>
+		/// <param name="value">A value that goes along with the label.</param>
+		static void Drop(const char* label, int64_t value) noexcept;
+
+		/// <summary>
+		/// Copies the most recent breadcrumbs left by the current thread.
+		/// </summary>
+		/// <param name="destination">Where to copy the breadcrumbs to, oldest first.</param>
+		/// <returns>How many breadcrumbs were copied.</returns>
+		static uint32_t CopyRecent(std::span<Breadcrumb> destination) noexcept;
+
+		/// <summary>
+		/// Forgets the breadcrumbs left by the current thread.
+		/// </summary>
+		static void Clear() noexcept;
+	};
+}
+
+/// <summary>
+/// Leaves a breadcrumb in the current thread. The label must be a string literal.
+/// </summary>
+#define MINCPP_BREADCRUMB(label, value) \
+	::mincpp::Breadcrumbs::Drop("" label, static_cast<int64_t>(value))
@@ -12,6 +12,7 @@
  */
 
 #include "internal/pch.h"
+#include "internal/stage_timer.h"
 
 #include "call_stack.hpp"
 #include "console.hpp"
@@ -19,16 +20,23 @@
 #include "win32_api_strings.hpp"
 #include "win32_errors.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cinttypes>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
 #include <mutex>
 #include <regex>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <comdef.h>
 #include <DbgHelp.h>
+#include <TlHelp32.h>
 
 namespace mincpp
 {
@@ -66,7 +74,9 @@ namespace mincpp
         static std::mutex symbolAccessMutex;
         {
             // lock access to stack walking because the API is not thread-safe
+            StageTimer timer;
             std::lock_guard<std::mutex> lock(symbolAccessMutex);
+            timer.Lap(TraceMetric::LockWaitNanoseconds);
 
             STACKFRAME frame;
             InitializeStackFrame64(frame, context);
@@ -84,10 +94,26 @@ namespace mincpp
         std::string function;
         std::string fileName;
         uint32_t lineNumber;
+        uint32_t repeatingFrameCount = 0;
+        uint32_t repetitionCount = 0;
     };
 
-    static ResolvedFrame Resolve(const STACKFRAME& frame)
+    static bool IsRecursionMark(uint64_t address)
     {
+        return (address & RawStackTrace::RecursionMark) == RawStackTrace::RecursionMark;
+    }
+
+    static ResolvedFrame Resolve(DWORD64 address)
+    {
+        if (IsRecursionMark(address))
+        {
+            ResolvedFrame result;
+            result.status = ERROR_SUCCESS;
+            result.repeatingFrameCount = static_cast<uint16_t>(address >> 32);
+            result.repetitionCount = static_cast<uint32_t>(address);
+            return result;
+        }
+
         char buffer[sizeof(SYMBOL_INFOW) + MAX_SYM_NAME * sizeof(wchar_t)]{};
         SYMBOL_INFOW* symbol = reinterpret_cast<SYMBOL_INFOW*>(buffer);
         symbol->SizeOfStruct = sizeof * symbol;
@@ -95,7 +121,7 @@ namespace mincpp
 
         DWORD64 d64;
         ResolvedFrame result;
-        if (NOT_OK(SymFromAddrW(GetThisProcessHandle(), frame.AddrPC.Offset, &d64, symbol)))
+        if (NOT_OK(SymFromAddrW(GetThisProcessHandle(), address, &d64, symbol)))
         {
             result.status = GetLastError();
             return result;
@@ -107,7 +133,7 @@ namespace mincpp
         DWORD d32;
         IMAGEHLP_LINEW64 line{};
         line.SizeOfStruct = sizeof line;
-        if (OK(SymGetLineFromAddrW64(GetThisProcessHandle(), frame.AddrPC.Offset, &d32, &line)))
+        if (OK(SymGetLineFromAddrW64(GetThisProcessHandle(), address, &d32, &line)))
         {
             result.fileName = Win32ApiStrings::ToUtf8(line.FileName);
             result.lineNumber = line.LineNumber;
@@ -121,9 +147,17 @@ namespace mincpp
         static const auto topIrrelevantSymbols =
             std::to_array<const char*>(
             {
-                NAMEOF(mincpp::CallStack::GetTrace),
+                NAMEOF(mincpp::CallStack::),
                 NAMEOF(mincpp::TraceableException::),
+                NAMEOF(mincpp::ThrowTracingScope::),
+                NAMEOF(mincpp::ExceptionJournalScope::),
                 "_CxxFrameHandler",
+                "_CxxThrowException",
+                "RaiseException",
+                "RtlRaiseException",
+                "RtlDispatchException",
+                "RtlpCallVectoredHandlers",
+                "KiUserExceptionDispatcher",
                 "RtlCaptureContext",
             });
 
@@ -180,11 +214,16 @@ namespace mincpp
         return std::vector<ResolvedFrame>(iterBegin, iterEnd);
     }
 
-    static std::string SerializeStackTrace(
-        const std::vector<ResolvedFrame>& frames, bool isConsole)
+    template <typename Allocator>
+    using TraceString = std::basic_string<char, std::char_traits<char>, Allocator>;
+
+    // serializes the frames into a string from the given allocator
+    template <typename Allocator>
+    static TraceString<Allocator> SerializeStackTrace(
+        const std::vector<ResolvedFrame>& frames, bool isConsole, const Allocator& allocator)
     {
         std::regex mangledLambdaRegEx("lambda_\\w+");
-        std::ostringstream oss;
+        std::basic_ostringstream<char, std::char_traits<char>, Allocator> oss(std::ios_base::out, allocator);
 
         int idx = 0;
         uint32_t prevStatus = ERROR_SUCCESS;
@@ -197,6 +236,15 @@ namespace mincpp
                 continue;
             }
 
+            if (frame.repetitionCount != 0)
+            {
+                oss << Console::Color(isConsole).BrightBlack()
+                    << "(previous " << std::dec << frame.repeatingFrameCount
+                    << " frame(s) repeated " << frame.repetitionCount << " more time(s))"
+                    << Console::Color(isConsole).Reset() << std::endl;
+                continue;
+            }
+
             oss << '#' << std::dec << idx++ << ' ';
 
             switch (frame.status)
@@ -233,13 +281,37 @@ namespace mincpp
             prevStatus = frame.status;
         }
 
-        return std::regex_replace(oss.str(), mangledLambdaRegEx, "lambda");
+        const TraceString<Allocator> serialized = std::move(oss).str();
+        TraceString<Allocator> trace(allocator);
+        std::regex_replace(
+            std::back_inserter(trace), serialized.begin(), serialized.end(), mangledLambdaRegEx, "lambda");
+        return trace;
     }
 
-    std::string CallStack::GetTrace(const void* currentContextHandle, bool isConsole)
+    // filters and serializes the resolved frames, measuring it
+    template <typename Allocator>
+    static TraceString<Allocator> Render(const std::vector<ResolvedFrame>& resolvedFrames,
+                                         bool isConsole,
+                                         StageTimer& timer,
+                                         const Allocator& allocator)
     {
+        const auto filteredFrames = FilterFrames(resolvedFrames);
+        TraceString<Allocator> trace = SerializeStackTrace(filteredFrames, isConsole, allocator);
+        timer.Lap(TraceMetric::RenderNanoseconds);
+        timer.Count(TraceMetric::BytesRendered, trace.size());
+        return trace;
+    }
+
+    template <typename Allocator>
+    static TraceString<Allocator> TraceFromContext(
+        const CONTEXT* context, bool isConsole, const Allocator& allocator)
+    {
+        StageTimer timer;
         std::vector<STACKFRAME> allStackFrames =
-            BackTraceStackFrames(static_cast<const CONTEXT*>(currentContextHandle));
+            BackTraceStackFrames(context);
+
+        timer.Lap(TraceMetric::CaptureNanoseconds);
+        timer.Count(TraceMetric::FramesWalked, allStackFrames.size());
 
         std::vector<ResolvedFrame> resolvedFrames;
         resolvedFrames.reserve(allStackFrames.size());
@@ -250,11 +322,493 @@ namespace mincpp
             std::back_inserter(resolvedFrames),
             [isConsole](const STACKFRAME& frame)
             {
-                return Resolve(frame);
+                return Resolve(frame.AddrPC.Offset);
             });
 
-        const auto filteredFrames = FilterFrames(resolvedFrames);
-        return SerializeStackTrace(filteredFrames, isConsole);
+        timer.Lap(TraceMetric::ResolveNanoseconds);
+        timer.Count(TraceMetric::FramesResolved, resolvedFrames.size());
+        return Render(resolvedFrames, isConsole, timer, allocator);
+    }
+
+    std::string CallStack::GetTrace(const void* currentContextHandle, bool isConsole)
+    {
+        return TraceFromContext(
+            static_cast<const CONTEXT*>(currentContextHandle), isConsole, std::allocator<char>());
+    }
+
+    std::pmr::string CallStack::GetTrace(
+        const void* currentContextHandle, std::pmr::memory_resource* resource, bool isConsole)
+    {
+        return TraceFromContext(
+            static_cast<const CONTEXT*>(currentContextHandle),
+            isConsole,
+            std::pmr::polymorphic_allocator<char>(resource));
+    }
+
+    template <typename Allocator>
+    static TraceString<Allocator> TraceFromRaw(
+        const RawStackTrace& rawTrace, bool isConsole, const Allocator& allocator)
+    {
+        StageTimer timer;
+        std::vector<ResolvedFrame> resolvedFrames;
+        resolvedFrames.reserve(rawTrace.frameCount);
+
+        std::transform(
+            rawTrace.addresses.cbegin(),
+            rawTrace.addresses.cbegin() + rawTrace.frameCount,
+            std::back_inserter(resolvedFrames),
+            &Resolve);
+
+        timer.Lap(TraceMetric::ResolveNanoseconds);
+        timer.Count(TraceMetric::FramesResolved, resolvedFrames.size());
+        return Render(resolvedFrames, isConsole, timer, allocator);
+    }
+
+    std::string CallStack::GetTrace(const RawStackTrace& rawTrace, bool isConsole)
+    {
+        return TraceFromRaw(rawTrace, isConsole, std::allocator<char>());
+    }
+
+    std::pmr::string CallStack::GetTrace(
+        const RawStackTrace& rawTrace, std::pmr::memory_resource* resource, bool isConsole)
+    {
+        return TraceFromRaw(rawTrace, isConsole, std::pmr::polymorphic_allocator<char>(resource));
+    }
+
+    void CallStack::Capture(RawStackTrace& rawTrace, uint32_t framesToSkip) noexcept
+    {
+        static_assert(sizeof(PVOID) == sizeof(rawTrace.addresses[0]));
+        StageTimer timer;
+        rawTrace.frameCount =
+            RtlCaptureStackBackTrace(
+                framesToSkip + 1,
+                static_cast<DWORD>(rawTrace.addresses.size()),
+                reinterpret_cast<PVOID*>(rawTrace.addresses.data()),
+                nullptr);
+
+        timer.Lap(TraceMetric::CaptureNanoseconds);
+        timer.Count(TraceMetric::FramesWalked, rawTrace.frameCount);
+    }
+
+    /// <summary>
+    /// Appends addresses to a raw trace, collapsing consecutive
+    /// repetitions of the same sequence of frames into a mark.
+    /// </summary>
+    class RecursionCompressor
+    {
+    private:
+
+        static constexpr uint16_t MAX_CYCLE_LENGTH = 8;
+
+        RawStackTrace& m_rawTrace;
+        uint16_t m_markIdx;
+        uint16_t m_cycleLength;
+        uint16_t m_cyclePos;
+        uint32_t m_repetitionCount;
+
+        bool RepeatsPrevious(uint16_t cycleLength) const
+        {
+            const uint16_t count = m_rawTrace.frameCount;
+            if (count < 2 * cycleLength)
+            {
+                return false;
+            }
+
+            for (uint16_t idx = count - cycleLength; idx < count; ++idx)
+            {
+                const uint64_t address = m_rawTrace.addresses[idx];
+                if (address != m_rawTrace.addresses[idx - cycleLength]
+                    || IsRecursionMark(address))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void UpdateMark()
+        {
+            m_rawTrace.addresses[m_markIdx] = RawStackTrace::RecursionMark
+                | (static_cast<uint64_t>(m_cycleLength) << 32)
+                | m_repetitionCount;
+        }
+
+    public:
+
+        RecursionCompressor(RawStackTrace& rawTrace)
+            : m_rawTrace(rawTrace)
+            , m_markIdx(0)
+            , m_cycleLength(0)
+            , m_cyclePos(0)
+            , m_repetitionCount(0)
+        {
+            m_rawTrace.frameCount = 0;
+        }
+
+        /// <returns>Whether there is room for more frames.</returns>
+        bool Append(uint64_t address)
+        {
+            auto& addresses = m_rawTrace.addresses;
+
+            if (m_cycleLength != 0)
+            {
+                // still repeating?
+                if (address == addresses[m_markIdx - m_cycleLength + m_cyclePos])
+                {
+                    if (++m_cyclePos == m_cycleLength)
+                    {
+                        m_cyclePos = 0;
+                        ++m_repetitionCount;
+                        UpdateMark();
+                    }
+                    return true;
+                }
+
+                // recursion is over: restore what matched a partial cycle
+                for (uint16_t idx = 0; idx < m_cyclePos; ++idx)
+                {
+                    if (m_rawTrace.frameCount == addresses.size())
+                    {
+                        return false;
+                    }
+                    addresses[m_rawTrace.frameCount++] = addresses[m_markIdx - m_cycleLength + idx];
+                }
+                m_cycleLength = 0;
+            }
+
+            if (m_rawTrace.frameCount == addresses.size())
+            {
+                return false;
+            }
+            addresses[m_rawTrace.frameCount++] = address;
+
+            for (uint16_t cycleLength = 1; cycleLength <= MAX_CYCLE_LENGTH; ++cycleLength)
+            {
+                if (RepeatsPrevious(cycleLength))
+                {
+                    // replace the repetition by a mark
+                    m_rawTrace.frameCount -= cycleLength;
+                    m_markIdx = m_rawTrace.frameCount++;
+                    m_cycleLength = cycleLength;
+                    m_cyclePos = 0;
+                    m_repetitionCount = 1;
+                    UpdateMark();
+                    break;
+                }
+            }
+
+            return m_rawTrace.frameCount < addresses.size() || m_cycleLength != 0;
+        }
+    };
+
+    /// <summary>
+    /// Walks the call stack from a context, reading no stack memory beyond the given end.
+    /// </summary>
+    /// <param name="rebase">
+    /// Adjusts the registers that point into the stack, when it is read from a copy.
+    /// </param>
+    template <typename RebaseRegisters>
+    static void WalkStack(
+        CONTEXT context,
+        DWORD64 stackEnd,
+        RawStackTrace& rawTrace,
+        const RebaseRegisters& rebase) noexcept
+    {
+        StageTimer timer;
+        RecursionCompressor compressor(rawTrace);
+        rebase(context);
+
+        while (context.Rip != 0
+            && context.Rsp != 0
+            && context.Rsp <= stackEnd - sizeof(DWORD64)
+            && compressor.Append(context.Rip))
+        {
+            const DWORD64 prevStackPointer = context.Rsp;
+
+            DWORD64 imageBase;
+            PRUNTIME_FUNCTION function =
+                RtlLookupFunctionEntry(context.Rip, &imageBase, nullptr);
+
+            if (function == nullptr)
+            {
+                // not even in a loaded image? (then the stack cannot be trusted any longer)
+                PVOID moduleBase;
+                if (RtlPcToFileHeader(reinterpret_cast<PVOID>(context.Rip), &moduleBase) == nullptr)
+                {
+                    break;
+                }
+
+                // leaf function: the return address is on top of the stack
+                context.Rip = *reinterpret_cast<const DWORD64*>(context.Rsp);
+                context.Rsp += sizeof(DWORD64);
+                continue;
+            }
+
+            PVOID handlerData;
+            DWORD64 establisherFrame;
+            RtlVirtualUnwind(
+                UNW_FLAG_NHANDLER,
+                imageBase,
+                context.Rip,
+                function,
+                &context,
+                &handlerData,
+                &establisherFrame,
+                nullptr);
+
+            // registers restored from the stack might point into it
+            rebase(context);
+
+            if (context.Rsp <= prevStackPointer)
+            {
+                break;
+            }
+        }
+
+        timer.Lap(TraceMetric::CaptureNanoseconds);
+        timer.Count(TraceMetric::FramesWalked, rawTrace.frameCount);
+    }
+
+    void CallStack::Capture(const void* contextHandle, RawStackTrace& rawTrace) noexcept
+    {
+        WalkStack(
+            *static_cast<const CONTEXT*>(contextHandle),
+            std::numeric_limits<DWORD64>::max(),
+            rawTrace,
+            [](CONTEXT&) {});
+    }
+
+    // how much of the top of the stack of a suspended thread is copied, to be walked after resuming it,
+    // plus some room beyond, because unwinding the last frame in the copy might read past its end
+    static constexpr size_t STACK_COPY_SIZE = 128 * 1024;
+    static constexpr size_t STACK_COPY_SLACK = 16 * 1024;
+
+    /// <summary>
+    /// Walks the call stack of a thread from a copy of the top of its stack.
+    /// </summary>
+    static void WalkStackCopy(
+        const CONTEXT& context,
+        const std::vector<std::byte>& stackCopy,
+        size_t copiedSize,
+        RawStackTrace& rawTrace) noexcept
+    {
+        // without a copy, only the current frame is known
+        if (copiedSize == 0)
+        {
+            rawTrace.addresses[0] = context.Rip;
+            rawTrace.frameCount = 1;
+            return;
+        }
+
+        const DWORD64 stackTop = context.Rsp;
+        const auto copyTop = reinterpret_cast<DWORD64>(stackCopy.data());
+
+        // (the copy is somewhere else in memory, so no address is in both)
+        const auto rebase = [stackTop, copyTop, copiedSize](CONTEXT& registers)
+        {
+            for (DWORD64* reg : { &registers.Rsp, &registers.Rbp, &registers.Rbx, &registers.Rsi, &registers.Rdi,
+                                  &registers.R12, &registers.R13, &registers.R14, &registers.R15 })
+            {
+                if (*reg >= stackTop && *reg - stackTop < copiedSize)
+                {
+                    *reg = *reg - stackTop + copyTop;
+                }
+            }
+        };
+
+        WalkStack(context, copyTop + copiedSize, rawTrace, rebase);
+    }
+
+    static std::vector<DWORD> ListOtherThreadsInProcess()
+    {
+        std::vector<DWORD> threadIds;
+
+        HANDLE snapshotHandle = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (snapshotHandle == INVALID_HANDLE_VALUE)
+        {
+            throw TraceableException(
+                Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(CreateToolhelp32Snapshot)));
+        }
+
+        const DWORD processId = GetCurrentProcessId();
+        const DWORD currentThreadId = GetCurrentThreadId();
+
+        THREADENTRY32 entry{};
+        entry.dwSize = sizeof entry;
+        for (BOOL found = Thread32First(snapshotHandle, &entry);
+            found == TRUE;
+            found = Thread32Next(snapshotHandle, &entry))
+        {
+            if (entry.th32OwnerProcessID == processId
+                && entry.th32ThreadID != currentThreadId)
+            {
+                threadIds.push_back(entry.th32ThreadID);
+            }
+        }
+
+        CloseHandle(snapshotHandle);
+        return threadIds;
+    }
+
+    static bool CaptureSuspendedThread(
+        HANDLE threadHandle,
+        std::vector<std::byte>& stackCopy,
+        RawStackTrace& rawTrace,
+        std::chrono::nanoseconds& pause)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        if (SuspendThread(threadHandle) == static_cast<DWORD>(-1))
+        {
+            return false;
+        }
+
+        // only copy the registers and the top of the stack while the thread is paused:
+        // the copy is allocated in advance, and walking the stack takes the locks of the
+        // loader and function tables, which the suspended thread might hold
+        CONTEXT context;
+        context.ContextFlags = CONTEXT_FULL;
+        size_t copiedSize = 0;
+        const bool success = OK(GetThreadContext(threadHandle, &context));
+        if (success)
+        {
+            // the stack is committed from the top down to its base
+            MEMORY_BASIC_INFORMATION memoryInfo;
+            if (VirtualQuery(reinterpret_cast<LPCVOID>(context.Rsp), &memoryInfo, sizeof memoryInfo) != 0)
+            {
+                const DWORD64 regionEnd =
+                    reinterpret_cast<DWORD64>(memoryInfo.BaseAddress) + memoryInfo.RegionSize;
+
+                copiedSize = static_cast<size_t>(std::min<DWORD64>(regionEnd - context.Rsp, STACK_COPY_SIZE));
+                memcpy(stackCopy.data(), reinterpret_cast<const void*>(context.Rsp), copiedSize);
+            }
+        }
+
+        ResumeThread(threadHandle);
+        pause = std::chrono::steady_clock::now() - startTime;
+
+        if (success)
+        {
+            WalkStackCopy(context, stackCopy, copiedSize, rawTrace);
+        }
+        return success;
+    }
+
+    static HANDLE OpenThreadForCapture(DWORD threadId)
+    {
+        return OpenThread(
+            THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_QUERY_INFORMATION,
+            FALSE,
+            threadId);
+    }
+
+    bool CallStack::CaptureThread(uint32_t threadId, RawStackTrace& rawTrace)
+    {
+        HANDLE threadHandle = OpenThreadForCapture(threadId);
+        if (threadHandle == nullptr)
+        {
+            return false;
+        }
+
+        std::vector<std::byte> stackCopy(STACK_COPY_SIZE + STACK_COPY_SLACK);
+        std::chrono::nanoseconds pause;
+        const bool success = CaptureSuspendedThread(threadHandle, stackCopy, rawTrace, pause);
+        CloseHandle(threadHandle);
+        return success;
+    }
+
+    ThreadsSnapshot CallStack::CaptureAllThreads(std::chrono::milliseconds timeBudget)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        const std::vector<DWORD> threadIds = ListOtherThreadsInProcess();
+
+        ThreadsSnapshot snapshot{};
+        snapshot.threads.reserve(threadIds.size() + 1);
+        snapshot.isComplete = true;
+
+        std::vector<std::byte> stackCopy(STACK_COPY_SIZE + STACK_COPY_SLACK);
+
+        auto& currentThread = snapshot.threads.emplace_back();
+        currentThread.threadId = GetCurrentThreadId();
+        Capture(currentThread.rawTrace);
+
+        for (DWORD threadId : threadIds)
+        {
+            if (std::chrono::steady_clock::now() - startTime > timeBudget)
+            {
+                snapshot.isComplete = false;
+                break;
+            }
+
+            HANDLE threadHandle = OpenThreadForCapture(threadId);
+            if (threadHandle == nullptr)
+            {
+                continue; // it has exited meanwhile
+            }
+
+            ThreadsSnapshot::Thread thread;
+            thread.threadId = threadId;
+            std::chrono::nanoseconds pause;
+            if (CaptureSuspendedThread(threadHandle, stackCopy, thread.rawTrace, pause))
+            {
+                snapshot.threads.push_back(thread);
+                snapshot.longestPause = std::max(snapshot.longestPause, pause);
+            }
+
+            CloseHandle(threadHandle);
+        }
+
+        snapshot.totalDuration = std::chrono::steady_clock::now() - startTime;
+        return snapshot;
+    }
+
+    std::string CallStack::GetTrace(const ThreadsSnapshot& snapshot, bool isConsole)
+    {
+        // threads often share frames, so resolve each address once
+        StageTimer timer;
+        std::unordered_map<uint64_t, ResolvedFrame> resolvedFrameByAddress;
+        for (const auto& thread : snapshot.threads)
+        {
+            for (uint16_t idx = 0; idx < thread.rawTrace.frameCount; ++idx)
+            {
+                const uint64_t address = thread.rawTrace.addresses[idx];
+                if (!resolvedFrameByAddress.contains(address))
+                {
+                    resolvedFrameByAddress.emplace(address, Resolve(address));
+                }
+            }
+        }
+
+        timer.Lap(TraceMetric::ResolveNanoseconds);
+        timer.Count(TraceMetric::FramesResolved, resolvedFrameByAddress.size());
+
+        std::ostringstream oss;
+        for (const auto& thread : snapshot.threads)
+        {
+            std::vector<ResolvedFrame> resolvedFrames;
+            resolvedFrames.reserve(thread.rawTrace.frameCount);
+
+            std::transform(
+                thread.rawTrace.addresses.cbegin(),
+                thread.rawTrace.addresses.cbegin() + thread.rawTrace.frameCount,
+                std::back_inserter(resolvedFrames),
+                [&resolvedFrameByAddress](uint64_t address)
+                {
+                    return resolvedFrameByAddress.at(address);
+                });
+
+            oss << "=== THREAD " << std::dec << thread.threadId << " ===" << std::endl
+                << SerializeStackTrace(FilterFrames(resolvedFrames), isConsole, std::allocator<char>());
+        }
+
+        if (!snapshot.isComplete)
+        {
+            oss << "(some threads were not captured within the time budget)" << std::endl;
+        }
+
+        std::string trace = oss.str();
+        timer.Lap(TraceMetric::RenderNanoseconds);
+        timer.Count(TraceMetric::BytesRendered, trace.size());
+        return trace;
     }
 
     std::string CallStack::GetTrace(bool isConsole)
@@ -263,4 +817,11 @@ namespace mincpp
         RtlCaptureContext(&currentContext);
         return GetTrace(&currentContext, isConsole);
     }
+
+    std::pmr::string CallStack::GetTrace(std::pmr::memory_resource* resource, bool isConsole)
+    {
+        CONTEXT currentContext;
+        RtlCaptureContext(&currentContext);
+        return GetTrace(&currentContext, resource, isConsole);
+    }
 }
\ No newline at end of file
@@ -13,10 +13,63 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 namespace mincpp
 {
+	/// <summary>
+	/// Holds the addresses of the frames in a call stack,
+	/// which have not been resolved to symbols yet.
+	/// </summary>
+	struct RawStackTrace
+	{
+		static constexpr size_t MaxFrameCount = 62;
+
+		/// <summary>
+		/// Marks an entry that holds no address, but tells that the preceding frames repeat
+		/// (due to recursion). Bits 32-47 have the count of repeating frames and bits 0-31
+		/// have how many more times they repeat. (No user-mode address has these bits set.)
+		/// </summary>
+		static constexpr uint64_t RecursionMark = 0xFFFF'0000'0000'0000ULL;
+
+		std::array<uint64_t, MaxFrameCount> addresses;
+		uint16_t frameCount;
+	};
+
+	/// <summary>
+	/// Holds the raw call stacks of all threads in the process.
+	/// </summary>
+	struct ThreadsSnapshot
+	{
+		struct Thread
+		{
+			uint32_t threadId;
+			RawStackTrace rawTrace;
+		};
+
+		std::vector<Thread> threads;
+
+		/// <summary>
+		/// Whether all threads have been captured within the time budget.
+		/// </summary>
+		bool isComplete;
+
+		/// <summary>
+		/// The longest time a single thread was kept suspended.
+		/// </summary>
+		std::chrono::nanoseconds longestPause;
+
+		/// <summary>
+		/// The time taken to capture all threads.
+		/// </summary>
+		std::chrono::nanoseconds totalDuration;
+	};
+
 	/// <summary>
 	/// Provides call stack information.
 	/// </summary>
@@ -39,5 +92,96 @@ namespace mincpp
 		/// <returns>The current call stack trace, UTF-8 encoded.</returns>
 		static std::string GetTrace(
 			const void* currentContextHandle, bool isConsole = false);
+
+		/// <summary>
+		/// Creates a trace of the current stack into memory from the given resource.
+		/// </summary>
+		/// <param name="resource">The memory resource for the returned string.</param>
+		/// <param name="isConsole"> Whether the text should be visual appealing for the console.</param>
+		/// <returns>The current call stack trace, UTF-8 encoded.</returns>
+		static std::pmr::string GetTrace(
+			std::pmr::memory_resource* resource, bool isConsole = false);
+
+		/// <summary>
+		/// Creates the stack trace from the given context into memory from the given resource.
+		/// </summary>
+		/// <param name="currentContextHandle">The system handle for the current context.</param>
+		/// <param name="resource">The memory resource for the returned string.</param>
+		/// <param name="isConsole"> Whether the text should be visual appealing for the console.</param>
+		/// <returns>The current call stack trace, UTF-8 encoded.</returns>
+		static std::pmr::string GetTrace(
+			const void* currentContextHandle, std::pmr::memory_resource* resource, bool isConsole = false);
+
+		/// <summary>
+		/// Creates the stack trace from previously captured frame addresses.
+		/// </summary>
+		/// <param name="rawTrace">The captured addresses.</param>
+		/// <param name="isConsole"> Whether the text should be visual appealing for the console.</param>
+		/// <returns>The call stack trace, UTF-8 encoded.</returns>
+		static std::string GetTrace(
+			const RawStackTrace& rawTrace, bool isConsole = false);
+
+		/// <summary>
+		/// Creates the stack trace from previously captured frame addresses into memory from the given resource.
+		/// </summary>
+		/// <param name="rawTrace">The captured addresses.</param>
+		/// <param name="resource">The memory resource for the returned string.</param>
+		/// <param name="isConsole"> Whether the text should be visual appealing for the console.</param>
+		/// <returns>The call stack trace, UTF-8 encoded.</returns>
+		static std::pmr::string GetTrace(
+			const RawStackTrace& rawTrace, std::pmr::memory_resource* resource, bool isConsole = false);
+
+		/// <summary>
+		/// Captures the addresses of the frames in the current stack, without resolving symbols.
+		/// It neither takes locks nor allocates memory, hence it is cheap enough for hot paths.
+		/// </summary>
+		/// <param name="rawTrace">Receives the captured addresses.</param>
+		/// <param name="framesToSkip">How many frames to skip on top of the caller.</param>
+		static void Capture(RawStackTrace& rawTrace, uint32_t framesToSkip = 0) noexcept;
+
+		/// <summary>
+		/// Captures the addresses of the frames in the stack of the given context,
+		/// starting at its instruction pointer, without resolving symbols.
+		/// Unwinding only uses the unwind data of the loaded images, so it neither
+		/// takes the symbol lock nor allocates memory. Recursion is compressed
+		/// (see RawStackTrace::RecursionMark), so the whole stack fits even upon overflow.
+		/// </summary>
+		/// <param name="contextHandle">The system handle for the context, such as of a fault.</param>
+		/// <param name="rawTrace">Receives the captured addresses.</param>
+		static void Capture(const void* contextHandle, RawStackTrace& rawTrace) noexcept;
+
+		/// <summary>
+		/// Captures the addresses of the frames in the stack of another thread, which is
+		/// suspended only while its registers and the top of its stack are copied.
+		/// (Nothing is allocated or locked meanwhile: the copy is walked after resuming it.
+		/// Frames beyond the copied top of the stack are left out.)
+		/// </summary>
+		/// <param name="threadId">The ID of a thread in this process.</param>
+		/// <param name="rawTrace">Receives the captured addresses.</param>
+		/// <returns>Whether the stack could be captured.</returns>
+		static bool CaptureThread(uint32_t threadId, RawStackTrace& rawTrace);
+
+		/// <summary>
+		/// Captures the addresses of the frames in the stacks of all threads in the process.
+		/// Each thread is suspended only while its registers and the top of its stack are
+		/// copied, and nothing gets allocated or locked meanwhile, so that a thread holding
+		/// the lock of the heap or of the loader cannot block this.
+		/// </summary>
+		/// <param name="timeBudget">
+		/// After this time has passed, no more threads are captured.
+		/// </param>
+		/// <returns>A snapshot of the stacks and how long they took to capture.</returns>
+		static ThreadsSnapshot CaptureAllThreads(
+			std::chrono::milliseconds timeBudget = std::chrono::milliseconds(100));
+
+		/// <summary>
+		/// Creates the stack traces of all threads in a snapshot.
+		/// Each distinct address is resolved only once.
+		/// </summary>
+		/// <param name="snapshot">The captured stacks.</param>
+		/// <param name="isConsole"> Whether the text should be visual appealing for the console.</param>
+		/// <returns>The call stack trace of every thread, UTF-8 encoded.</returns>
+		static std::string GetTrace(
+			const ThreadsSnapshot& snapshot, bool isConsole = false);
 	};
 }
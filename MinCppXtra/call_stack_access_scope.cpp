@@ -18,6 +18,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <DbgHelp.h>
 
 namespace mincpp
@@ -54,12 +55,29 @@ namespace mincpp
         return handle;
     }
 
-	class CallStackAccessScope::Impl
-	{
+    // guards creation and destruction of symbol sessions, since loading symbols is not thread-safe
+    static std::mutex symbolSessionMutex;
+
+    /// <summary>
+    /// Keeps the symbols of the process loaded: they are loaded along with the first session,
+    /// and unloaded along with the last one. (Only create and destroy it under symbolSessionMutex.)
+    /// </summary>
+    class SymbolSession
+    {
+    private:
+
+        // counted apart from shared pointers, whose count drops before their deleter takes the lock
+        static uint32_t s_sessionCount;
+
     public:
 
-        Impl()
+        SymbolSession()
         {
+            if (s_sessionCount++ != 0)
+            {
+                return;
+            }
+
             SymSetOptions(
                 SymGetOptions()
                     | SYMOPT_UNDNAME
@@ -72,13 +90,62 @@ namespace mincpp
             }
         }
 
-        ~Impl()
+        ~SymbolSession()
         {
+            if (--s_sessionCount != 0)
+            {
+                return;
+            }
+
             if (NOT_OK(SymCleanup(GetThisProcessHandle())))
             {
                 ReportLastError(NAMEOF(SymCleanup));
             }
         }
+    };
+
+    uint32_t SymbolSession::s_sessionCount = 0;
+
+    // only for sharing the session already there (whether symbols are loaded is up to the count)
+    static std::weak_ptr<SymbolSession> activeSymbolSession;
+
+    static std::shared_ptr<SymbolSession> AcquireSymbolSession()
+    {
+        std::lock_guard<std::mutex> lock(symbolSessionMutex);
+        auto session = activeSymbolSession.lock();
+        if (!session)
+        {
+            session.reset(
+                new SymbolSession(),
+                [](SymbolSession* session)
+                {
+                    std::lock_guard<std::mutex> lock(symbolSessionMutex);
+                    delete session;
+                });
+
+            activeSymbolSession = session;
+        }
+        return session;
+    }
+
+    std::shared_ptr<const void> ShareCallStackAccess()
+    {
+        std::lock_guard<std::mutex> lock(symbolSessionMutex);
+        return activeSymbolSession.lock();
+    }
+
+	class CallStackAccessScope::Impl
+	{
+    private:
+
+        std::shared_ptr<SymbolSession> m_session;
+
+    public:
+
+        Impl()
+            : m_session(AcquireSymbolSession())
+        {
+        }
 	};
 
     CallStackAccessScope::CallStackAccessScope()
@@ -19,6 +19,8 @@ namespace mincpp
 {
 	/// <summary>
 	/// Creates a scope for access of the call stack.
+	/// Nested scopes share the same symbol session, which is also kept alive
+	/// by exceptions whose call stack trace has not been resolved yet.
 	/// </summary>
 	class CallStackAccessScope
 	{
@@ -0,0 +1,448 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "crash_handler_scope.hpp"
+#include "call_stack.hpp"
+#include "win32_errors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <iostream>
+#include <tuple>
+#include <utility>
+
+#include <psapi.h>
+
+namespace mincpp
+{
+    /// <summary>
+    /// Formats text into a fixed buffer, with neither heap allocation nor locale.
+    /// </summary>
+    class ReportWriter
+    {
+    private:
+
+        char* m_buffer;
+        size_t m_capacity;
+        size_t m_length;
+
+    public:
+
+        ReportWriter(char* buffer, size_t capacity)
+            : m_buffer(buffer)
+            , m_capacity(capacity)
+            , m_length(0)
+        {
+        }
+
+        const char* GetData() const { return m_buffer; }
+
+        size_t GetLength() const { return m_length; }
+
+        ReportWriter& Text(const char* text)
+        {
+            while (*text != 0 && m_length < m_capacity)
+            {
+                m_buffer[m_length++] = *text++;
+            }
+            return *this;
+        }
+
+        ReportWriter& Hex(uint64_t value, int digitCount = 16)
+        {
+            static const char digits[] = "0123456789abcdef";
+            char text[19] = "0x";
+            for (int idx = digitCount - 1; idx >= 0; --idx)
+            {
+                text[2 + idx] = digits[value & 0xf];
+                value >>= 4;
+            }
+            text[2 + digitCount] = 0;
+            return Text(text);
+        }
+
+        ReportWriter& Dec(uint64_t value)
+        {
+            char text[21]{};
+            int idx = sizeof text - 1;
+            do
+            {
+                text[--idx] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            return Text(text + idx);
+        }
+    };
+
+    // what is found in the debug directory of images built with PDB
+    struct CodeViewPdb70
+    {
+        DWORD signature;
+        GUID guid;
+        DWORD age;
+        char pdbFileName[1];
+    };
+
+    static constexpr DWORD CODEVIEW_PDB70_SIGNATURE = 0x53445352; // "RSDS"
+
+    static void WriteModuleIdentity(ReportWriter& writer, uint64_t moduleBase)
+    {
+        const auto base = reinterpret_cast<const BYTE*>(moduleBase);
+        const auto dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+        if (dosHeader->e_magic != IMAGE_DOS_SIGNATURE)
+        {
+            return;
+        }
+
+        const auto ntHeaders =
+            reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+
+        writer.Text(" size ").Hex(ntHeaders->OptionalHeader.SizeOfImage, 8)
+            .Text(" timestamp ").Hex(ntHeaders->FileHeader.TimeDateStamp, 8);
+
+        const IMAGE_DATA_DIRECTORY& debugDir =
+            ntHeaders->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
+
+        const auto debugEntries =
+            reinterpret_cast<const IMAGE_DEBUG_DIRECTORY*>(base + debugDir.VirtualAddress);
+
+        const size_t debugEntryCount = debugDir.Size / sizeof(IMAGE_DEBUG_DIRECTORY);
+        for (size_t idx = 0; idx < debugEntryCount; ++idx)
+        {
+            if (debugEntries[idx].Type != IMAGE_DEBUG_TYPE_CODEVIEW)
+            {
+                continue;
+            }
+
+            const auto codeView = reinterpret_cast<const CodeViewPdb70*>(
+                base + debugEntries[idx].AddressOfRawData);
+
+            if (codeView->signature == CODEVIEW_PDB70_SIGNATURE)
+            {
+                const GUID& guid = codeView->guid;
+                writer.Text(" guid ").Hex(guid.Data1, 8)
+                    .Text("-").Hex(guid.Data2, 4)
+                    .Text("-").Hex(guid.Data3, 4)
+                    .Text("-");
+
+                for (BYTE byte : guid.Data4)
+                {
+                    writer.Hex(byte, 2);
+                }
+
+                writer.Text(" age ").Dec(codeView->age)
+                    .Text(" pdb ").Text(codeView->pdbFileName);
+            }
+            break;
+        }
+    }
+
+    /// <summary>
+    /// The address ranges of the modules loaded in the process, taken in advance,
+    /// so that a crash report can look them up without the loader lock.
+    /// </summary>
+    class ModuleRanges
+    {
+    private:
+
+        struct Range
+        {
+            uint64_t base;
+            uint64_t size;
+        };
+
+        std::array<Range, 512> m_ranges;
+        size_t m_count;
+
+    public:
+
+        ModuleRanges()
+            : m_count(0)
+        {
+            std::array<HMODULE, std::tuple_size_v<decltype(m_ranges)>> modules;
+            DWORD requiredByteCount;
+            if (NOT_OK(K32EnumProcessModules(GetCurrentProcess(),
+                                             modules.data(),
+                                             static_cast<DWORD>(sizeof modules),
+                                             &requiredByteCount)))
+            {
+                Win32Errors::AppendErrorMessage(
+                    GetLastError(), NAMEOF(K32EnumProcessModules), std::cerr) << std::endl;
+                return;
+            }
+
+            // (modules beyond the capacity are left out)
+            const size_t moduleCount =
+                std::min<size_t>(requiredByteCount / sizeof(HMODULE), modules.size());
+
+            for (size_t idx = 0; idx < moduleCount; ++idx)
+            {
+                MODULEINFO moduleInfo;
+                if (K32GetModuleInformation(
+                    GetCurrentProcess(), modules[idx], &moduleInfo, sizeof moduleInfo))
+                {
+                    m_ranges[m_count++] = Range{
+                        reinterpret_cast<uint64_t>(moduleInfo.lpBaseOfDll),
+                        moduleInfo.SizeOfImage
+                    };
+                }
+            }
+        }
+
+        /// <returns>The base address of the module containing the given one, or 0 if none.</returns>
+        uint64_t FindBase(uint64_t address) const
+        {
+            for (size_t idx = 0; idx < m_count; ++idx)
+            {
+                if (address - m_ranges[idx].base < m_ranges[idx].size)
+                {
+                    return m_ranges[idx].base;
+                }
+            }
+            return 0;
+        }
+    };
+
+    static void WriteRegisters(ReportWriter& writer, const CONTEXT* context)
+    {
+        const std::pair<const char*, DWORD64> registers[] =
+        {
+            { "rip", context->Rip }, { "rsp", context->Rsp }, { "rbp", context->Rbp },
+            { "rax", context->Rax }, { "rbx", context->Rbx }, { "rcx", context->Rcx },
+            { "rdx", context->Rdx }, { "rsi", context->Rsi }, { "rdi", context->Rdi },
+            { "r8", context->R8 }, { "r9", context->R9 }, { "r10", context->R10 },
+            { "r11", context->R11 }, { "r12", context->R12 }, { "r13", context->R13 },
+            { "r14", context->R14 }, { "r15", context->R15 }, { "eflags", context->EFlags },
+        };
+
+        writer.Text("registers:");
+        int idx = 0;
+        for (const auto& [name, value] : registers)
+        {
+            writer.Text(idx++ % 3 == 0 ? "\r\n  " : " ").Text(name).Text("=").Hex(value);
+        }
+        writer.Text("\r\n");
+    }
+
+    static void WriteReportTo(
+        ReportWriter& writer,
+        const ModuleRanges& moduleRanges,
+        const EXCEPTION_POINTERS* exceptionPointers)
+    {
+        const EXCEPTION_RECORD* exRecord = exceptionPointers->ExceptionRecord;
+        const CONTEXT* context = exceptionPointers->ContextRecord;
+
+        FILETIME now;
+        GetSystemTimeAsFileTime(&now);
+
+        writer.Text("=== CRASH REPORT ===\r\n")
+            .Text("time (FILETIME): ")
+            .Dec((static_cast<uint64_t>(now.dwHighDateTime) << 32) | now.dwLowDateTime)
+            .Text("\r\nprocess ").Dec(GetCurrentProcessId())
+            .Text(", thread ").Dec(GetCurrentThreadId())
+            .Text("\r\nexception code ").Hex(exRecord->ExceptionCode, 8)
+            .Text(" at ").Hex(reinterpret_cast<uint64_t>(exRecord->ExceptionAddress));
+
+        for (DWORD idx = 0; idx < exRecord->NumberParameters; ++idx)
+        {
+            writer.Text(idx == 0 ? ", parameters " : " ")
+                .Hex(exRecord->ExceptionInformation[idx]);
+        }
+        writer.Text("\r\n");
+
+        WriteRegisters(writer, context);
+
+        // (the unwinding itself might need the lock of the dynamic function tables)
+        RawStackTrace rawTrace;
+        CallStack::Capture(context, rawTrace);
+
+        // modules are identified by base address, which is looked up in the snapshot
+        std::array<uint64_t, RawStackTrace::MaxFrameCount> moduleBases;
+        size_t moduleCount = 0;
+
+        writer.Text("frames:\r\n");
+        for (uint16_t idx = 0; idx < rawTrace.frameCount; ++idx)
+        {
+            const uint64_t address = rawTrace.addresses[idx];
+            if ((address & RawStackTrace::RecursionMark) == RawStackTrace::RecursionMark)
+            {
+                writer.Text("  (previous ").Dec(static_cast<uint16_t>(address >> 32))
+                    .Text(" frame(s) repeated ").Dec(static_cast<uint32_t>(address))
+                    .Text(" more time(s))\r\n");
+                continue;
+            }
+
+            const uint64_t base = moduleRanges.FindBase(address);
+
+            writer.Text("  ").Hex(address);
+            if (base != 0)
+            {
+                writer.Text(" = ").Hex(base).Text(" + ").Hex(address - base, 8);
+
+                if (std::find(moduleBases.cbegin(), moduleBases.cbegin() + moduleCount, base)
+                    == moduleBases.cbegin() + moduleCount)
+                {
+                    moduleBases[moduleCount++] = base;
+                }
+            }
+            writer.Text("\r\n");
+        }
+
+        writer.Text("modules:\r\n");
+        for (size_t idx = 0; idx < moduleCount; ++idx)
+        {
+            writer.Text("  ").Hex(moduleBases[idx]);
+            WriteModuleIdentity(writer, moduleBases[idx]);
+            writer.Text("\r\n");
+        }
+        writer.Text("\r\n");
+    }
+
+    class CrashHandlerScope::Impl
+    {
+    private:
+
+        static std::atomic<Impl*> s_activeHandler;
+        static std::atomic_flag s_isReporting;
+
+        HANDLE m_fileHandle;
+        bool m_isFileOwned;
+        Impl* m_prevHandler;
+        LPTOP_LEVEL_EXCEPTION_FILTER m_prevFilter;
+        ModuleRanges m_moduleRanges;
+
+        // allocated in advance, because the heap might be corrupted upon crash
+        std::array<char, 64 * 1024> m_buffer;
+
+        static LONG WINAPI OnUnhandledException(EXCEPTION_POINTERS* exceptionPointers)
+        {
+            Impl* handler = s_activeHandler.load();
+            if (handler == nullptr)
+            {
+                return EXCEPTION_CONTINUE_SEARCH;
+            }
+
+            handler->Write(exceptionPointers);
+
+            // nested scopes install this same filter, so the chain resumes below the outermost of them
+            while (handler->m_prevFilter == &OnUnhandledException && handler->m_prevHandler != nullptr)
+            {
+                handler = handler->m_prevHandler;
+            }
+
+            return (handler->m_prevFilter != nullptr && handler->m_prevFilter != &OnUnhandledException)
+                ? handler->m_prevFilter(exceptionPointers)
+                : EXCEPTION_CONTINUE_SEARCH;
+        }
+
+        void Install()
+        {
+            m_prevHandler = s_activeHandler.exchange(this);
+            m_prevFilter = SetUnhandledExceptionFilter(&OnUnhandledException);
+        }
+
+    public:
+
+        Impl(const std::filesystem::path& reportFilePath)
+            : m_isFileOwned(true)
+        {
+            m_fileHandle = CreateFileW(
+                reportFilePath.c_str(),
+                FILE_APPEND_DATA,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_ALWAYS,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+
+            if (m_fileHandle == INVALID_HANDLE_VALUE)
+            {
+                Win32Errors::AppendErrorMessage(
+                    GetLastError(), NAMEOF(CreateFileW), std::cerr) << std::endl;
+            }
+
+            Install();
+        }
+
+        Impl(void* reportFileHandle)
+            : m_fileHandle(reportFileHandle)
+            , m_isFileOwned(false)
+        {
+            Install();
+        }
+
+        ~Impl()
+        {
+            SetUnhandledExceptionFilter(m_prevFilter);
+            s_activeHandler.store(m_prevHandler);
+
+            if (m_isFileOwned && m_fileHandle != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(m_fileHandle);
+            }
+        }
+
+        static Impl* GetActiveHandler()
+        {
+            return s_activeHandler.load();
+        }
+
+        bool Write(const EXCEPTION_POINTERS* exceptionPointers)
+        {
+            // a crash while reporting (or in several threads at once) is not reported again
+            if (m_fileHandle == INVALID_HANDLE_VALUE || s_isReporting.test_and_set())
+            {
+                return false;
+            }
+
+            ReportWriter writer(m_buffer.data(), m_buffer.size());
+            WriteReportTo(writer, m_moduleRanges, exceptionPointers);
+
+            DWORD writtenByteCount;
+            BOOL success = WriteFile(
+                m_fileHandle,
+                writer.GetData(),
+                static_cast<DWORD>(writer.GetLength()),
+                &writtenByteCount,
+                nullptr);
+
+            s_isReporting.clear();
+            return success == TRUE;
+        }
+    };
+
+    std::atomic<CrashHandlerScope::Impl*> CrashHandlerScope::Impl::s_activeHandler = nullptr;
+    std::atomic_flag CrashHandlerScope::Impl::s_isReporting;
+
+    CrashHandlerScope::CrashHandlerScope(const std::filesystem::path& reportFilePath)
+        : m_pimpl(std::make_unique<CrashHandlerScope::Impl>(reportFilePath))
+    {
+    }
+
+    CrashHandlerScope::CrashHandlerScope(void* reportFileHandle)
+        : m_pimpl(std::make_unique<CrashHandlerScope::Impl>(reportFileHandle))
+    {
+    }
+
+    CrashHandlerScope::~CrashHandlerScope() = default;
+
+    bool CrashHandlerScope::WriteReport(const void* exceptionPointers)
+    {
+        Impl* handler = Impl::GetActiveHandler();
+        return handler != nullptr
+            && handler->Write(static_cast<const EXCEPTION_POINTERS*>(exceptionPointers));
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Creates a scope where unhandled exceptions (SEH or C++) get a crash report
+	/// appended to a file, before the process dies. The report has the raw call stack,
+	/// the registers and the debug identity (PDB path, GUID and age) of the modules
+	/// in the stack, so that symbols can be resolved offline or upon the next start.
+	/// Writing it needs no heap allocation, only a preallocated buffer and a file
+	/// opened in advance, and the modules are looked up in a snapshot of their address
+	/// ranges taken when the scope is created (modules loaded later are not identified).
+	/// The report is best-effort, though: unwinding the stack might still take the lock
+	/// of the dynamic function tables, so a crash while holding it can hang the report.
+	/// </summary>
+	class CrashHandlerScope
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		/// <param name="reportFilePath">
+		/// The file where crash reports are appended to. It is opened right away.
+		/// </param>
+		CrashHandlerScope(const std::filesystem::path& reportFilePath);
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		/// <param name="reportFileHandle">
+		/// The system handle for an open file where crash reports are written.
+		/// (Its ownership is not transferred.)
+		/// </param>
+		CrashHandlerScope(void* reportFileHandle);
+
+		~CrashHandlerScope();
+
+		/// <summary>
+		/// Writes a crash report into the file of the active scope.
+		/// </summary>
+		/// <param name="exceptionPointers">
+		/// Provided by the caught Win32 exception. (The erased type is PEXCEPTION_POINTERS.)
+		/// </param>
+		/// <returns>Whether the report has been written.</returns>
+		static bool WriteReport(const void* exceptionPointers);
+	};
+}
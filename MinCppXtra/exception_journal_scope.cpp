@@ -0,0 +1,379 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "exception_journal_scope.hpp"
+#include "traceable_exception.hpp"
+#include "win32_errors.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+
+namespace mincpp
+{
+    static constexpr char JOURNAL_MAGIC[8] = "MCXJRNL";
+    static constexpr uint32_t JOURNAL_VERSION = 2;
+    static constexpr size_t JOURNAL_FRAME_COUNT = 40;
+
+    // how long the end of a scope waits for the threads still appending to its journal
+    static constexpr std::chrono::seconds JOURNAL_DRAIN_TIMEOUT(1);
+
+    // layout of the journal file: header, then slots
+
+    struct JournalHeader
+    {
+        char magic[sizeof JOURNAL_MAGIC];
+        uint32_t version;
+        uint32_t slotSize;
+        uint64_t slotCount;
+
+        // contended by writers, so it has its own cache line
+        alignas(64) uint64_t nextSequence;
+    };
+
+    struct JournalSlot
+    {
+        // twice the sequence of the record when complete, one less while written, zero when empty
+        uint64_t state;
+        int64_t timestamp; // nanoseconds since the epoch of the system clock
+        uint64_t throwSiteKey;
+        uint32_t threadId;
+        uint16_t messageLength;
+        uint16_t frameCount;
+        char message[ExceptionJournalScope::MaxMessageLength];
+        uint64_t frames[JOURNAL_FRAME_COUNT];
+        // the slot is complete when the state is twice this
+        uint64_t sequence;
+    };
+
+    class ExceptionJournalScope::Impl
+    {
+    private:
+
+        static std::atomic<Impl*> s_activeJournal;
+        static std::mutex s_chainMutex;
+
+        // appending threads, which might still use this journal after it has been deactivated
+        std::atomic<uint32_t> m_writerCount;
+
+        HANDLE m_fileHandle;
+        HANDLE m_mappingHandle;
+        JournalHeader* m_header;
+        JournalSlot* m_slots;
+        Impl* m_prevJournal;
+
+        static bool IsCompatible(const JournalHeader* header, size_t recordCount)
+        {
+            return memcmp(header->magic, JOURNAL_MAGIC, sizeof JOURNAL_MAGIC) == 0
+                && header->version == JOURNAL_VERSION
+                && header->slotSize == sizeof(JournalSlot)
+                && header->slotCount == recordCount;
+        }
+
+    public:
+
+        Impl(const std::filesystem::path& journalFilePath, size_t recordCount)
+            : m_writerCount(0)
+            , m_mappingHandle(nullptr)
+            , m_header(nullptr)
+        {
+            m_fileHandle = CreateFileW(
+                journalFilePath.c_str(),
+                GENERIC_READ | GENERIC_WRITE,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_ALWAYS,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+
+            if (m_fileHandle == INVALID_HANDLE_VALUE)
+            {
+                throw TraceableException(
+                    Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(CreateFileW)));
+            }
+
+            const uint64_t fileSize =
+                sizeof(JournalHeader) + recordCount * sizeof(JournalSlot);
+
+            // (the file is extended to the size of the mapping when smaller)
+            m_mappingHandle = CreateFileMappingW(
+                m_fileHandle,
+                nullptr,
+                PAGE_READWRITE,
+                static_cast<DWORD>(fileSize >> 32),
+                static_cast<DWORD>(fileSize),
+                nullptr);
+
+            if (m_mappingHandle != nullptr)
+            {
+                m_header = static_cast<JournalHeader*>(
+                    MapViewOfFile(m_mappingHandle, FILE_MAP_WRITE, 0, 0, fileSize));
+            }
+
+            if (m_header == nullptr)
+            {
+                const DWORD errCode = GetLastError();
+                const char* funcName = (m_mappingHandle == nullptr)
+                    ? NAMEOF(CreateFileMappingW) : NAMEOF(MapViewOfFile);
+
+                if (m_mappingHandle != nullptr)
+                {
+                    CloseHandle(m_mappingHandle);
+                }
+                CloseHandle(m_fileHandle);
+                throw TraceableException(Win32Errors::GetErrorMessage(errCode, funcName));
+            }
+
+            m_slots = reinterpret_cast<JournalSlot*>(m_header + 1);
+
+            if (!IsCompatible(m_header, recordCount))
+            {
+                memset(m_header, 0, fileSize);
+                memcpy(m_header->magic, JOURNAL_MAGIC, sizeof JOURNAL_MAGIC);
+                m_header->version = JOURNAL_VERSION;
+                m_header->slotSize = sizeof(JournalSlot);
+                m_header->slotCount = recordCount;
+            }
+            else
+            {
+                // a slot being written when the process died would never be claimed again
+                for (uint64_t idx = 0; idx < recordCount; ++idx)
+                {
+                    if ((m_slots[idx].state & 1) != 0)
+                    {
+                        m_slots[idx].state = 0;
+                    }
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(s_chainMutex);
+            m_prevJournal = s_activeJournal.load();
+            s_activeJournal.store(this);
+        }
+
+        ~Impl()
+        {
+            UnmapViewOfFile(m_header);
+            CloseHandle(m_mappingHandle);
+            CloseHandle(m_fileHandle);
+        }
+
+        /// <summary>
+        /// Takes the journal out of the chain, then waits (for a limited time)
+        /// for the threads that got it before and might still be appending.
+        /// </summary>
+        /// <returns>Whether no thread is still appending, so the journal can be released.</returns>
+        bool DeactivateAndDrain()
+        {
+            Deactivate();
+
+            const auto deadline = std::chrono::steady_clock::now() + JOURNAL_DRAIN_TIMEOUT;
+            while (m_writerCount.load() != 0)
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    return false;
+                }
+                SwitchToThread();
+            }
+            return true;
+        }
+
+        void Deactivate()
+        {
+            std::lock_guard<std::mutex> lock(s_chainMutex);
+            if (s_activeJournal.load() == this)
+            {
+                s_activeJournal.store(m_prevJournal);
+                return;
+            }
+
+            // scopes ended out of order, so take this one out of the chain
+            for (Impl* journal = s_activeJournal.load(); journal != nullptr; journal = journal->m_prevJournal)
+            {
+                if (journal->m_prevJournal == this)
+                {
+                    journal->m_prevJournal = m_prevJournal;
+                    break;
+                }
+            }
+        }
+
+        static bool IsActive() noexcept
+        {
+            return s_activeJournal.load(std::memory_order_acquire) != nullptr;
+        }
+
+        static void AppendToActive(std::string_view message, uint64_t throwSiteKey) noexcept
+        {
+            Impl* journal = s_activeJournal.load();
+            if (journal == nullptr)
+            {
+                return;
+            }
+
+            // counted in the journal, then checked to be still active, so that its drain waits for this
+            journal->m_writerCount.fetch_add(1);
+            if (s_activeJournal.load() == journal)
+            {
+                journal->Append(message, throwSiteKey);
+            }
+            journal->m_writerCount.fetch_sub(1, std::memory_order_release);
+        }
+
+        void Append(std::string_view message, uint64_t throwSiteKey) noexcept
+        {
+            RawStackTrace rawTrace;
+            CallStack::Capture(rawTrace);
+
+            const uint64_t sequence =
+                std::atomic_ref<uint64_t>(m_header->nextSequence)
+                    .fetch_add(1, std::memory_order_relaxed) + 1;
+
+            JournalSlot& slot = m_slots[(sequence - 1) % m_header->slotCount];
+
+            // once the ring wraps, a slow writer might meet a newer one in the same slot:
+            // only one of them claims it, and never an older record over a newer one
+            std::atomic_ref<uint64_t> state(slot.state);
+            uint64_t prevState = state.load(std::memory_order_relaxed);
+            if ((prevState & 1) != 0
+                || prevState >= 2 * sequence
+                || !state.compare_exchange_strong(prevState, 2 * sequence - 1, std::memory_order_relaxed))
+            {
+                return;
+            }
+            std::atomic_ref<uint64_t>(slot.sequence).store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot.timestamp =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+
+            slot.throwSiteKey = throwSiteKey;
+            slot.threadId = GetCurrentThreadId();
+            slot.messageLength =
+                static_cast<uint16_t>(std::min(message.length(), sizeof slot.message));
+            memcpy(slot.message, message.data(), slot.messageLength);
+
+            slot.frameCount =
+                static_cast<uint16_t>(std::min<size_t>(rawTrace.frameCount, JOURNAL_FRAME_COUNT));
+            memcpy(slot.frames, rawTrace.addresses.data(), slot.frameCount * sizeof slot.frames[0]);
+
+            std::atomic_ref<uint64_t>(slot.sequence).store(sequence, std::memory_order_release);
+            state.store(2 * sequence, std::memory_order_release);
+        }
+    };
+
+    std::atomic<ExceptionJournalScope::Impl*> ExceptionJournalScope::Impl::s_activeJournal = nullptr;
+    std::mutex ExceptionJournalScope::Impl::s_chainMutex;
+
+    ExceptionJournalScope::ExceptionJournalScope(
+        const std::filesystem::path& journalFilePath,
+        size_t recordCount)
+        : m_pimpl(std::make_unique<ExceptionJournalScope::Impl>(journalFilePath, recordCount))
+    {
+    }
+
+    ExceptionJournalScope::~ExceptionJournalScope()
+    {
+        // a journal that a thread is still appending to is left mapped, rather than pulled from under it
+        if (!m_pimpl->DeactivateAndDrain())
+        {
+            std::cerr << "Exception journal is still being written, hence it is not released" << std::endl;
+            m_pimpl.release();
+        }
+    }
+
+    bool ExceptionJournalScope::IsActive() noexcept
+    {
+        return Impl::IsActive();
+    }
+
+    void ExceptionJournalScope::Append(std::string_view message, uint64_t throwSiteKey) noexcept
+    {
+        Impl::AppendToActive(message, throwSiteKey);
+    }
+
+    std::vector<ExceptionJournalScope::Record> ExceptionJournalScope::Read(
+        const std::filesystem::path& journalFilePath)
+    {
+        std::ifstream ifs(journalFilePath, std::ios::binary);
+        if (!ifs)
+        {
+            throw TraceableException("Cannot open journal file " + journalFilePath.string());
+        }
+
+        const std::vector<char> content(
+            (std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+        JournalHeader header;
+        if (content.size() < sizeof header)
+        {
+            throw TraceableException("Not a journal file: " + journalFilePath.string());
+        }
+        memcpy(&header, content.data(), sizeof header);
+
+        if (memcmp(header.magic, JOURNAL_MAGIC, sizeof JOURNAL_MAGIC) != 0
+            || header.version != JOURNAL_VERSION
+            || header.slotSize != sizeof(JournalSlot)
+            || content.size() < sizeof header + header.slotCount * sizeof(JournalSlot))
+        {
+            throw TraceableException("Not a journal file: " + journalFilePath.string());
+        }
+
+        std::vector<Record> records;
+        for (uint64_t idx = 0; idx < header.slotCount; ++idx)
+        {
+            JournalSlot slot;
+            memcpy(&slot,
+                content.data() + sizeof header + idx * sizeof slot,
+                sizeof slot);
+
+            // skip what is empty, or was being written (when the process died or meanwhile)
+            if (slot.sequence == 0 || slot.state != 2 * slot.sequence)
+            {
+                continue;
+            }
+
+            Record& record = records.emplace_back();
+            record.sequence = slot.sequence;
+            record.time = std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(slot.timestamp)));
+            record.threadId = slot.threadId;
+            record.throwSiteKey = slot.throwSiteKey;
+            record.messagePrefix.assign(
+                slot.message, std::min<size_t>(slot.messageLength, sizeof slot.message));
+            record.rawTrace.frameCount =
+                static_cast<uint16_t>(std::min<size_t>(slot.frameCount, JOURNAL_FRAME_COUNT));
+            std::copy(
+                slot.frames,
+                slot.frames + record.rawTrace.frameCount,
+                record.rawTrace.addresses.begin());
+        }
+
+        std::sort(records.begin(), records.end(),
+            [](const Record& left, const Record& right)
+            {
+                return left.sequence < right.sequence;
+            });
+
+        return records;
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include "call_stack.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Creates a scope where every mincpp::TraceableException is recorded into a journal,
+	/// which is a memory-mapped file with a fixed count of slots used in circular fashion.
+	/// Recording takes no locks (many threads can write at once) and no synchronous I/O,
+	/// while the records outlive the process, even when it is killed.
+	/// (A record is dropped when a slower thread is still writing into its slot.)
+	/// Scopes can end in any order, and each waits for the threads still appending to it
+	/// (for a limited time, after which its journal is left mapped until the process ends).
+	/// </summary>
+	class ExceptionJournalScope
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		static constexpr size_t DefaultRecordCount = 1024;
+		static constexpr size_t MaxMessageLength = 128;
+
+		/// <summary>
+		/// A record decoded from the journal.
+		/// </summary>
+		struct Record
+		{
+			uint64_t sequence;
+			std::chrono::system_clock::time_point time;
+			uint32_t threadId;
+			uint64_t throwSiteKey;
+			std::string messagePrefix;
+			RawStackTrace rawTrace;
+		};
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		/// <param name="journalFilePath">
+		/// The file of the journal. When it already has a journal of same capacity,
+		/// the existing records are kept, otherwise it is (re)initialized.
+		/// </param>
+		/// <param name="recordCount">How many records the journal can hold.</param>
+		ExceptionJournalScope(
+			const std::filesystem::path& journalFilePath,
+			size_t recordCount = DefaultRecordCount);
+
+		~ExceptionJournalScope();
+
+		/// <summary>
+		/// Tells whether there is an active journal.
+		/// </summary>
+		static bool IsActive() noexcept;
+
+		/// <summary>
+		/// Appends a record to the active journal (if any), with the current call stack.
+		/// </summary>
+		/// <param name="message">The message, whose prefix gets recorded.</param>
+		/// <param name="throwSiteKey">A key for the throw site.</param>
+		static void Append(std::string_view message, uint64_t throwSiteKey) noexcept;
+
+		/// <summary>
+		/// Reads the records from a journal file, such as after the process has been restarted.
+		/// </summary>
+		/// <param name="journalFilePath">The file of the journal.</param>
+		/// <returns>The complete records, from oldest to most recent.</returns>
+		static std::vector<Record> Read(const std::filesystem::path& journalFilePath);
+	};
+}
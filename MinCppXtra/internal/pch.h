@@ -8,11 +8,16 @@
 #define PCH_H
 
 // Fügen Sie hier Header hinzu, die vorkompiliert werden sollen.
-#include "framework.h"
-#include <windows.h>
+// (off Windows, only the portable modules are built, such as the transcoding kernels)
+#ifdef _WIN32
+#	include "framework.h"
+#	include <windows.h>
 
-#undef min
-#undef max
+#	undef min
+#	undef max
+#endif
+
+#include <memory>
 
 #define NOT_OK(call) (call) == FALSE
 #define OK(call) (call) == TRUE
@@ -20,12 +25,21 @@
 
 namespace mincpp
 {
+#ifdef _WIN32
 	/// <summary>
 	/// Gets a handle for this process that can be used as process handle for some Win32 API calls.
 	/// See https://learn.microsoft.com/en-us/windows/win32/api/dbghelp/nf-dbghelp-syminitialize#parameters.
 	/// </summary>
 	/// <returns>A handle for the current process.</returns>
 	HANDLE GetThisProcessHandle();
+#endif
+
+	/// <summary>
+	/// Shares the symbol session of the active mincpp::CallStackAccessScope (if any),
+	/// so that symbols can still be resolved after such scope is gone.
+	/// </summary>
+	/// <returns>A reference that keeps the session alive, or null when there is none.</returns>
+	std::shared_ptr<const void> ShareCallStackAccess();
 }
 
 #endif //PCH_H
@@ -0,0 +1,69 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include "../trace_metrics.hpp"
+
+#include <intrin.h>
+
+namespace mincpp
+{
+    /// <summary>
+    /// Records a value measured for a metric (with durations in timestamp counter ticks).
+    /// </summary>
+    void RecordTraceMetric(TraceMetric metric, uint64_t value) noexcept;
+
+    /// <summary>
+    /// Measures a stage with the timestamp counter, when mincpp::TraceMetrics is enabled.
+    /// </summary>
+    class StageTimer
+    {
+    private:
+
+        const bool m_isEnabled;
+        uint64_t m_start;
+
+    public:
+
+        StageTimer() noexcept
+            : m_isEnabled(TraceMetrics::IsEnabled())
+            , m_start(m_isEnabled ? __rdtsc() : 0)
+        {
+        }
+
+        /// <summary>
+        /// Records the time elapsed since construction or the previous lap.
+        /// </summary>
+        void Lap(TraceMetric metric) noexcept
+        {
+            if (m_isEnabled)
+            {
+                const uint64_t now = __rdtsc();
+                RecordTraceMetric(metric, now - m_start);
+                m_start = now;
+            }
+        }
+
+        /// <summary>
+        /// Records a quantity measured along with the stage.
+        /// </summary>
+        void Count(TraceMetric metric, uint64_t value) noexcept
+        {
+            if (m_isEnabled)
+            {
+                RecordTraceMetric(metric, value);
+            }
+        }
+    };
+}
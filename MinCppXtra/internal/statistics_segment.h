@@ -0,0 +1,70 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <string>
+
+namespace mincpp
+{
+    // layout of the shared memory where statistics are exported to other processes
+
+    static constexpr char STATISTICS_MAGIC[8] = "MCXSTAT";
+    static constexpr uint32_t STATISTICS_VERSION = 1;
+    static constexpr size_t STATISTICS_MAX_COUNTERS = 32;
+    static constexpr size_t STATISTICS_MAX_THROW_SITES = 32;
+
+    struct ExportedCounter
+    {
+        char name[56];
+        uint64_t value;
+    };
+
+    struct ExportedThrowSite
+    {
+        uint64_t throwSiteKey;
+        uint64_t totalCount;
+        uint64_t ratePerSecond;
+        uint32_t line;
+        uint32_t isStorming;
+        char functionName[128];
+        char fileName[128];
+    };
+
+    struct StatisticsSegment
+    {
+        // written once, before the segment is shared
+        char magic[sizeof STATISTICS_MAGIC];
+        uint32_t version;
+        uint32_t segmentSize;
+        uint32_t processId;
+
+        // odd while the content below is being written
+        alignas(64) uint64_t sequence;
+
+        uint64_t publishCount;
+        int64_t publishTime; // nanoseconds since the epoch of the system clock
+        uint32_t counterCount;
+        uint32_t throwSiteCount;
+        ExportedCounter counters[STATISTICS_MAX_COUNTERS];
+        ExportedThrowSite throwSites[STATISTICS_MAX_THROW_SITES];
+    };
+
+    /// <summary>
+    /// Gets the name of the shared memory where a process exports its statistics.
+    /// </summary>
+    /// <param name="processId">The ID of the process.</param>
+    /// <returns>The name of the file mapping object.</returns>
+    std::wstring GetStatisticsSegmentName(uint32_t processId);
+}
@@ -0,0 +1,247 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include "../win32_api_strings.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mincpp
+{
+    /// <summary>
+    /// Outcome of a transcoding kernel.
+    /// </summary>
+    struct TranscodingResult
+    {
+        /// <summary>
+        /// Count of input code units consumed.
+        /// </summary>
+        size_t read;
+
+        /// <summary>
+        /// Count of output code units written.
+        /// </summary>
+        size_t written;
+
+        /// <summary>
+        /// Whether transcoding stopped at invalid input, which then starts at position "read".
+        /// (Otherwise "read" only falls short of the input length when the output is full.)
+        /// </summary>
+        bool isInvalid;
+    };
+
+    // Transcoding routines dispatched to the fastest kernels the processor supports.
+    // Vectorized stores need slack in the output, so the kernels fall back to scalar code
+    // close to its end, and stop short of splitting a code point when it is full.
+
+    /// <summary>
+    /// Counts the UTF-8 code units required to encode UTF-16 text (exact for valid input).
+    /// </summary>
+    size_t CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept;
+
+    /// <summary>
+    /// Transcodes UTF-16 to UTF-8 until the input is over, invalid, or no more output fits.
+    /// </summary>
+    TranscodingResult TranscodeUtf16ToUtf8(
+        const char16_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+    /// <summary>
+    /// Counts the UTF-16 code units required to encode UTF-8 text (exact for valid input).
+    /// </summary>
+    size_t CountUtf16OfUtf8(const char* input, size_t length) noexcept;
+
+    /// <summary>
+    /// Transcodes UTF-8 to UTF-16 until the input is over, invalid, or no more output fits.
+    /// Invalid input is what utfcpp rejects, starting at the same position.
+    /// </summary>
+    TranscodingResult TranscodeUtf8ToUtf16(
+        const char* input, size_t length, char16_t* output, size_t capacity) noexcept;
+
+    /// <summary>
+    /// Measures how much of UTF-8 text is valid, which is what utfcpp accepts.
+    /// </summary>
+    /// <returns>The position of the first invalid (or incomplete) sequence, or else the length.</returns>
+    size_t MeasureValidUtf8(const char* input, size_t length) noexcept;
+
+    /// <summary>
+    /// Counts the UTF-8 code units required to encode UTF-32 text (exact for valid input).
+    /// </summary>
+    size_t CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept;
+
+    /// <summary>
+    /// Transcodes UTF-32 to UTF-8 until the input is over, invalid, or no more output fits.
+    /// Invalid input is what utfcpp rejects (surrogates and beyond U+10FFFF).
+    /// </summary>
+    TranscodingResult TranscodeUtf32ToUtf8(
+        const char32_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+    /// <summary>
+    /// Counts the UTF-32 code units required to encode UTF-8 text (exact for valid input).
+    /// </summary>
+    size_t CountUtf32OfUtf8(const char* input, size_t length) noexcept;
+
+    /// <summary>
+    /// Transcodes UTF-8 to UTF-32 until the input is over, invalid, or no more output fits.
+    /// Invalid input is what utfcpp rejects, starting at the same position.
+    /// </summary>
+    TranscodingResult TranscodeUtf8ToUtf32(
+        const char* input, size_t length, char32_t* output, size_t capacity) noexcept;
+
+    /// <summary>
+    /// Moves a position in UTF-8 text back to the start of the sequence it falls in, if any,
+    /// so that cutting the text there does not split a valid sequence.
+    /// </summary>
+    size_t FindUtf8SequenceStart(const char* input, size_t length, size_t position) noexcept;
+
+    /// <summary>
+    /// Gets the length of the UTF-8 sequence a lead byte announces, or 0 if it cannot lead one.
+    /// </summary>
+    size_t GetUtf8SequenceLength(char lead) noexcept;
+
+    /// <summary>
+    /// Measures the sequence at the end of UTF-8 text that lacks bytes to be complete, if any.
+    /// </summary>
+    /// <returns>How many bytes of the incomplete sequence are present (0 to 3).</returns>
+    size_t MeasureIncompleteUtf8Tail(const char* input, size_t length) noexcept;
+
+    /// <summary>
+    /// Gets the acceleration of the kernels currently in use.
+    /// </summary>
+    Win32ApiStrings::Acceleration GetUtfKernelsAcceleration() noexcept;
+
+    /// <summary>
+    /// Switches to the fastest kernels that are supported and not above the given limit.
+    /// </summary>
+    void LimitUtfKernelsAcceleration(Win32ApiStrings::Acceleration limit) noexcept;
+
+    // Routines for wide-chars, which are UTF-16 in Windows, but UTF-32 in Linux and others,
+    // dispatched at compile time to the kernels for their width:
+
+    constexpr bool IsWideCharUtf16 = sizeof(wchar_t) == sizeof(char16_t);
+
+    static_assert(IsWideCharUtf16 || sizeof(wchar_t) == sizeof(char32_t));
+
+    inline size_t CountUtf8OfWide(const wchar_t* input, size_t length) noexcept
+    {
+        if constexpr (IsWideCharUtf16)
+            return CountUtf8OfUtf16(reinterpret_cast<const char16_t*>(input), length);
+        else
+            return CountUtf8OfUtf32(reinterpret_cast<const char32_t*>(input), length);
+    }
+
+    inline TranscodingResult TranscodeWideToUtf8(
+        const wchar_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        if constexpr (IsWideCharUtf16)
+            return TranscodeUtf16ToUtf8(reinterpret_cast<const char16_t*>(input), length, output, capacity);
+        else
+            return TranscodeUtf32ToUtf8(reinterpret_cast<const char32_t*>(input), length, output, capacity);
+    }
+
+    inline size_t CountWideOfUtf8(const char* input, size_t length) noexcept
+    {
+        if constexpr (IsWideCharUtf16)
+            return CountUtf16OfUtf8(input, length);
+        else
+            return CountUtf32OfUtf8(input, length);
+    }
+
+    inline TranscodingResult TranscodeUtf8ToWide(
+        const char* input, size_t length, wchar_t* output, size_t capacity) noexcept
+    {
+        if constexpr (IsWideCharUtf16)
+            return TranscodeUtf8ToUtf16(input, length, reinterpret_cast<char16_t*>(output), capacity);
+        else
+            return TranscodeUtf8ToUtf32(input, length, reinterpret_cast<char32_t*>(output), capacity);
+    }
+
+    // Implementations of the kernels for each level of acceleration, which
+    // share the contract of the dispatching routines above:
+
+    namespace scalar
+    {
+        size_t CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf16ToUtf8(
+            const char16_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+        size_t CountUtf16OfUtf8(const char* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf8ToUtf16(
+            const char* input, size_t length, char16_t* output, size_t capacity) noexcept;
+
+        size_t MeasureValidUtf8(const char* input, size_t length) noexcept;
+
+        size_t CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf32ToUtf8(
+            const char32_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+        size_t CountUtf32OfUtf8(const char* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf8ToUtf32(
+            const char* input, size_t length, char32_t* output, size_t capacity) noexcept;
+    }
+
+    namespace sse2
+    {
+        size_t CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf16ToUtf8(
+            const char16_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+        size_t CountUtf16OfUtf8(const char* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf8ToUtf16(
+            const char* input, size_t length, char16_t* output, size_t capacity) noexcept;
+
+        size_t MeasureValidUtf8(const char* input, size_t length) noexcept;
+
+        size_t CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf32ToUtf8(
+            const char32_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+        size_t CountUtf32OfUtf8(const char* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf8ToUtf32(
+            const char* input, size_t length, char32_t* output, size_t capacity) noexcept;
+    }
+
+    namespace avx2
+    {
+        size_t CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf16ToUtf8(
+            const char16_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+        size_t CountUtf16OfUtf8(const char* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf8ToUtf16(
+            const char* input, size_t length, char16_t* output, size_t capacity) noexcept;
+
+        size_t MeasureValidUtf8(const char* input, size_t length) noexcept;
+
+        size_t CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf32ToUtf8(
+            const char32_t* input, size_t length, char* output, size_t capacity) noexcept;
+
+        size_t CountUtf32OfUtf8(const char* input, size_t length) noexcept;
+
+        TranscodingResult TranscodeUtf8ToUtf32(
+            const char* input, size_t length, char32_t* output, size_t capacity) noexcept;
+    }
+}
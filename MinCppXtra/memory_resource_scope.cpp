@@ -0,0 +1,37 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "memory_resource_scope.hpp"
+
+namespace mincpp
+{
+    // null when no scope is active in the thread
+    static thread_local std::pmr::memory_resource* t_resource = nullptr;
+
+    MemoryResourceScope::MemoryResourceScope(std::pmr::memory_resource* resource) noexcept
+        : m_previousResource(t_resource)
+    {
+        t_resource = resource;
+    }
+
+    MemoryResourceScope::~MemoryResourceScope()
+    {
+        t_resource = m_previousResource;
+    }
+
+    std::pmr::memory_resource* MemoryResourceScope::GetResource() noexcept
+    {
+        return t_resource != nullptr ? t_resource : std::pmr::get_default_resource();
+    }
+}
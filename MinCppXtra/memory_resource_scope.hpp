@@ -0,0 +1,56 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <memory_resource>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Creates a scope where the current thread takes scratch memory from the given
+	/// memory resource, such as an arena for a request, whose memory can then be released
+	/// all at once. mincpp::TraceableException formats its message and its call stack trace
+	/// there, then copies them out in a single allocation each. What the exception keeps
+	/// stays on the global heap, because it can outlive the scope (and the resource):
+	/// the scope ends while the exception unwinds, and an std::exception_ptr can take it
+	/// to another thread. Nested scopes take over and give the resource back when they end.
+	/// </summary>
+	class MemoryResourceScope
+	{
+	private:
+
+		std::pmr::memory_resource* m_previousResource;
+
+	public:
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		/// <param name="resource">The memory resource for the current thread.</param>
+		explicit MemoryResourceScope(std::pmr::memory_resource* resource) noexcept;
+
+		~MemoryResourceScope();
+
+		MemoryResourceScope(const MemoryResourceScope&) = delete;
+		MemoryResourceScope& operator=(const MemoryResourceScope&) = delete;
+
+		/// <summary>
+		/// Gets the memory resource of the current thread.
+		/// </summary>
+		/// <returns>
+		/// The resource of the innermost active scope, or else std::pmr::get_default_resource().
+		/// </returns>
+		static std::pmr::memory_resource* GetResource() noexcept;
+	};
+}
@@ -0,0 +1,192 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string_view>
+
+namespace mincpp
+{
+	/// <summary>
+	/// A string with inline capacity, which only allocates memory when it gets longer than that.
+	/// It is always terminated by '\0', so that it can be passed to C APIs.
+	/// </summary>
+	/// <typeparam name="CharType">The type of character.</typeparam>
+	/// <typeparam name="InlineCapacity">How many characters (final '\0' excluded) fit without allocation.</typeparam>
+	template <typename CharType, size_t InlineCapacity>
+	class BasicSmallString
+	{
+	private:
+
+		std::unique_ptr<CharType[]> m_heapBuffer;
+		size_t m_length;
+		size_t m_capacity;
+		CharType m_inlineBuffer[InlineCapacity + 1];
+
+		void MoveFrom(BasicSmallString& other) noexcept
+		{
+			m_heapBuffer = std::move(other.m_heapBuffer);
+			m_length = other.m_length;
+			m_capacity = other.m_capacity;
+			if (!m_heapBuffer)
+				std::copy_n(other.m_inlineBuffer, m_length + 1, m_inlineBuffer);
+
+			other.m_length = 0;
+			other.m_capacity = InlineCapacity;
+			other.m_inlineBuffer[0] = CharType();
+		}
+
+	public:
+
+		BasicSmallString() noexcept
+			: m_length(0)
+			, m_capacity(InlineCapacity)
+		{
+			m_inlineBuffer[0] = CharType();
+		}
+
+		BasicSmallString(std::basic_string_view<CharType> text)
+			: BasicSmallString()
+		{
+			Assign(text);
+		}
+
+		BasicSmallString(const BasicSmallString& other)
+			: BasicSmallString()
+		{
+			Assign(other.GetView());
+		}
+
+		BasicSmallString(BasicSmallString&& other) noexcept
+		{
+			MoveFrom(other);
+		}
+
+		BasicSmallString& operator=(const BasicSmallString& other)
+		{
+			if (this != &other)
+				Assign(other.GetView());
+
+			return *this;
+		}
+
+		BasicSmallString& operator=(BasicSmallString&& other) noexcept
+		{
+			if (this != &other)
+				MoveFrom(other);
+
+			return *this;
+		}
+
+		/// <summary>
+		/// Gets the characters, which are followed by '\0'.
+		/// </summary>
+		CharType* GetData() noexcept
+		{
+			return m_heapBuffer ? m_heapBuffer.get() : m_inlineBuffer;
+		}
+
+		/// <summary>
+		/// Gets the characters, which are followed by '\0'.
+		/// </summary>
+		const CharType* GetData() const noexcept
+		{
+			return m_heapBuffer ? m_heapBuffer.get() : m_inlineBuffer;
+		}
+
+		/// <summary>
+		/// Gets the count of characters (final '\0' excluded).
+		/// </summary>
+		size_t GetLength() const noexcept
+		{
+			return m_length;
+		}
+
+		/// <summary>
+		/// Gets how many characters fit before the next allocation.
+		/// </summary>
+		size_t GetCapacity() const noexcept
+		{
+			return m_capacity;
+		}
+
+		/// <summary>
+		/// Tells whether the characters are still in the inline buffer.
+		/// </summary>
+		bool IsInline() const noexcept
+		{
+			return !m_heapBuffer;
+		}
+
+		std::basic_string_view<CharType> GetView() const noexcept
+		{
+			return std::basic_string_view<CharType>(GetData(), m_length);
+		}
+
+		operator std::basic_string_view<CharType>() const noexcept
+		{
+			return GetView();
+		}
+
+		/// <summary>
+		/// Makes room for a count of characters, keeping the current ones.
+		/// </summary>
+		/// <param name="capacity">The count of characters (final '\0' excluded).</param>
+		void Reserve(size_t capacity)
+		{
+			if (capacity <= m_capacity)
+				return;
+
+			capacity = std::max(capacity, 2 * m_capacity);
+			auto heapBuffer = std::make_unique_for_overwrite<CharType[]>(capacity + 1);
+			std::copy_n(GetData(), m_length + 1, heapBuffer.get());
+			m_heapBuffer = std::move(heapBuffer);
+			m_capacity = capacity;
+		}
+
+		/// <summary>
+		/// Changes the length of the string, keeping the characters that remain.
+		/// Characters added are left unspecified, so that they are overwritten at no cost.
+		/// </summary>
+		/// <param name="length">The new count of characters (final '\0' excluded).</param>
+		void Resize(size_t length)
+		{
+			Reserve(length);
+			m_length = length;
+			GetData()[length] = CharType();
+		}
+
+		/// <summary>
+		/// Replaces the content of the string.
+		/// </summary>
+		void Assign(std::basic_string_view<CharType> text)
+		{
+			Resize(text.length());
+			std::copy_n(text.data(), text.length(), GetData());
+		}
+	};
+
+	/// <summary>
+	/// A string with inline capacity for a path (as long as MAX_PATH by default).
+	/// </summary>
+	template <size_t InlineCapacity = 260>
+	using SmallString = BasicSmallString<char, InlineCapacity>;
+
+	/// <summary>
+	/// A wide string with inline capacity for a path (as long as MAX_PATH by default).
+	/// </summary>
+	template <size_t InlineCapacity = 260>
+	using SmallWString = BasicSmallString<wchar_t, InlineCapacity>;
+}
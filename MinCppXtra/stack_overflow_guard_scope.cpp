@@ -0,0 +1,50 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "stack_overflow_guard_scope.hpp"
+#include "win32_errors.hpp"
+
+#include <iostream>
+#include <malloc.h>
+
+namespace mincpp
+{
+    class StackOverflowGuardScope::Impl
+    {
+    public:
+
+        Impl(uint32_t guaranteedBytes)
+        {
+            // (a guarantee smaller than the current one has no effect)
+            ULONG stackSizeInBytes = guaranteedBytes;
+            if (NOT_OK(SetThreadStackGuarantee(&stackSizeInBytes)))
+            {
+                Win32Errors::AppendErrorMessage(
+                    GetLastError(), NAMEOF(SetThreadStackGuarantee), std::cerr) << std::endl;
+            }
+        }
+    };
+
+    StackOverflowGuardScope::StackOverflowGuardScope(uint32_t guaranteedBytes)
+        : m_pimpl(std::make_unique<StackOverflowGuardScope::Impl>(guaranteedBytes))
+    {
+    }
+
+    StackOverflowGuardScope::~StackOverflowGuardScope() = default;
+
+    bool StackOverflowGuardScope::RestoreGuardPage()
+    {
+        return _resetstkoflw() != 0;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <memory>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Creates a scope where the current thread keeps enough stack space to handle
+	/// a stack overflow, so that it can be translated (see SehTranslationScope)
+	/// and its call stack captured. The guaranteed space is taken from the stack
+	/// already reserved for the thread, hence no memory is allocated per thread.
+	/// The guarantee cannot be lowered while the thread lives (Windows ignores that),
+	/// so it stays in place after the scope ends, until the thread exits.
+	/// </summary>
+	class StackOverflowGuardScope
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		static constexpr uint32_t DefaultGuaranteedBytes = 64 * 1024;
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		/// <param name="guaranteedBytes">
+		/// How much stack remains available for handling a stack overflow.
+		/// </param>
+		StackOverflowGuardScope(uint32_t guaranteedBytes = DefaultGuaranteedBytes);
+
+		~StackOverflowGuardScope();
+
+		/// <summary>
+		/// Restores the guard page of the current thread after a stack overflow
+		/// has been handled, so that the next one can be detected as well.
+		/// It must be called outside of the catch block.
+		/// </summary>
+		/// <returns>Whether the guard page could be restored.</returns>
+		static bool RestoreGuardPage();
+	};
+}
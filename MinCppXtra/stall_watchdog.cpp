@@ -0,0 +1,345 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "stall_watchdog.hpp"
+#include "traceable_exception.hpp"
+#include "win32_errors.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace mincpp
+{
+    static int64_t GetSteadyTicks() noexcept
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // how often the monitor takes out the slots of threads that have ended
+    static constexpr std::chrono::seconds SLOT_REAPING_INTERVAL(1);
+
+    struct ThreadSlot
+    {
+        DWORD threadId;
+
+        // kept open, so that the thread ID cannot be reused by another thread while in the slot
+        HANDLE threadHandle;
+
+        // written only by the owning thread, read by the monitor
+        std::atomic<int64_t> deadline;
+        std::atomic<uint64_t> armCount;
+
+        // accessed only by the monitor
+        uint64_t reportedArmCount;
+
+        ThreadSlot(DWORD threadId, HANDLE threadHandle)
+            : threadId(threadId)
+            , threadHandle(threadHandle)
+            , deadline(0)
+            , armCount(0)
+            , reportedArmCount(0)
+        {
+        }
+
+        ~ThreadSlot()
+        {
+            CloseHandle(threadHandle);
+        }
+
+        ThreadSlot(const ThreadSlot&) = delete;
+        ThreadSlot& operator=(const ThreadSlot&) = delete;
+
+        bool HasThreadEnded() const noexcept
+        {
+            return WaitForSingleObject(threadHandle, 0) != WAIT_TIMEOUT;
+        }
+    };
+
+    // cache of the slot the current thread holds in the most recent watchdog it used
+    struct CachedThreadSlot
+    {
+        uint64_t watchdogId;
+        ThreadSlot* slot;
+    };
+
+    static thread_local CachedThreadSlot t_cachedSlot;
+    static std::atomic<uint64_t> s_nextWatchdogId{ 1 };
+
+    class StallWatchdog::Impl
+    {
+    private:
+
+        const uint64_t m_id;
+        const uint32_t m_samplesPerStall;
+        const std::chrono::milliseconds m_samplingInterval;
+        const uint32_t m_maxStallsPerSecond;
+        const std::chrono::milliseconds m_pollingInterval;
+
+        std::mutex m_slotsMutex;
+        std::vector<std::unique_ptr<ThreadSlot>> m_slots;
+
+        std::mutex m_stallsMutex;
+        std::vector<Stall> m_stalls;
+
+        std::mutex m_monitorMutex;
+        std::condition_variable m_monitorCondition;
+        bool m_stopRequested;
+        std::thread m_monitorThread;
+
+        // accessed only by the monitor
+        std::vector<ThreadSlot*> m_overdueSlots;
+        double m_rateLimitTokens;
+        int64_t m_rateLimitRefillTime;
+        int64_t m_nextReapingTime;
+
+        // returns false when stop was requested meanwhile
+        bool Wait(std::chrono::milliseconds duration)
+        {
+            std::unique_lock<std::mutex> lock(m_monitorMutex);
+            return !m_monitorCondition.wait_for(lock, duration, [this] { return m_stopRequested; });
+        }
+
+        bool TryTakeRateLimitToken(int64_t now)
+        {
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::duration(now - m_rateLimitRefillTime);
+
+            m_rateLimitRefillTime = now;
+            m_rateLimitTokens = std::min(
+                static_cast<double>(m_maxStallsPerSecond),
+                m_rateLimitTokens + elapsed.count() * m_maxStallsPerSecond);
+
+            if (m_rateLimitTokens < 1.0)
+            {
+                return false;
+            }
+
+            m_rateLimitTokens -= 1.0;
+            return true;
+        }
+
+        void FindOverdueSlots(int64_t now)
+        {
+            m_overdueSlots.clear();
+            std::lock_guard<std::mutex> lock(m_slotsMutex);
+
+            // (done by the monitor, because it is the one holding slots outside the lock)
+            if (now >= m_nextReapingTime)
+            {
+                std::erase_if(m_slots, [](const auto& slot) { return slot->HasThreadEnded(); });
+                m_nextReapingTime = now
+                    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(SLOT_REAPING_INTERVAL).count();
+            }
+
+            for (const auto& slot : m_slots)
+            {
+                const int64_t deadline = slot->deadline.load(std::memory_order_relaxed);
+                if (deadline != 0 && deadline < now
+                    && slot->armCount.load(std::memory_order_relaxed) != slot->reportedArmCount)
+                {
+                    m_overdueSlots.push_back(slot.get());
+                }
+            }
+        }
+
+        // returns false when stop was requested meanwhile
+        bool SampleStall(ThreadSlot& slot)
+        {
+            const uint64_t armCount = slot.armCount.load(std::memory_order_relaxed);
+            const int64_t deadline = slot.deadline.load(std::memory_order_relaxed);
+            slot.reportedArmCount = armCount;
+
+            Stall stall{};
+            stall.threadId = slot.threadId;
+            stall.overdue = std::chrono::steady_clock::duration(GetSteadyTicks() - deadline);
+            stall.samples.reserve(m_samplesPerStall);
+
+            for (uint32_t idx = 0; idx < m_samplesPerStall; ++idx)
+            {
+                if (idx > 0 && !Wait(m_samplingInterval))
+                {
+                    return false;
+                }
+
+                // a thread that ended while armed is not sampled anymore
+                if (slot.HasThreadEnded())
+                {
+                    break;
+                }
+
+                RawStackTrace rawTrace;
+                const bool captured = CallStack::CaptureThread(slot.threadId, rawTrace);
+
+                // the thread might have moved on while it was not suspended
+                if (slot.armCount.load(std::memory_order_relaxed) != armCount
+                    || slot.deadline.load(std::memory_order_relaxed) == 0)
+                {
+                    break;
+                }
+
+                if (captured)
+                {
+                    stall.samples.push_back(rawTrace);
+                }
+            }
+
+            if (!stall.samples.empty())
+            {
+                std::lock_guard<std::mutex> lock(m_stallsMutex);
+                m_stalls.push_back(std::move(stall));
+            }
+            return true;
+        }
+
+        void Monitor()
+        {
+            while (Wait(m_pollingInterval))
+            {
+                const int64_t now = GetSteadyTicks();
+                FindOverdueSlots(now);
+                for (ThreadSlot* slot : m_overdueSlots)
+                {
+                    if (!TryTakeRateLimitToken(now))
+                    {
+                        // dropped, but not sampled again for the same deadline
+                        slot->reportedArmCount = slot->armCount.load(std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (!SampleStall(*slot))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        ThreadSlot& RegisterCurrentThread()
+        {
+            const DWORD threadId = GetCurrentThreadId();
+            std::lock_guard<std::mutex> lock(m_slotsMutex);
+            for (const auto& slot : m_slots)
+            {
+                if (slot->threadId == threadId)
+                {
+                    return *slot;
+                }
+            }
+
+            HANDLE threadHandle = OpenThread(SYNCHRONIZE, FALSE, threadId);
+            if (threadHandle == nullptr)
+            {
+                throw TraceableException(
+                    Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(OpenThread)));
+            }
+
+            auto& slot = m_slots.emplace_back(std::make_unique<ThreadSlot>(threadId, threadHandle));
+            return *slot;
+        }
+
+    public:
+
+        Impl(uint32_t samplesPerStall,
+             std::chrono::milliseconds samplingInterval,
+             uint32_t maxStallsPerSecond,
+             std::chrono::milliseconds pollingInterval)
+            : m_id(s_nextWatchdogId.fetch_add(1, std::memory_order_relaxed))
+            , m_samplesPerStall(std::max(samplesPerStall, 1U))
+            , m_samplingInterval(samplingInterval)
+            , m_maxStallsPerSecond(std::max(maxStallsPerSecond, 1U))
+            , m_pollingInterval(pollingInterval)
+            , m_stopRequested(false)
+            , m_rateLimitTokens(m_maxStallsPerSecond)
+            , m_rateLimitRefillTime(GetSteadyTicks())
+            , m_nextReapingTime(m_rateLimitRefillTime)
+        {
+            m_monitorThread = std::thread(&Impl::Monitor, this);
+        }
+
+        ~Impl()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_monitorMutex);
+                m_stopRequested = true;
+            }
+            m_monitorCondition.notify_one();
+            m_monitorThread.join();
+        }
+
+        ThreadSlot* FindCurrentThreadSlot() const noexcept
+        {
+            return t_cachedSlot.watchdogId == m_id ? t_cachedSlot.slot : nullptr;
+        }
+
+        ThreadSlot& GetCurrentThreadSlot()
+        {
+            if (ThreadSlot* slot = FindCurrentThreadSlot())
+            {
+                return *slot;
+            }
+
+            ThreadSlot& slot = RegisterCurrentThread();
+            t_cachedSlot = CachedThreadSlot{ m_id, &slot };
+            return slot;
+        }
+
+        std::vector<Stall> TakeStalls()
+        {
+            std::lock_guard<std::mutex> lock(m_stallsMutex);
+            return std::exchange(m_stalls, {});
+        }
+    };
+
+    StallWatchdog::StallWatchdog(
+        uint32_t samplesPerStall,
+        std::chrono::milliseconds samplingInterval,
+        uint32_t maxStallsPerSecond,
+        std::chrono::milliseconds pollingInterval)
+        : m_pimpl(std::make_unique<Impl>(
+            samplesPerStall, samplingInterval, maxStallsPerSecond, pollingInterval))
+    {
+    }
+
+    StallWatchdog::~StallWatchdog() = default;
+
+    void StallWatchdog::Arm(std::chrono::nanoseconds budget)
+    {
+        ThreadSlot& slot = m_pimpl->GetCurrentThreadSlot();
+
+        // only the owning thread writes, so no read-modify-write is needed
+        slot.armCount.store(slot.armCount.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+
+        slot.deadline.store(
+            GetSteadyTicks() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget).count(),
+            std::memory_order_relaxed);
+    }
+
+    void StallWatchdog::Disarm() noexcept
+    {
+        if (ThreadSlot* slot = m_pimpl->FindCurrentThreadSlot())
+        {
+            slot->deadline.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<StallWatchdog::Stall> StallWatchdog::TakeStalls()
+    {
+        return m_pimpl->TakeStalls();
+    }
+}
@@ -0,0 +1,131 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include "call_stack.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Monitors threads that arm a deadline, and samples the call stack of those
+	/// which let it pass without disarming it. Only raw addresses are captured (from
+	/// the monitor thread), so symbols are resolved later by mincpp::CallStack.
+	/// Threads that have ended are not sampled, and their registration is dropped.
+	/// </summary>
+	class StallWatchdog
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		/// <summary>
+		/// Default interval in which the monitor thread checks the deadlines.
+		/// </summary>
+		static constexpr std::chrono::milliseconds DefaultPollingInterval{ 1 };
+
+		/// <summary>
+		/// Default maximum amount of stalls recorded per second.
+		/// </summary>
+		static constexpr uint32_t DefaultMaxStallsPerSecond = 10;
+
+		/// <summary>
+		/// A stall of a thread that let its deadline pass.
+		/// </summary>
+		struct Stall
+		{
+			uint32_t threadId;
+
+			/// <summary>
+			/// How long the deadline had passed when the first sample was taken.
+			/// </summary>
+			std::chrono::nanoseconds overdue;
+
+			/// <summary>
+			/// The stack samples, taken while the deadline remained armed.
+			/// </summary>
+			std::vector<RawStackTrace> samples;
+		};
+
+		/// <summary>
+		/// Creates the watchdog and starts its monitor thread.
+		/// </summary>
+		/// <param name="samplesPerStall">How many times the stack of a stalled thread is sampled.</param>
+		/// <param name="samplingInterval">The interval between samples of the same stall.</param>
+		/// <param name="maxStallsPerSecond">The rate limit for recording stalls.</param>
+		/// <param name="pollingInterval">The interval in which deadlines are checked.</param>
+		StallWatchdog(
+			uint32_t samplesPerStall = 1,
+			std::chrono::milliseconds samplingInterval = std::chrono::milliseconds(5),
+			uint32_t maxStallsPerSecond = DefaultMaxStallsPerSecond,
+			std::chrono::milliseconds pollingInterval = DefaultPollingInterval);
+
+		/// <summary>
+		/// Stops the monitor thread.
+		/// </summary>
+		~StallWatchdog();
+
+		/// <summary>
+		/// Arms a deadline for the current thread. (Only the first call in a thread
+		/// allocates, in order to register it. After that, it costs a couple of
+		/// relaxed atomic stores.)
+		/// </summary>
+		/// <param name="budget">How long from now until the deadline.</param>
+		void Arm(std::chrono::nanoseconds budget);
+
+		/// <summary>
+		/// Disarms the deadline of the current thread.
+		/// </summary>
+		void Disarm() noexcept;
+
+		/// <summary>
+		/// Takes the stalls recorded so far.
+		/// </summary>
+		/// <returns>The stalls in the order they were detected.</returns>
+		std::vector<Stall> TakeStalls();
+
+		/// <summary>
+		/// Arms a deadline for the current thread during its lifetime.
+		/// </summary>
+		class ArmedScope
+		{
+		private:
+
+			StallWatchdog& m_watchdog;
+
+		public:
+
+			ArmedScope(StallWatchdog& watchdog, std::chrono::nanoseconds budget)
+				: m_watchdog(watchdog)
+			{
+				m_watchdog.Arm(budget);
+			}
+
+			~ArmedScope()
+			{
+				m_watchdog.Disarm();
+			}
+
+			ArmedScope(const ArmedScope&) = delete;
+			ArmedScope& operator=(const ArmedScope&) = delete;
+		};
+	};
+}
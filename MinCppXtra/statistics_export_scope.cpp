@@ -0,0 +1,216 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "internal/statistics_segment.h"
+#include "statistics_export_scope.hpp"
+#include "throw_site_statistics.hpp"
+#include "trace_metrics.hpp"
+#include "traceable_exception.hpp"
+#include "win32_errors.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+namespace mincpp
+{
+    std::wstring GetStatisticsSegmentName(uint32_t processId)
+    {
+        return L"Local\\MinCppXtra.Statistics." + std::to_wstring(processId);
+    }
+
+    template <size_t N>
+    static void CopyTruncated(char (&destination)[N], std::string_view source)
+    {
+        const size_t length = std::min(source.length(), N - 1);
+        memcpy(destination, source.data(), length);
+        memset(destination + length, 0, N - length);
+    }
+
+    class StatisticsExportScope::Impl
+    {
+    private:
+
+        HANDLE m_mappingHandle;
+        StatisticsSegment* m_segment;
+
+        // prepared apart, so that the shared segment is only locked for a copy
+        std::unique_ptr<StatisticsSegment> m_staging;
+
+        const std::chrono::milliseconds m_publishingInterval;
+        std::mutex m_publisherMutex;
+        std::condition_variable m_publisherCondition;
+        bool m_stopRequested;
+        std::thread m_publisherThread;
+
+        void AddCounter(std::string_view name, uint64_t value)
+        {
+            if (m_staging->counterCount < STATISTICS_MAX_COUNTERS)
+            {
+                ExportedCounter& counter = m_staging->counters[m_staging->counterCount++];
+                CopyTruncated(counter.name, name);
+                counter.value = value;
+            }
+        }
+
+        void Prepare()
+        {
+            m_staging->publishCount += 1;
+            m_staging->publishTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+            m_staging->counterCount = 0;
+            AddCounter("throw_sites.overflow", ThrowSiteStatistics::GetOverflowCount());
+            AddCounter("throw_sites.throttled", ThrowSiteStatistics::GetThrottledCount());
+
+            if (TraceMetrics::IsEnabled())
+            {
+                for (uint32_t idx = 0; idx < static_cast<uint32_t>(TraceMetric::Count); ++idx)
+                {
+                    const auto metric = static_cast<TraceMetric>(idx);
+                    const auto histogram = TraceMetrics::GetHistogram(metric);
+                    const auto name = TraceMetrics::GetName(metric);
+                    AddCounter(std::format("trace.{}.count", name), histogram.count);
+                    AddCounter(std::format("trace.{}.p50", name), histogram.GetPercentile(50));
+                    AddCounter(std::format("trace.{}.p99", name), histogram.GetPercentile(99));
+                    AddCounter(std::format("trace.{}.max", name), histogram.max);
+                }
+            }
+
+            const auto sites = ThrowSiteStatistics::GetTopSites(STATISTICS_MAX_THROW_SITES);
+            m_staging->throwSiteCount = static_cast<uint32_t>(sites.size());
+            for (size_t idx = 0; idx < sites.size(); ++idx)
+            {
+                ExportedThrowSite& site = m_staging->throwSites[idx];
+                site.throwSiteKey = sites[idx].throwSiteKey;
+                site.totalCount = sites[idx].totalCount;
+                site.ratePerSecond = sites[idx].ratePerSecond;
+                site.line = sites[idx].throwSite.line();
+                site.isStorming = sites[idx].isStorming ? 1 : 0;
+                CopyTruncated(site.functionName, sites[idx].throwSite.function_name());
+                CopyTruncated(site.fileName, sites[idx].throwSite.file_name());
+            }
+        }
+
+        void Publish() noexcept
+        {
+            constexpr size_t contentOffset = offsetof(StatisticsSegment, publishCount);
+            std::atomic_ref<uint64_t> sequence(m_segment->sequence);
+            const uint64_t initialSequence = sequence.load(std::memory_order_relaxed);
+
+            // readers retry when they see the sequence odd or changed
+            sequence.store(initialSequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy(reinterpret_cast<char*>(m_segment) + contentOffset,
+                   reinterpret_cast<const char*>(m_staging.get()) + contentOffset,
+                   sizeof(StatisticsSegment) - contentOffset);
+
+            sequence.store(initialSequence + 2, std::memory_order_release);
+        }
+
+        void RunPublisher()
+        {
+            std::unique_lock<std::mutex> lock(m_publisherMutex);
+            do
+            {
+                try
+                {
+                    Prepare();
+                    Publish();
+                }
+                catch (std::exception& ex)
+                {
+                    std::cerr << "Failed to publish statistics: " << ex.what() << std::endl;
+                }
+            } while (!m_publisherCondition.wait_for(
+                lock, m_publishingInterval, [this] { return m_stopRequested; }));
+        }
+
+    public:
+
+        Impl(std::chrono::milliseconds publishingInterval)
+            : m_staging(std::make_unique<StatisticsSegment>())
+            , m_publishingInterval(publishingInterval)
+            , m_stopRequested(false)
+        {
+            const std::wstring segmentName = GetStatisticsSegmentName(GetCurrentProcessId());
+            m_mappingHandle = CreateFileMappingW(
+                INVALID_HANDLE_VALUE,
+                nullptr,
+                PAGE_READWRITE,
+                0,
+                sizeof(StatisticsSegment),
+                segmentName.c_str());
+
+            if (m_mappingHandle == nullptr)
+            {
+                throw TraceableException(
+                    Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(CreateFileMappingW)));
+            }
+
+            if (GetLastError() == ERROR_ALREADY_EXISTS)
+            {
+                CloseHandle(m_mappingHandle);
+                throw TraceableException("Statistics are already exported by this process");
+            }
+
+            m_segment = static_cast<StatisticsSegment*>(
+                MapViewOfFile(m_mappingHandle, FILE_MAP_WRITE, 0, 0, sizeof(StatisticsSegment)));
+
+            if (m_segment == nullptr)
+            {
+                const DWORD errCode = GetLastError();
+                CloseHandle(m_mappingHandle);
+                throw TraceableException(
+                    Win32Errors::GetErrorMessage(errCode, NAMEOF(MapViewOfFile)));
+            }
+
+            // (the mapping starts zeroed, and the magic tells readers it is initialized)
+            m_segment->version = STATISTICS_VERSION;
+            m_segment->segmentSize = sizeof(StatisticsSegment);
+            m_segment->processId = GetCurrentProcessId();
+            std::atomic_thread_fence(std::memory_order_release);
+            memcpy(m_segment->magic, STATISTICS_MAGIC, sizeof STATISTICS_MAGIC);
+
+            m_publisherThread = std::thread(&Impl::RunPublisher, this);
+        }
+
+        ~Impl()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_publisherMutex);
+                m_stopRequested = true;
+            }
+            m_publisherCondition.notify_one();
+            m_publisherThread.join();
+
+            UnmapViewOfFile(m_segment);
+            CloseHandle(m_mappingHandle);
+        }
+    };
+
+    StatisticsExportScope::StatisticsExportScope(std::chrono::milliseconds publishingInterval)
+        : m_pimpl(std::make_unique<Impl>(publishingInterval))
+    {
+    }
+
+    StatisticsExportScope::~StatisticsExportScope() = default;
+}
@@ -0,0 +1,46 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Creates a scope where the statistics of this library are periodically published
+	/// into shared memory, so that an external process can poll them with
+	/// mincpp::StatisticsReader (or the MinCppXtraStats tool) without calling into
+	/// this process. Readers are synchronized by a sequence lock, hence publishing
+	/// never waits for them and makes no system calls.
+	/// </summary>
+	class StatisticsExportScope
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		/// <param name="publishingInterval">How often the statistics are published.</param>
+		StatisticsExportScope(
+			std::chrono::milliseconds publishingInterval = std::chrono::milliseconds(1000));
+
+		~StatisticsExportScope();
+	};
+}
@@ -0,0 +1,174 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "internal/statistics_segment.h"
+#include "statistics_reader.hpp"
+#include "traceable_exception.hpp"
+#include "win32_errors.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <thread>
+
+namespace mincpp
+{
+    // how many times to retry when the statistics change while being copied
+    static constexpr uint32_t MAX_READ_ATTEMPTS = 100;
+
+    static std::string ToString(const char* text, size_t maxLength)
+    {
+        return std::string(text, strnlen(text, maxLength));
+    }
+
+    class StatisticsReader::Impl
+    {
+    private:
+
+        HANDLE m_mappingHandle;
+        const StatisticsSegment* m_segment;
+        std::unique_ptr<StatisticsSegment> m_copy;
+
+        uint64_t LoadSequence(std::memory_order order) const
+        {
+            // (the view is read-only, but an atomic load does not write on x64)
+            return std::atomic_ref<uint64_t>(
+                const_cast<uint64_t&>(m_segment->sequence)).load(order);
+        }
+
+        bool TryCopy() const
+        {
+            const uint64_t sequence = LoadSequence(std::memory_order_acquire);
+            if (sequence % 2 != 0)
+            {
+                return false;
+            }
+
+            memcpy(m_copy.get(), m_segment, sizeof(StatisticsSegment));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return LoadSequence(std::memory_order_relaxed) == sequence;
+        }
+
+        ExportedStatistics Decode() const
+        {
+            ExportedStatistics statistics{};
+            statistics.processId = m_copy->processId;
+            statistics.publishCount = m_copy->publishCount;
+            statistics.publishTime = std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(m_copy->publishTime)));
+
+            const uint32_t counterCount =
+                std::min<uint32_t>(m_copy->counterCount, STATISTICS_MAX_COUNTERS);
+
+            for (uint32_t idx = 0; idx < counterCount; ++idx)
+            {
+                const ExportedCounter& counter = m_copy->counters[idx];
+                statistics.counters.push_back(
+                    { ToString(counter.name, sizeof counter.name), counter.value });
+            }
+
+            const uint32_t throwSiteCount =
+                std::min<uint32_t>(m_copy->throwSiteCount, STATISTICS_MAX_THROW_SITES);
+
+            for (uint32_t idx = 0; idx < throwSiteCount; ++idx)
+            {
+                const ExportedThrowSite& site = m_copy->throwSites[idx];
+                statistics.throwSites.push_back({
+                    site.throwSiteKey,
+                    ToString(site.functionName, sizeof site.functionName),
+                    ToString(site.fileName, sizeof site.fileName),
+                    site.line,
+                    site.totalCount,
+                    site.ratePerSecond,
+                    site.isStorming != 0 });
+            }
+
+            return statistics;
+        }
+
+    public:
+
+        Impl(uint32_t processId)
+            : m_copy(std::make_unique<StatisticsSegment>())
+        {
+            const std::wstring segmentName = GetStatisticsSegmentName(processId);
+            m_mappingHandle = OpenFileMappingW(FILE_MAP_READ, FALSE, segmentName.c_str());
+            if (m_mappingHandle == nullptr)
+            {
+                throw TraceableException(
+                    Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(OpenFileMappingW)));
+            }
+
+            m_segment = static_cast<const StatisticsSegment*>(
+                MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+
+            if (m_segment == nullptr)
+            {
+                const DWORD errCode = GetLastError();
+                CloseHandle(m_mappingHandle);
+                throw TraceableException(
+                    Win32Errors::GetErrorMessage(errCode, NAMEOF(MapViewOfFile)));
+            }
+
+            MEMORY_BASIC_INFORMATION memoryInfo{};
+            VirtualQuery(m_segment, &memoryInfo, sizeof memoryInfo);
+
+            if (memoryInfo.RegionSize < sizeof(StatisticsSegment)
+                || memcmp(m_segment->magic, STATISTICS_MAGIC, sizeof STATISTICS_MAGIC) != 0
+                || m_segment->version != STATISTICS_VERSION
+                || m_segment->segmentSize != sizeof(StatisticsSegment))
+            {
+                UnmapViewOfFile(m_segment);
+                CloseHandle(m_mappingHandle);
+                throw TraceableException(std::format(
+                    "Statistics of process {} have incompatible layout", processId));
+            }
+        }
+
+        ~Impl()
+        {
+            UnmapViewOfFile(m_segment);
+            CloseHandle(m_mappingHandle);
+        }
+
+        std::optional<ExportedStatistics> Read() const
+        {
+            for (uint32_t attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+            {
+                if (TryCopy())
+                {
+                    return m_copy->publishCount != 0
+                        ? std::optional<ExportedStatistics>(Decode())
+                        : std::nullopt;
+                }
+                std::this_thread::yield();
+            }
+            return std::nullopt;
+        }
+    };
+
+    StatisticsReader::StatisticsReader(uint32_t processId)
+        : m_pimpl(std::make_unique<Impl>(processId))
+    {
+    }
+
+    StatisticsReader::~StatisticsReader() = default;
+
+    std::optional<ExportedStatistics> StatisticsReader::Read() const
+    {
+        return m_pimpl->Read();
+    }
+}
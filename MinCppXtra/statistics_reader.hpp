@@ -0,0 +1,90 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Statistics read from a process that exports them with mincpp::StatisticsExportScope.
+	/// </summary>
+	struct ExportedStatistics
+	{
+		struct Counter
+		{
+			std::string name;
+			uint64_t value;
+		};
+
+		struct ThrowSite
+		{
+			uint64_t throwSiteKey;
+			std::string functionName;
+			std::string fileName;
+			uint32_t line;
+			uint64_t totalCount;
+			uint64_t ratePerSecond;
+			bool isStorming;
+		};
+
+		uint32_t processId;
+
+		/// <summary>
+		/// How many times the statistics have been published.
+		/// </summary>
+		uint64_t publishCount;
+
+		std::chrono::system_clock::time_point publishTime;
+		std::vector<Counter> counters;
+
+		/// <summary>
+		/// The sites that threw the most, sorted by descending rate.
+		/// </summary>
+		std::vector<ThrowSite> throwSites;
+	};
+
+	/// <summary>
+	/// Reads the statistics that another process exports to shared memory.
+	/// It never blocks that process, and it makes no call into it.
+	/// </summary>
+	class StatisticsReader
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		/// <summary>
+		/// Opens the statistics exported by a process.
+		/// </summary>
+		/// <param name="processId">The ID of the process.</param>
+		StatisticsReader(uint32_t processId);
+
+		~StatisticsReader();
+
+		/// <summary>
+		/// Reads a consistent copy of the statistics.
+		/// </summary>
+		/// <returns>The statistics, unless they kept changing meanwhile or were never published.</returns>
+		std::optional<ExportedStatistics> Read() const;
+	};
+}
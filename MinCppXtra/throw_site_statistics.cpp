@@ -0,0 +1,315 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "throw_site_statistics.hpp"
+
+#include "exception_journal_scope.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <span>
+#include <string_view>
+
+namespace mincpp
+{
+    // each processor increments its own stripe of counters
+    static constexpr uint32_t STRIPE_COUNT = 16;
+
+    // how many throws a stripe counts for a site before checking its rate
+    static constexpr uint64_t RATE_CHECK_PERIOD = 64;
+
+    static constexpr std::chrono::steady_clock::duration RATE_WINDOW = std::chrono::seconds(1);
+
+    static_assert((ThrowSiteStatistics::Capacity & (ThrowSiteStatistics::Capacity - 1)) == 0,
+                  "capacity must be a power of 2");
+
+    struct SiteEntry
+    {
+        std::atomic<uint64_t> key; // zero when free
+        std::atomic<bool> isReady;
+        std::source_location throwSite;
+
+        // the rate is measured over windows, which are rolled by whoever notices they are over
+        std::atomic<int64_t> windowStart;
+        std::atomic<uint64_t> windowBaseCount;
+        std::atomic<uint64_t> ratePerSecond;
+        std::atomic<bool> isStorming;
+    };
+
+    struct alignas(64) CounterStripe
+    {
+        std::atomic<uint64_t> counts[ThrowSiteStatistics::Capacity];
+    };
+
+    static SiteEntry s_sites[ThrowSiteStatistics::Capacity];
+    static CounterStripe s_stripes[STRIPE_COUNT];
+    static std::atomic<uint64_t> s_stormThreshold{ ThrowSiteStatistics::DefaultStormThreshold };
+    static std::atomic<uint64_t> s_overflowCount;
+
+    struct alignas(64) PaddedCounter
+    {
+        std::atomic<uint64_t> value;
+    };
+
+    // throttling happens in storms, so this is striped as well
+    static PaddedCounter s_throttledCounts[STRIPE_COUNT];
+
+    static int64_t GetSteadyTicks() noexcept
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    static uint64_t ToTableKey(uint64_t throwSiteKey) noexcept
+    {
+        return throwSiteKey != 0 ? throwSiteKey : 1;
+    }
+
+    static size_t ToFirstIndex(uint64_t key) noexcept
+    {
+        return static_cast<size_t>(key ^ (key >> 32)) & (ThrowSiteStatistics::Capacity - 1);
+    }
+
+    static SiteEntry* FindSite(uint64_t key) noexcept
+    {
+        for (size_t probe = 0; probe < ThrowSiteStatistics::Capacity; ++probe)
+        {
+            SiteEntry& site = s_sites[(ToFirstIndex(key) + probe) & (ThrowSiteStatistics::Capacity - 1)];
+            const uint64_t siteKey = site.key.load(std::memory_order_acquire);
+            if (siteKey == key)
+            {
+                return &site;
+            }
+            if (siteKey == 0)
+            {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    static SiteEntry* FindOrInsertSite(uint64_t key, const std::source_location& throwSite) noexcept
+    {
+        for (size_t probe = 0; probe < ThrowSiteStatistics::Capacity; ++probe)
+        {
+            SiteEntry& site = s_sites[(ToFirstIndex(key) + probe) & (ThrowSiteStatistics::Capacity - 1)];
+            uint64_t siteKey = site.key.load(std::memory_order_acquire);
+            if (siteKey == 0
+                && site.key.compare_exchange_strong(siteKey, key, std::memory_order_acq_rel))
+            {
+                site.throwSite = throwSite;
+                site.windowStart.store(GetSteadyTicks(), std::memory_order_relaxed);
+                site.isReady.store(true, std::memory_order_release);
+                return &site;
+            }
+            if (siteKey == key)
+            {
+                return &site;
+            }
+        }
+        return nullptr;
+    }
+
+    static size_t GetIndex(const SiteEntry& site) noexcept
+    {
+        return static_cast<size_t>(&site - s_sites);
+    }
+
+    static uint64_t SumCounts(const SiteEntry& site) noexcept
+    {
+        uint64_t total = 0;
+        for (const CounterStripe& stripe : s_stripes)
+        {
+            total += stripe.counts[GetIndex(site)].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    static uint64_t CalculateRatePerSecond(uint64_t count, std::chrono::steady_clock::duration elapsed) noexcept
+    {
+        if (elapsed.count() <= 0)
+        {
+            return 0;
+        }
+
+        constexpr std::chrono::steady_clock::duration second = std::chrono::seconds(1);
+        return static_cast<uint64_t>(
+            static_cast<double>(count) * second.count() / elapsed.count());
+    }
+
+    static std::string_view FormatSummary(
+        const std::source_location& throwSite,
+        uint64_t ratePerSecond,
+        std::span<char> buffer) noexcept
+    {
+        const char* unit = "";
+        uint64_t count = ratePerSecond;
+        if (count >= 10'000'000)
+        {
+            count /= 1'000'000;
+            unit = "M";
+        }
+        else if (count >= 10'000)
+        {
+            count /= 1'000;
+            unit = "k";
+        }
+
+        try
+        {
+            const auto result = std::format_to_n(
+                buffer.data(), buffer.size(), "site {} ({}, line {}) thrown {}{} times in 1 s",
+                throwSite.function_name(), throwSite.file_name(), throwSite.line(), count, unit);
+
+            return std::string_view(
+                buffer.data(), std::min(static_cast<size_t>(result.size), buffer.size()));
+        }
+        catch (std::exception&)
+        {
+            return std::string_view();
+        }
+    }
+
+    // rolls the rate window if it is over, and records a summary of a storm in the journal
+    static void CheckRate(SiteEntry& site, uint64_t throwSiteKey, int64_t now) noexcept
+    {
+        int64_t windowStart = site.windowStart.load(std::memory_order_relaxed);
+        if (now - windowStart < RATE_WINDOW.count()
+            || !site.windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        const uint64_t total = SumCounts(site);
+        const uint64_t base = site.windowBaseCount.exchange(total, std::memory_order_relaxed);
+        const uint64_t ratePerSecond = CalculateRatePerSecond(
+            total - base, std::chrono::steady_clock::duration(now - windowStart));
+
+        const bool isStorming = ratePerSecond >= s_stormThreshold.load(std::memory_order_relaxed);
+        site.ratePerSecond.store(ratePerSecond, std::memory_order_relaxed);
+        site.isStorming.store(isStorming, std::memory_order_relaxed);
+
+        // one line per window stands for all the throws not journaled meanwhile
+        if (isStorming && ExceptionJournalScope::IsActive())
+        {
+            char buffer[ExceptionJournalScope::MaxMessageLength];
+            ExceptionJournalScope::Append(
+                FormatSummary(site.throwSite, ratePerSecond, buffer), throwSiteKey);
+        }
+    }
+
+    bool ThrowSiteStatistics::Record(const std::source_location& throwSite, uint64_t throwSiteKey) noexcept
+    {
+        SiteEntry* site = FindOrInsertSite(ToTableKey(throwSiteKey), throwSite);
+        if (site == nullptr)
+        {
+            s_overflowCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const uint32_t stripeIndex = GetCurrentProcessorNumber() % STRIPE_COUNT;
+        const uint64_t stripeCount =
+            s_stripes[stripeIndex].counts[GetIndex(*site)].fetch_add(1, std::memory_order_relaxed) + 1;
+
+        // while storming, check on every throw in order to notice when it is over
+        const bool wasStorming = site->isStorming.load(std::memory_order_relaxed);
+        if (wasStorming || stripeCount % RATE_CHECK_PERIOD == 0)
+        {
+            CheckRate(*site, throwSiteKey, GetSteadyTicks());
+        }
+
+        if (!site->isStorming.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        s_throttledCounts[stripeIndex].value.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::vector<ThrowSiteStatistics::Site> ThrowSiteStatistics::GetTopSites(size_t count)
+    {
+        const int64_t now = GetSteadyTicks();
+        const uint64_t stormThreshold = s_stormThreshold.load(std::memory_order_relaxed);
+
+        std::vector<Site> sites;
+        for (const SiteEntry& entry : s_sites)
+        {
+            if (!entry.isReady.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+
+            Site& site = sites.emplace_back();
+            site.throwSiteKey = entry.key.load(std::memory_order_relaxed);
+            site.throwSite = entry.throwSite;
+            site.totalCount = SumCounts(entry);
+            site.ratePerSecond = entry.ratePerSecond.load(std::memory_order_relaxed);
+            site.isStorming = entry.isStorming.load(std::memory_order_relaxed);
+
+            // when a window is over but nobody rolled it, measure what it has so far
+            const int64_t windowStart = entry.windowStart.load(std::memory_order_relaxed);
+            if (now - windowStart >= RATE_WINDOW.count())
+            {
+                site.ratePerSecond = CalculateRatePerSecond(
+                    site.totalCount - entry.windowBaseCount.load(std::memory_order_relaxed),
+                    std::chrono::steady_clock::duration(now - windowStart));
+
+                site.isStorming = site.ratePerSecond >= stormThreshold;
+            }
+        }
+
+        std::sort(sites.begin(), sites.end(), [](const Site& left, const Site& right)
+        {
+            return left.ratePerSecond != right.ratePerSecond
+                ? left.ratePerSecond > right.ratePerSecond
+                : left.totalCount > right.totalCount;
+        });
+
+        sites.resize(std::min(count, sites.size()));
+        return sites;
+    }
+
+    bool ThrowSiteStatistics::IsStorming(uint64_t throwSiteKey) noexcept
+    {
+        const SiteEntry* site = FindSite(ToTableKey(throwSiteKey));
+        return site != nullptr && site->isStorming.load(std::memory_order_relaxed);
+    }
+
+    void ThrowSiteStatistics::SetStormThreshold(uint64_t throwsPerSecond) noexcept
+    {
+        s_stormThreshold.store(throwsPerSecond, std::memory_order_relaxed);
+    }
+
+    uint64_t ThrowSiteStatistics::GetOverflowCount() noexcept
+    {
+        return s_overflowCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t ThrowSiteStatistics::GetThrottledCount() noexcept
+    {
+        uint64_t total = 0;
+        for (const PaddedCounter& counter : s_throttledCounts)
+        {
+            total += counter.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    std::string ThrowSiteStatistics::Site::Summarize() const
+    {
+        char buffer[512];
+        return std::string(FormatSummary(throwSite, ratePerSecond, buffer));
+    }
+}
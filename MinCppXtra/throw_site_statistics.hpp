@@ -0,0 +1,104 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cinttypes>
+#include <source_location>
+#include <string>
+#include <vector>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Counts how many times each throw site creates a mincpp::TraceableException.
+	/// Counters live in a fixed table that takes no locks, and they are striped per
+	/// processor so that hot sites do not bounce cache lines between cores. Sites
+	/// whose rate exceeds a threshold are flagged as being in an exception storm.
+	/// </summary>
+	class ThrowSiteStatistics
+	{
+	public:
+
+		/// <summary>
+		/// How many distinct throw sites can be counted.
+		/// </summary>
+		static constexpr size_t Capacity = 512;
+
+		/// <summary>
+		/// Default rate (throws per second) from which a site is in a storm.
+		/// </summary>
+		static constexpr uint64_t DefaultStormThreshold = 1000;
+
+		/// <summary>
+		/// The statistics of a throw site.
+		/// </summary>
+		struct Site
+		{
+			uint64_t throwSiteKey;
+			std::source_location throwSite;
+			uint64_t totalCount;
+
+			/// <summary>
+			/// How many times it threw in the last whole second measured.
+			/// </summary>
+			uint64_t ratePerSecond;
+
+			bool isStorming;
+
+			/// <summary>
+			/// Summarizes the site in a single line, such as for reporting a storm.
+			/// </summary>
+			/// <returns>A line of text without line break.</returns>
+			std::string Summarize() const;
+		};
+
+		/// <summary>
+		/// Counts a throw. (It is done by mincpp::TraceableException already.)
+		/// </summary>
+		/// <param name="throwSite">Where in source code the exception is thrown.</param>
+		/// <param name="throwSiteKey">The key for the throw site.</param>
+		/// <returns>Whether the site is in a storm, in which case it should be throttled.</returns>
+		static bool Record(const std::source_location& throwSite, uint64_t throwSiteKey) noexcept;
+
+		/// <summary>
+		/// Gets the sites that threw the most.
+		/// </summary>
+		/// <param name="count">How many sites to get at most.</param>
+		/// <returns>The statistics of the sites, sorted by descending rate and then total.</returns>
+		static std::vector<Site> GetTopSites(size_t count);
+
+		/// <summary>
+		/// Tells whether a throw site is in a storm.
+		/// </summary>
+		/// <param name="throwSiteKey">The key for the throw site.</param>
+		static bool IsStorming(uint64_t throwSiteKey) noexcept;
+
+		/// <summary>
+		/// Sets the rate (throws per second) from which a site is in a storm.
+		/// </summary>
+		/// <param name="throwsPerSecond">The threshold.</param>
+		static void SetStormThreshold(uint64_t throwsPerSecond) noexcept;
+
+		/// <summary>
+		/// Gets how many throws were not counted because the table was full.
+		/// </summary>
+		static uint64_t GetOverflowCount() noexcept;
+
+		/// <summary>
+		/// Gets how many throws were throttled because their site was in a storm.
+		/// </summary>
+		static uint64_t GetThrottledCount() noexcept;
+	};
+}
@@ -0,0 +1,300 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "throw_tracing_scope.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <mutex>
+
+// (exported by the C++ runtime of msvc) the record of the exception handled by the current thread
+extern "C" void** __cdecl __current_exception();
+
+namespace mincpp
+{
+    // code of the SEH exception that MSVC raises for every C++ throw
+    static constexpr DWORD MSVC_CPP_EXCEPTION_CODE = 0xE06D7363;
+
+    struct ThrowRecord
+    {
+        // odd while written, then 2 more than twice the ticket of the throw (zero when never written)
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> scopeGeneration;
+        std::atomic<const void*> exceptionObject;
+        std::atomic<const void*> throwInfo;
+        RawStackTrace trace;
+    };
+
+    // storage is fixed and shared by all threads, so that capturing upon throw neither locks nor allocates,
+    // yet an exception can be looked up in whatever thread it ends up
+    static constexpr uint32_t THROW_RECORD_CAPACITY = 128;
+    static ThrowRecord s_throwRecords[THROW_RECORD_CAPACITY];
+    static std::atomic<uint64_t> s_throwTicketCount;
+
+    // odd while scopes are active, and changed whenever the first one starts or the last one ends,
+    // so that records from other periods are not taken for exceptions that reuse their addresses
+    static std::atomic<uint64_t> s_scopeGeneration;
+
+    static void WriteThrowRecord(
+        const void* exceptionObject,
+        const void* throwInfo,
+        const RawStackTrace& trace) noexcept
+    {
+        const uint64_t ticket = s_throwTicketCount.fetch_add(1, std::memory_order_relaxed);
+        ThrowRecord& record = s_throwRecords[ticket % THROW_RECORD_CAPACITY];
+
+        // once the ring wraps, a slow writer might meet a newer one in the same slot:
+        // the slot is claimed by only one of them, and never by an older throw
+        uint64_t sequence = record.sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) != 0
+            || sequence > 2 * ticket
+            || !record.sequence.compare_exchange_strong(sequence, 2 * ticket + 1, std::memory_order_relaxed))
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        record.scopeGeneration.store(s_scopeGeneration.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        record.exceptionObject.store(exceptionObject, std::memory_order_relaxed);
+        record.throwInfo.store(throwInfo, std::memory_order_relaxed);
+        record.trace = trace;
+        record.sequence.store(2 * ticket + 2, std::memory_order_release);
+    }
+
+    struct ThrowInspection
+    {
+        bool isActive;
+        const void* exceptionObject;
+        const void* throwInfo;
+    };
+
+    // when active, a throw in this thread is only inspected rather than recorded
+    static thread_local ThrowInspection t_throwInspection;
+
+    template <typename Predicate>
+    static std::optional<RawStackTrace> FindMostRecentTrace(Predicate matches)
+    {
+        const uint64_t scopeGeneration = s_scopeGeneration.load(std::memory_order_acquire);
+        if ((scopeGeneration & 1) == 0)
+        {
+            return std::nullopt;
+        }
+
+        const uint64_t ticketCount = s_throwTicketCount.load(std::memory_order_acquire);
+        const uint64_t count = std::min<uint64_t>(ticketCount, THROW_RECORD_CAPACITY);
+        for (uint64_t idx = 0; idx < count; ++idx)
+        {
+            const uint64_t ticket = ticketCount - 1 - idx;
+            const ThrowRecord& record = s_throwRecords[ticket % THROW_RECORD_CAPACITY];
+
+            // skip the slot when it is being written, or holds another throw
+            const uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * ticket + 2
+                || record.scopeGeneration.load(std::memory_order_relaxed) != scopeGeneration
+                || !matches(record.exceptionObject.load(std::memory_order_relaxed),
+                            record.throwInfo.load(std::memory_order_relaxed)))
+            {
+                continue;
+            }
+
+            // the copy is only good if no writer has claimed the slot meanwhile
+            const RawStackTrace trace = record.trace;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (record.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                return trace;
+            }
+        }
+        return std::nullopt;
+    }
+
+    class ThrowTracingScope::Impl
+    {
+    private:
+
+        static std::mutex s_registrationMutex;
+        static uint32_t s_registrationCount;
+        static PVOID s_handlerHandle;
+
+        static LONG CALLBACK OnException(EXCEPTION_POINTERS* exceptionPointers)
+        {
+            const EXCEPTION_RECORD* exRecord = exceptionPointers->ExceptionRecord;
+            if (exRecord->ExceptionCode != MSVC_CPP_EXCEPTION_CODE
+                || exRecord->NumberParameters < 3)
+            {
+                return EXCEPTION_CONTINUE_SEARCH;
+            }
+
+            const auto exceptionObject =
+                reinterpret_cast<const void*>(exRecord->ExceptionInformation[1]);
+            const auto throwInfo =
+                reinterpret_cast<const void*>(exRecord->ExceptionInformation[2]);
+
+            // rethrow ("throw;") keeps the trace from the original throw
+            if (exceptionObject == nullptr)
+            {
+                return EXCEPTION_CONTINUE_SEARCH;
+            }
+
+            if (t_throwInspection.isActive)
+            {
+                t_throwInspection.exceptionObject = exceptionObject;
+                t_throwInspection.throwInfo = throwInfo;
+                return EXCEPTION_CONTINUE_SEARCH;
+            }
+
+            RawStackTrace trace;
+            CallStack::Capture(trace);
+            WriteThrowRecord(exceptionObject, throwInfo, trace);
+            return EXCEPTION_CONTINUE_SEARCH;
+        }
+
+    public:
+
+        Impl()
+        {
+            std::lock_guard<std::mutex> lock(s_registrationMutex);
+            if (s_registrationCount++ == 0)
+            {
+                s_scopeGeneration.fetch_add(1, std::memory_order_release);
+                s_handlerHandle = AddVectoredExceptionHandler(TRUE, &OnException);
+            }
+        }
+
+        ~Impl()
+        {
+            std::lock_guard<std::mutex> lock(s_registrationMutex);
+            if (--s_registrationCount == 0)
+            {
+                RemoveVectoredExceptionHandler(s_handlerHandle);
+                s_handlerHandle = nullptr;
+                s_scopeGeneration.fetch_add(1, std::memory_order_release);
+            }
+        }
+    };
+
+    std::mutex ThrowTracingScope::Impl::s_registrationMutex;
+    uint32_t ThrowTracingScope::Impl::s_registrationCount = 0;
+    PVOID ThrowTracingScope::Impl::s_handlerHandle = nullptr;
+
+    ThrowTracingScope::ThrowTracingScope()
+        : m_pimpl(std::make_unique<ThrowTracingScope::Impl>())
+    {
+    }
+
+    ThrowTracingScope::~ThrowTracingScope() = default;
+
+    /// <summary>
+    /// Gets the record of the C++ exception handled by the current thread, if any.
+    /// </summary>
+    static const EXCEPTION_RECORD* GetCurrentCppExceptionRecord() noexcept
+    {
+        const auto exRecord = static_cast<const EXCEPTION_RECORD*>(*__current_exception());
+        if (exRecord != nullptr
+            && exRecord->ExceptionCode == MSVC_CPP_EXCEPTION_CODE
+            && exRecord->NumberParameters >= 3)
+        {
+            return exRecord;
+        }
+        return nullptr;
+    }
+
+    /// <summary>
+    /// Finds the trace of the throw of an object whose type is also known,
+    /// because its address alone might have been used by an earlier exception.
+    /// </summary>
+    static std::optional<RawStackTrace> FindExactTrace(const void* exceptionObject, const void* throwInfo)
+    {
+        return FindMostRecentTrace([exceptionObject, throwInfo](const void* recordObject, const void* recordThrowInfo)
+        {
+            return recordObject == exceptionObject && recordThrowInfo == throwInfo;
+        });
+    }
+
+    std::optional<RawStackTrace> ThrowTracingScope::FindTrace(const void* exceptionObject)
+    {
+        // when that is the object being handled, its type is known too
+        const EXCEPTION_RECORD* exRecord = GetCurrentCppExceptionRecord();
+        if (exRecord != nullptr
+            && reinterpret_cast<const void*>(exRecord->ExceptionInformation[1]) == exceptionObject)
+        {
+            return FindExactTrace(exceptionObject, reinterpret_cast<const void*>(exRecord->ExceptionInformation[2]));
+        }
+
+        return FindMostRecentTrace([exceptionObject](const void* recordObject, const void*)
+        {
+            return recordObject == exceptionObject;
+        });
+    }
+
+    std::optional<ThrowTrace> ThrowTracingScope::FindTrace(const std::exception_ptr& exception)
+    {
+        if (!exception)
+        {
+            return std::nullopt;
+        }
+
+        // rethrow only to learn which object is held and what its type is
+        t_throwInspection = { true, nullptr, nullptr };
+        try
+        {
+            std::rethrow_exception(exception);
+        }
+        catch (...)
+        {
+        }
+        const ThrowInspection inspection = t_throwInspection;
+        t_throwInspection = {};
+
+        if (inspection.exceptionObject == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        if (auto rawTrace = FindExactTrace(inspection.exceptionObject, inspection.throwInfo))
+        {
+            return ThrowTrace{ *rawTrace, false };
+        }
+
+        auto rawTrace = FindMostRecentTrace([&inspection](const void*, const void* recordThrowInfo)
+        {
+            return recordThrowInfo == inspection.throwInfo;
+        });
+
+        if (rawTrace)
+        {
+            return ThrowTrace{ *rawTrace, true };
+        }
+        return std::nullopt;
+    }
+
+    std::optional<ThrowTrace> ThrowTracingScope::FindCurrentExceptionTrace()
+    {
+        // the object being handled is the one thrown, unlike the copy in std::exception_ptr
+        const EXCEPTION_RECORD* exRecord = GetCurrentCppExceptionRecord();
+        if (exRecord != nullptr)
+        {
+            auto rawTrace = FindExactTrace(
+                reinterpret_cast<const void*>(exRecord->ExceptionInformation[1]),
+                reinterpret_cast<const void*>(exRecord->ExceptionInformation[2]));
+            if (rawTrace)
+            {
+                return ThrowTrace{ *rawTrace, false };
+            }
+        }
+
+        return FindTrace(std::current_exception());
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include "call_stack.hpp"
+
+#include <exception>
+#include <memory>
+#include <optional>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Holds the raw call stack trace found for a thrown exception.
+	/// </summary>
+	struct ThrowTrace
+	{
+		RawStackTrace rawTrace;
+
+		/// <summary>
+		/// Whether it was found by the type of the exception only, hence it might belong
+		/// to another exception of the same type (because std::exception_ptr might hold
+		/// a copy of the thrown object).
+		/// </summary>
+		bool isApproximate;
+	};
+
+	/// <summary>
+	/// Creates a scope where the call stack is captured whenever any C++ exception
+	/// is thrown (not only mincpp::TraceableException), so that it can be retrieved
+	/// at the catch site, in any thread. Only raw addresses are captured upon throw,
+	/// into a fixed process-wide ring of the most recent throws, and symbols are
+	/// resolved when the trace is retrieved. Once the last scope ends, the traces recorded
+	/// so far are no longer found (even if scopes start again later).
+	/// </summary>
+	class ThrowTracingScope
+	{
+	private:
+
+		class Impl;
+		std::unique_ptr<Impl> m_pimpl;
+
+	public:
+
+		/// <summary>
+		/// Creates the scope.
+		/// </summary>
+		ThrowTracingScope();
+
+		~ThrowTracingScope();
+
+		/// <summary>
+		/// Finds the trace captured when an exception was thrown (in any thread).
+		/// If that is the exception currently handled, its type must match too,
+		/// since thrown objects can reuse the addresses of earlier ones.
+		/// </summary>
+		/// <param name="exceptionObject">
+		/// The address of the thrown object, as seen when catching it by reference.
+		/// </param>
+		/// <returns>The raw call stack trace, if still available.</returns>
+		static std::optional<RawStackTrace> FindTrace(const void* exceptionObject);
+
+		/// <summary>
+		/// Finds the trace captured when an exception was thrown (in any thread).
+		/// Because std::exception_ptr might hold a copy of the thrown object,
+		/// the most recent trace for an exception of the same type is the fallback,
+		/// which is then flagged as approximate.
+		/// </summary>
+		/// <param name="exception">The exception.</param>
+		/// <returns>The raw call stack trace, if still available.</returns>
+		static std::optional<ThrowTrace> FindTrace(const std::exception_ptr& exception);
+
+		/// <summary>
+		/// Finds the trace captured when the exception currently handled was thrown.
+		/// (It is only approximate when the exception has been rethrown from a std::exception_ptr.)
+		/// </summary>
+		/// <returns>The raw call stack trace, if still available.</returns>
+		static std::optional<ThrowTrace> FindCurrentExceptionTrace();
+	};
+}
@@ -0,0 +1,194 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "internal/stage_timer.h"
+#include "trace_metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace mincpp
+{
+    // values below 2^SUB_BUCKET_BITS get a bucket each, then every power of 2
+    // is split in 2^SUB_BUCKET_BITS buckets (hence a relative error of 12.5%)
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr uint32_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    static constexpr uint32_t ToBucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKET_COUNT)
+        {
+            return static_cast<uint32_t>(value);
+        }
+
+        const uint32_t exponent = 63 - std::countl_zero(value);
+        const uint32_t shift = exponent - SUB_BUCKET_BITS;
+        return (shift + 1) * SUB_BUCKET_COUNT
+            + static_cast<uint32_t>((value >> shift) & (SUB_BUCKET_COUNT - 1));
+    }
+
+    static constexpr uint64_t GetBucketUpperBound(uint32_t index)
+    {
+        if (index < SUB_BUCKET_COUNT)
+        {
+            return index;
+        }
+
+        const uint32_t shift = index / SUB_BUCKET_COUNT - 1;
+        const uint64_t lowerBound = (SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) * (1ULL << shift);
+        return lowerBound + ((1ULL << shift) - 1);
+    }
+
+    static_assert(ToBucketIndex(UINT64_MAX) == BUCKET_COUNT - 1);
+    static_assert(GetBucketUpperBound(ToBucketIndex(1000)) >= 1000);
+    static_assert(GetBucketUpperBound(ToBucketIndex(1000) - 1) < 1000);
+
+    struct MetricHistogram
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+        std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    };
+
+    static std::atomic<bool> s_isEnabled;
+    static MetricHistogram s_histograms[static_cast<size_t>(TraceMetric::Count)];
+
+    // the timestamp counter is calibrated against the steady clock since startup
+    static const uint64_t s_calibrationTicks = __rdtsc();
+    static const auto s_calibrationTime = std::chrono::steady_clock::now();
+
+    static double GetNanosecondsPerTick()
+    {
+        const uint64_t ticks = __rdtsc() - s_calibrationTicks;
+        const std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - s_calibrationTime;
+
+        return ticks != 0 ? elapsed.count() / ticks : 1.0;
+    }
+
+    static bool IsDuration(TraceMetric metric)
+    {
+        return metric == TraceMetric::CaptureNanoseconds
+            || metric == TraceMetric::ResolveNanoseconds
+            || metric == TraceMetric::RenderNanoseconds
+            || metric == TraceMetric::LockWaitNanoseconds;
+    }
+
+    void RecordTraceMetric(TraceMetric metric, uint64_t value) noexcept
+    {
+        MetricHistogram& histogram = s_histograms[static_cast<size_t>(metric)];
+        histogram.buckets[ToBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        histogram.count.fetch_add(1, std::memory_order_relaxed);
+        histogram.sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t max = histogram.max.load(std::memory_order_relaxed);
+        while (value > max
+            && !histogram.max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void TraceMetrics::Enable(bool enable) noexcept
+    {
+        s_isEnabled.store(enable, std::memory_order_relaxed);
+    }
+
+    bool TraceMetrics::IsEnabled() noexcept
+    {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    TraceMetricHistogram TraceMetrics::GetHistogram(TraceMetric metric)
+    {
+        const MetricHistogram& histogram = s_histograms[static_cast<size_t>(metric)];
+        const double scale = IsDuration(metric) ? GetNanosecondsPerTick() : 1.0;
+        auto convert = [scale](uint64_t value)
+        {
+            return static_cast<uint64_t>(std::llround(value * scale));
+        };
+
+        TraceMetricHistogram result{};
+        result.count = histogram.count.load(std::memory_order_relaxed);
+        result.sum = convert(histogram.sum.load(std::memory_order_relaxed));
+        result.max = convert(histogram.max.load(std::memory_order_relaxed));
+
+        for (uint32_t idx = 0; idx < BUCKET_COUNT; ++idx)
+        {
+            const uint64_t count = histogram.buckets[idx].load(std::memory_order_relaxed);
+            if (count != 0)
+            {
+                result.buckets.push_back({ convert(GetBucketUpperBound(idx)), count });
+            }
+        }
+
+        return result;
+    }
+
+    std::string_view TraceMetrics::GetName(TraceMetric metric) noexcept
+    {
+        switch (metric)
+        {
+        case TraceMetric::CaptureNanoseconds:
+            return "capture_ns";
+        case TraceMetric::FramesWalked:
+            return "frames_walked";
+        case TraceMetric::FramesResolved:
+            return "frames_resolved";
+        case TraceMetric::ResolveNanoseconds:
+            return "resolve_ns";
+        case TraceMetric::RenderNanoseconds:
+            return "render_ns";
+        case TraceMetric::BytesRendered:
+            return "bytes_rendered";
+        case TraceMetric::LockWaitNanoseconds:
+            return "lock_wait_ns";
+        default:
+            return "unknown";
+        }
+    }
+
+    void TraceMetrics::Reset() noexcept
+    {
+        for (MetricHistogram& histogram : s_histograms)
+        {
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.sum.store(0, std::memory_order_relaxed);
+            histogram.max.store(0, std::memory_order_relaxed);
+            for (auto& bucket : histogram.buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint64_t TraceMetricHistogram::GetPercentile(double percentile) const
+    {
+        const auto rank = static_cast<uint64_t>(std::ceil(count * percentile / 100.0));
+        uint64_t cumulativeCount = 0;
+        for (const Bucket& bucket : buckets)
+        {
+            cumulativeCount += bucket.count;
+            if (cumulativeCount >= rank)
+            {
+                return std::min(bucket.upperBound, max);
+            }
+        }
+        return max;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <cinttypes>
+#include <string_view>
+#include <vector>
+
+namespace mincpp
+{
+	/// <summary>
+	/// What is measured in the stages of producing a call stack trace
+	/// (including the wait for the lock that serializes stack walking).
+	/// </summary>
+	enum class TraceMetric : uint32_t
+	{
+		CaptureNanoseconds,
+		FramesWalked,
+		FramesResolved,
+		ResolveNanoseconds,
+		RenderNanoseconds,
+		BytesRendered,
+		LockWaitNanoseconds,
+		Count
+	};
+
+	/// <summary>
+	/// Distribution of the values measured for a metric.
+	/// </summary>
+	struct TraceMetricHistogram
+	{
+		struct Bucket
+		{
+			/// <summary>
+			/// The greatest value that falls in this bucket.
+			/// </summary>
+			uint64_t upperBound;
+
+			uint64_t count;
+		};
+
+		uint64_t count;
+		uint64_t sum;
+		uint64_t max;
+
+		/// <summary>
+		/// The buckets that are not empty, in ascending order.
+		/// </summary>
+		std::vector<Bucket> buckets;
+
+		/// <summary>
+		/// Estimates a percentile of the measured values.
+		/// </summary>
+		/// <param name="percentile">The percentile, between 0 and 100.</param>
+		/// <returns>The upper bound of the bucket where the percentile falls.</returns>
+		uint64_t GetPercentile(double percentile) const;
+	};
+
+	/// <summary>
+	/// Measures the stages of mincpp::CallStack (hence also of mincpp::TraceableException)
+	/// with timers based on the CPU timestamp counter, into log-linear histograms that
+	/// are updated without locks. While disabled, the cost is a relaxed load and a branch.
+	/// </summary>
+	class TraceMetrics
+	{
+	public:
+
+		/// <summary>
+		/// Enable/disable the measurements (disabled by default).
+		/// </summary>
+		/// <param name="enable">Whether the measurements should be taken.</param>
+		static void Enable(bool enable) noexcept;
+
+		/// <summary>
+		/// Tells whether the measurements are enabled.
+		/// </summary>
+		static bool IsEnabled() noexcept;
+
+		/// <summary>
+		/// Gets the distribution of the values measured for a metric so far.
+		/// </summary>
+		/// <param name="metric">The metric.</param>
+		/// <returns>A copy of the histogram (in nanoseconds for durations).</returns>
+		static TraceMetricHistogram GetHistogram(TraceMetric metric);
+
+		/// <summary>
+		/// Gets a short name for a metric, such as "capture_ns".
+		/// </summary>
+		/// <param name="metric">The metric.</param>
+		/// <returns>The name.</returns>
+		static std::string_view GetName(TraceMetric metric) noexcept;
+
+		/// <summary>
+		/// Discards all the measurements.
+		/// </summary>
+		static void Reset() noexcept;
+	};
+}
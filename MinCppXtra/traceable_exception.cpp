@@ -16,7 +16,11 @@
 
 #include "call_stack.hpp"
 #include "console.hpp"
+#include "exception_journal_scope.hpp"
+#include "memory_resource_scope.hpp"
+#include "throw_site_statistics.hpp"
 
+#include <mutex>
 #include <sstream>
 
 namespace mincpp
@@ -25,28 +29,88 @@ namespace mincpp
 	{
 	private:
 
-		std::string m_callStackTrace;
+		mutable std::string m_callStackTrace;
 		std::optional<std::exception> m_innerException;
+		std::source_location m_throwSite;
+		uint64_t m_throwSiteKey = 0; // zero when derived from the throw site
+
+		// call stack captured upon throw, whose symbols are resolved when first needed
+		std::optional<RawStackTrace> m_rawCallStack;
+		mutable std::shared_ptr<const void> m_callStackAccess;
+		mutable std::once_flag m_callStackResolution;
+
+		std::shared_ptr<const MessageFormatter> m_formatMessage;
+		std::string_view m_messageFormat;
+		mutable std::once_flag m_messageFormatting;
+		mutable std::string m_message;
+
+		std::array<Breadcrumb, BreadcrumbCount> m_breadcrumbs;
+		uint32_t m_breadcrumbCount = Breadcrumbs::CopyRecent(m_breadcrumbs);
+
+		// only captures addresses, so that a throw does not pay for symbol resolution
+		void CaptureCallStack()
+		{
+			m_rawCallStack.emplace();
+			CallStack::Capture(*m_rawCallStack);
+			m_callStackAccess = ShareCallStackAccess();
+		}
 
 	public:
 
-		Impl(std::optional<std::exception>&& innerException)
+		Impl(std::optional<std::exception>&& innerException,
+			const std::source_location& throwSite)
 			: m_innerException(innerException)
-			, m_callStackTrace(
-				CallStack::GetTrace(TraceableException::s_useColorsOnStackTrace))
+			, m_throwSite(throwSite)
+		{
+			CaptureCallStack();
+		}
+
+		Impl(std::shared_ptr<const MessageFormatter>&& formatMessage,
+			std::string_view messageFormat,
+			const std::source_location& throwSite)
+			: m_formatMessage(std::move(formatMessage))
+			, m_messageFormat(messageFormat)
+			, m_throwSite(throwSite)
 		{
+			CaptureCallStack();
 		}
 
-		Impl(const void* exceptionContextHandle, bool isStackTraceEnabled)
-			: m_callStackTrace(isStackTraceEnabled
-				? CallStack::GetTrace(
-					exceptionContextHandle, TraceableException::s_useColorsOnStackTrace)
-				: "(disabled in this build)")
+		Impl(const void* exceptionContextHandle,
+			bool isStackTraceEnabled,
+			uint64_t throwSiteKey,
+			const std::source_location& throwSite)
+			: m_throwSite(throwSite)
+			, m_throwSiteKey(throwSiteKey)
 		{
+			if (!isStackTraceEnabled)
+			{
+				m_callStackTrace = "(disabled in this build)";
+				return;
+			}
+
+			// only capture addresses now, because this runs upon a fault
+			m_rawCallStack.emplace();
+			CallStack::Capture(exceptionContextHandle, *m_rawCallStack);
+			m_callStackAccess = ShareCallStackAccess();
 		}
 
 		const std::string& GetCallStackTrace() const
 		{
+			if (m_rawCallStack)
+			{
+				std::call_once(m_callStackResolution, [this]()
+				{
+					// rendered in scratch memory of the thread, then copied in one allocation
+					const std::pmr::string trace = CallStack::GetTrace(
+						*m_rawCallStack,
+						MemoryResourceScope::GetResource(),
+						TraceableException::s_useColorsOnStackTrace);
+
+					m_callStackTrace.assign(trace.data(), trace.size());
+
+					m_callStackAccess.reset();
+				});
+			}
 			return m_callStackTrace;
 		}
 
@@ -54,6 +118,55 @@ namespace mincpp
 		{
 			return m_innerException;
 		}
+
+		const std::source_location& GetThrowSite() const
+		{
+			return m_throwSite;
+		}
+
+		uint64_t GetThrowSiteKey() const
+		{
+			return m_throwSiteKey;
+		}
+
+		std::span<const Breadcrumb> GetBreadcrumbs() const
+		{
+			return std::span<const Breadcrumb>(m_breadcrumbs.data(), m_breadcrumbCount);
+		}
+
+		const char* GetMessage(const char* eagerMessage) const
+		{
+			if (!m_formatMessage)
+			{
+				return eagerMessage;
+			}
+
+			try
+			{
+				// format only once, since all copies of the exception share this object
+				std::call_once(m_messageFormatting, [this]()
+				{
+					try
+					{
+						// formatted in scratch memory of the thread, then copied in one allocation
+						std::pmr::string message(MemoryResourceScope::GetResource());
+						m_formatMessage->Format(message);
+						m_message.assign(message.data(), message.size());
+					}
+					catch (std::exception&)
+					{
+						m_message.assign(m_messageFormat);
+					}
+				});
+
+				return m_message.c_str();
+			}
+			catch (...)
+			{
+				// what() must not throw (and the format string might not be terminated)
+				return eagerMessage;
+			}
+		}
 	};
 
 	bool TraceableException::s_useColorsOnStackTrace = false;
@@ -65,23 +178,65 @@ namespace mincpp
 
 	TraceableException::TraceableException(
 		const std::string& message,
-		std::optional<std::exception>&& innerException)
+		std::optional<std::exception>&& innerException,
+		const std::source_location& throwSite)
 		: std::runtime_error(message)
-		, m_pimpl(new Impl(std::move(innerException)))
+		, m_pimpl(std::make_shared<Impl>(std::move(innerException), throwSite))
+	{
+		RecordThrow(message);
+	}
+
+	TraceableException::TraceableException(
+		const std::string& message,
+		const void* exceptionContextHandle,
+		bool isStackTraceEnabled,
+		const std::source_location& throwSite)
+		: TraceableException(message, exceptionContextHandle, isStackTraceEnabled, 0, throwSite)
 	{
 	}
 
 	TraceableException::TraceableException(
 		const std::string& message,
 		const void* exceptionContextHandle,
-		bool isStackTraceEnabled)
+		bool isStackTraceEnabled,
+		uint64_t throwSiteKey,
+		const std::source_location& throwSite)
 		: std::runtime_error(message)
-		, m_pimpl(new Impl(exceptionContextHandle, isStackTraceEnabled))
+		, m_pimpl(std::make_shared<Impl>(exceptionContextHandle, isStackTraceEnabled, throwSiteKey, throwSite))
+	{
+		RecordThrow(message);
+	}
+
+	TraceableException::TraceableException(
+		std::shared_ptr<const MessageFormatter>&& formatMessage,
+		std::string_view messageFormat,
+		const std::source_location& throwSite)
+		: std::runtime_error("")
+		, m_pimpl(std::make_shared<Impl>(std::move(formatMessage), messageFormat, throwSite))
 	{
+		// (the format string stands for the message, which is not formatted yet)
+		RecordThrow(messageFormat);
+	}
+
+	void TraceableException::RecordThrow(std::string_view message) const
+	{
+		const uint64_t throwSiteKey = GetThrowSiteKey();
+		const bool isStorming = ThrowSiteStatistics::Record(GetThrowSite(), throwSiteKey);
+
+		// during a storm, the journal gets a summary per second rather than every throw
+		if (!isStorming && ExceptionJournalScope::IsActive())
+		{
+			ExceptionJournalScope::Append(message, throwSiteKey);
+		}
 	}
 
 	TraceableException::~TraceableException() = default;
 
+	const char* TraceableException::what() const noexcept
+	{
+		return m_pimpl->GetMessage(std::runtime_error::what());
+	}
+
 	const std::string& TraceableException::GetCallStackTrace() const
 	{
 		return m_pimpl->GetCallStackTrace();
@@ -92,6 +247,44 @@ namespace mincpp
 		return m_pimpl->GetInnerException();
 	}
 
+	const std::source_location& TraceableException::GetThrowSite() const
+	{
+		return m_pimpl->GetThrowSite();
+	}
+
+	std::span<const Breadcrumb> TraceableException::GetBreadcrumbs() const
+	{
+		return m_pimpl->GetBreadcrumbs();
+	}
+
+	static uint64_t HashFnv1a(std::string_view data, uint64_t hash)
+	{
+		for (unsigned char ch : data)
+		{
+			hash ^= ch;
+			hash *= 0x100000001b3ULL;
+		}
+		return hash;
+	}
+
+	uint64_t TraceableException::GetThrowSiteKey() const
+	{
+		if (m_pimpl->GetThrowSiteKey() != 0)
+		{
+			return m_pimpl->GetThrowSiteKey();
+		}
+
+		// hash only what does not vary between compilers or depend on the build machine
+		const std::source_location& throwSite = m_pimpl->GetThrowSite();
+		std::string_view fileName(throwSite.file_name());
+		fileName = fileName.substr(fileName.find_last_of("\\/") + 1);
+
+		const uint32_t position[] = { throwSite.line(), throwSite.column() };
+		uint64_t hash = HashFnv1a(fileName, 0xcbf29ce484222325ULL);
+		return HashFnv1a(
+			std::string_view(reinterpret_cast<const char*>(position), sizeof position), hash);
+	}
+
 	std::string_view TraceableException::GetTypeName() const
 	{
 		constexpr std::string_view prefix = "class ";
@@ -118,6 +311,26 @@ namespace mincpp
 				<< std::endl;
 		}
 
+		const std::source_location& throwSite = m_pimpl->GetThrowSite();
+		if (throwSite.line() != 0)
+		{
+			oss << Console::Color(s_useColorsOnStackTrace).BrightBlack()
+				<< "  thrown in " << throwSite.function_name() << std::endl
+				<< "  at " << throwSite.file_name()
+				<< ", line " << throwSite.line()
+				<< Console::Color(s_useColorsOnStackTrace).Reset()
+				<< std::endl;
+		}
+
+		if (!m_pimpl->GetBreadcrumbs().empty())
+		{
+			oss << "  breadcrumbs (oldest first):" << std::endl;
+			for (const Breadcrumb& breadcrumb : m_pimpl->GetBreadcrumbs())
+			{
+				oss << "    " << breadcrumb.label << " = " << breadcrumb.value << std::endl;
+			}
+		}
+
 		oss << "=== CALL STACK TRACE ===" << std::endl;
 		oss << m_pimpl->GetCallStackTrace() << std::endl;
 		return oss.str();
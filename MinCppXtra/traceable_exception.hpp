@@ -13,15 +13,78 @@
 
 #pragma once
 
+#include "breadcrumbs.hpp"
+
+#include <array>
+#include <cinttypes>
+#include <concepts>
+#include <format>
 #include <memory>
+#include <memory_resource>
+#include <source_location>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
 
 namespace mincpp
 {
+	/// <summary>
+	/// Tells whether a type can be used as argument for the deferred formatting of
+	/// an exception message (rather than being taken as an inner exception).
+	/// </summary>
+	/// Views and spans other than text are rejected, because the arguments outlive the throw frame.
+	/// Pointers other than text are rejected too, since they are taken as a stack context handle.
+	template <typename Arg>
+	concept MessageFormatArgument =
+		!std::is_base_of_v<std::exception, std::remove_cvref_t<Arg>>
+		&& !std::is_same_v<std::remove_cvref_t<Arg>, std::nullopt_t>
+		&& !std::is_same_v<std::remove_cvref_t<Arg>, std::optional<std::exception>>
+		&& !std::is_null_pointer_v<std::remove_cvref_t<Arg>>
+		&& (std::is_convertible_v<const Arg&, std::string_view>
+			|| (!std::is_pointer_v<std::decay_t<Arg>>
+				&& !std::ranges::borrowed_range<std::remove_cvref_t<Arg>>));
+
+	/// <summary>
+	/// The type an argument is kept as for the deferred formatting of an exception message:
+	/// text (such as std::string_view or a pointer to a stack buffer) is copied into a std::string.
+	/// </summary>
+	template <typename Arg>
+	using CapturedMessageArgument = std::conditional_t<
+		std::is_convertible_v<const Arg&, std::string_view>,
+		std::string,
+		std::decay_t<Arg>>;
+
+	/// <summary>
+	/// Format string for an exception message (checked at compile time),
+	/// along with the location in source code where the exception is thrown.
+	/// </summary>
+	template <typename... Args>
+	struct MessageFormat
+	{
+		std::format_string<Args...> format;
+		std::source_location throwSite;
+
+		template <typename Text>
+			requires std::convertible_to<const Text&, std::string_view>
+		consteval MessageFormat(
+			const Text& text,
+			std::source_location throwSite = std::source_location::current())
+			: format(text)
+			, throwSite(throwSite)
+		{
+		}
+	};
+
 	/// <summary>
 	/// Represents an exception with call stack trace.
+	/// Its internal storage is on the global heap, because the exception can outlive
+	/// the scope it is thrown from, but the scratch memory to format its message and
+	/// its call stack trace is drawn from the thread (see mincpp::MemoryResourceScope).
 	/// </summary>
 	class TraceableException : public std::runtime_error
 	{
@@ -34,6 +97,71 @@ namespace mincpp
 
 		virtual std::string_view GetTypeName() const final;
 
+		// formats the message into scratch memory drawn from mincpp::MemoryResourceScope
+		class MessageFormatter
+		{
+		public:
+
+			virtual ~MessageFormatter() = default;
+
+			virtual void Format(std::pmr::string& message) const = 0;
+		};
+
+		// keeps the arguments of the message
+		template <typename... CapturedArgs>
+		class MessageFormatterOf final : public MessageFormatter
+		{
+		private:
+
+			std::string_view m_format;
+			std::tuple<CapturedArgs...> m_args;
+
+		public:
+
+			template <typename... Args>
+			MessageFormatterOf(std::string_view format, Args&&... args)
+				: m_format(format)
+				, m_args(std::forward<Args>(args)...)
+			{
+			}
+
+			void Format(std::pmr::string& message) const override
+			{
+				std::apply([this, &message](const CapturedArgs&... args)
+				{
+					std::vformat_to(std::back_inserter(message), m_format, std::make_format_args(args...));
+				}, m_args);
+			}
+		};
+
+		template <typename... Args>
+		static std::shared_ptr<const MessageFormatter> MakeMessageFormatter(std::string_view format, Args&&... args)
+		{
+			return std::make_shared<MessageFormatterOf<CapturedMessageArgument<Args>...>>(
+				format,
+				std::forward<Args>(args)...);
+		}
+
+		TraceableException(
+			std::shared_ptr<const MessageFormatter>&& formatMessage,
+			std::string_view messageFormat,
+			const std::source_location& throwSite);
+
+		void RecordThrow(std::string_view message) const;
+
+	protected:
+
+		/// <summary>
+		/// Creates a new instance from a stack context, whose throw site is identified
+		/// by the given key rather than by the source location (such as a fault address).
+		/// </summary>
+		TraceableException(
+			const std::string& message,
+			const void* exceptionContextHandle,
+			bool isStackTraceEnabled,
+			uint64_t throwSiteKey,
+			const std::source_location& throwSite);
+
 	public:
 
 		/// <summary>
@@ -47,9 +175,11 @@ namespace mincpp
 		/// </summary>
 		/// <param name="message">The exception message.</param>
 		/// <param name="innerException">The inner/preceding exception.</param>
+		/// <param name="throwSite">Where in source code the exception is thrown.</param>
 		TraceableException(
 			const std::string& message,
-			std::optional<std::exception>&& innerException = std::nullopt);
+			std::optional<std::exception>&& innerException = std::nullopt,
+			const std::source_location& throwSite = std::source_location::current());
 
 		/// <summary>
 		/// Creates a new instance.
@@ -61,16 +191,43 @@ namespace mincpp
 		/// <param name="isStackTraceEnabled">
 		/// Whether the implementation is allowed to walk the call stack to produce a trace.
 		/// </param>
+		/// <param name="throwSite">Where in source code the exception is thrown.</param>
 		TraceableException(
 			const std::string& message,
 			const void* exceptionContextHandle,
-			bool isStackTraceEnabled = true);
+			bool isStackTraceEnabled = true,
+			const std::source_location& throwSite = std::source_location::current());
+
+		/// <summary>
+		/// Creates a new instance whose message is only formatted when first needed.
+		/// The arguments are kept in the exception, so a throw whose message is never
+		/// read does not pay for formatting.
+		/// </summary>
+		/// <param name="messageFormat">
+		/// The format string for the exception message (checked at compile time).
+		/// It also records where in source code the exception is thrown.
+		/// </param>
+		/// <param name="args">The arguments to format the message with.</param>
+		template <MessageFormatArgument... Args>
+		TraceableException(MessageFormat<std::type_identity_t<Args>...> messageFormat, Args&&... args)
+			: TraceableException(
+				MakeMessageFormatter(messageFormat.format.get(), std::forward<Args>(args)...),
+				messageFormat.format.get(),
+				messageFormat.throwSite)
+		{
+		}
 
 		virtual ~TraceableException();
 
+		/// <summary>
+		/// Gets the exception message, which is formatted upon first call when deferred.
+		/// </summary>
+		/// <returns>The exception message.</returns>
+		const char* what() const noexcept override;
+
 		/// <summary>
 		/// Gets the trace of the all stack when the exception was thrown.
-		/// (It requires the loading of debug symbols.)
+		/// (It requires the loading of debug symbols, which are only resolved upon first call.)
 		/// </summary>
 		/// <returns>The call stack trace encoded in UTF-8.</returns>
 		const std::string& GetCallStackTrace() const;
@@ -81,6 +238,33 @@ namespace mincpp
 		/// <returns>The inner exception, if available.</returns>
 		const std::optional<std::exception>& GetInnerException() const;
 
+		/// <summary>
+		/// Gets where in source code the exception has been thrown.
+		/// (It is available even when debug symbols are not.)
+		/// </summary>
+		/// <returns>The source location of the throw site.</returns>
+		const std::source_location& GetThrowSite() const;
+
+		/// <summary>
+		/// Gets a key that identifies the throw site, which is stable across
+		/// runs of the same build. It is suitable for aggregation of exceptions.
+		/// (Subclasses must forward the throw site of their callers, or else they all share the same key.)
+		/// </summary>
+		/// <returns>A hash of the throw site.</returns>
+		uint64_t GetThrowSiteKey() const;
+
+		/// <summary>
+		/// How many of the most recent breadcrumbs of the throwing thread are kept.
+		/// </summary>
+		static constexpr uint32_t BreadcrumbCount = 8;
+
+		/// <summary>
+		/// Gets the breadcrumbs left by the throwing thread before the exception
+		/// was created (see MINCPP_BREADCRUMB).
+		/// </summary>
+		/// <returns>The most recent breadcrumbs, oldest first.</returns>
+		std::span<const Breadcrumb> GetBreadcrumbs() const;
+
 		/// <summary>
 		/// Serializes this exception into a text representation.
 		/// </summary>
@@ -0,0 +1,216 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "transcoding_streams.hpp"
+#include "internal/utf_kernels.h"
+
+#include <algorithm>
+
+namespace mincpp
+{
+    namespace
+    {
+        bool IsLeadSurrogate(wchar_t codeUnit) noexcept
+        {
+            return codeUnit >= 0xD800 && codeUnit <= 0xDBFF;
+        }
+    }
+
+    Utf16ToUtf8Stream::Utf16ToUtf8Stream() noexcept
+    {
+        Reset();
+    }
+
+    TranscodingProgress Utf16ToUtf8Stream::Transcode(std::wstring_view chunk, std::span<char> output) noexcept
+    {
+        if (m_isInvalid)
+            return { 0, 0, true };
+
+        const wchar_t* const input = chunk.data();
+        size_t read = 0;
+        size_t written = 0;
+
+        // complete the surrogate pair split by the previous chunk
+        if (m_hasPendingLead)
+        {
+            if (chunk.empty())
+                return { 0, 0, false };
+
+            const wchar_t pair[2] = { static_cast<wchar_t>(m_pendingLead), input[0] };
+            const TranscodingResult result = TranscodeWideToUtf8(pair, 2, output.data(), output.size());
+            if (result.isInvalid)
+            {
+                m_isInvalid = true;
+                return { 0, 0, true };
+            }
+
+            if (result.read < 2)
+                return { 0, 0, false };
+
+            m_position += 2;
+            m_hasPendingLead = false;
+            read = 1;
+            written = result.written;
+        }
+
+        // hold back a lead surrogate at the end, whose trail is yet to come (only in UTF-16)
+        const size_t tailLength =
+            (IsWideCharUtf16 && read < chunk.length() && IsLeadSurrogate(input[chunk.length() - 1])) ? 1 : 0;
+        const size_t bodyLength = chunk.length() - read - tailLength;
+        const TranscodingResult result = TranscodeWideToUtf8(
+            input + read, bodyLength, output.data() + written, output.size() - written);
+
+        read += result.read;
+        written += result.written;
+        m_position += result.read;
+        if (result.isInvalid)
+        {
+            m_isInvalid = true;
+            return { read, written, true };
+        }
+
+        // output is full
+        if (result.read < bodyLength)
+            return { read, written, false };
+
+        if (tailLength != 0)
+        {
+            m_pendingLead = static_cast<char16_t>(input[read]);
+            m_hasPendingLead = true;
+            read += tailLength;
+        }
+        return { read, written, false };
+    }
+
+    bool Utf16ToUtf8Stream::Finish() noexcept
+    {
+        if (m_hasPendingLead)
+            m_isInvalid = true;
+
+        return !m_isInvalid;
+    }
+
+    uint64_t Utf16ToUtf8Stream::GetPosition() const noexcept
+    {
+        return m_position;
+    }
+
+    void Utf16ToUtf8Stream::Reset() noexcept
+    {
+        m_position = 0;
+        m_pendingLead = 0;
+        m_hasPendingLead = false;
+        m_isInvalid = false;
+    }
+
+    Utf8ToUtf16Stream::Utf8ToUtf16Stream() noexcept
+    {
+        Reset();
+    }
+
+    TranscodingProgress Utf8ToUtf16Stream::Transcode(std::string_view chunk, std::span<wchar_t> output) noexcept
+    {
+        if (m_isInvalid)
+            return { 0, 0, true };
+
+        wchar_t* const wide = output.data();
+        size_t read = 0;
+        size_t written = 0;
+
+        // complete the sequence split by the previous chunk
+        if (m_pendingCount != 0)
+        {
+            const size_t sequenceLength = GetUtf8SequenceLength(m_pendingBytes[0]);
+            const size_t missing = sequenceLength - m_pendingCount;
+            const size_t available = std::min(missing, chunk.length());
+            char sequence[4];
+            std::copy_n(m_pendingBytes, m_pendingCount, sequence);
+            std::copy_n(chunk.data(), available, sequence + m_pendingCount);
+
+            if (available < missing)
+            {
+                // still incomplete, unless already invalid
+                const size_t present = m_pendingCount + available;
+                if (MeasureIncompleteUtf8Tail(sequence, present) != present)
+                {
+                    m_isInvalid = true;
+                    return { 0, 0, true };
+                }
+
+                std::copy_n(sequence, present, m_pendingBytes);
+                m_pendingCount = static_cast<uint8_t>(present);
+                return { available, 0, false };
+            }
+
+            const TranscodingResult result = TranscodeUtf8ToWide(sequence, sequenceLength, wide, output.size());
+            if (result.isInvalid)
+            {
+                m_isInvalid = true;
+                return { 0, 0, true };
+            }
+
+            if (result.read < sequenceLength)
+                return { 0, 0, false };
+
+            m_position += sequenceLength;
+            m_pendingCount = 0;
+            read = missing;
+            written = result.written;
+        }
+
+        // hold back a sequence at the end, whose remaining bytes are yet to come
+        const size_t tailLength = MeasureIncompleteUtf8Tail(chunk.data() + read, chunk.length() - read);
+        const size_t bodyLength = chunk.length() - read - tailLength;
+        const TranscodingResult result = TranscodeUtf8ToWide(
+            chunk.data() + read, bodyLength, wide + written, output.size() - written);
+
+        read += result.read;
+        written += result.written;
+        m_position += result.read;
+        if (result.isInvalid)
+        {
+            m_isInvalid = true;
+            return { read, written, true };
+        }
+
+        // output is full
+        if (result.read < bodyLength)
+            return { read, written, false };
+
+        std::copy_n(chunk.data() + read, tailLength, m_pendingBytes);
+        m_pendingCount = static_cast<uint8_t>(tailLength);
+        read += tailLength;
+        return { read, written, false };
+    }
+
+    bool Utf8ToUtf16Stream::Finish() noexcept
+    {
+        if (m_pendingCount != 0)
+            m_isInvalid = true;
+
+        return !m_isInvalid;
+    }
+
+    uint64_t Utf8ToUtf16Stream::GetPosition() const noexcept
+    {
+        return m_position;
+    }
+
+    void Utf8ToUtf16Stream::Reset() noexcept
+    {
+        m_position = 0;
+        m_pendingCount = 0;
+        m_isInvalid = false;
+    }
+}
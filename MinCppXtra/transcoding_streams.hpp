@@ -0,0 +1,135 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace mincpp
+{
+	/// <summary>
+	/// Outcome of transcoding a chunk of a stream.
+	/// </summary>
+	struct TranscodingProgress
+	{
+		/// <summary>
+		/// Count of code units consumed from the chunk. Unless the input is invalid,
+		/// the remaining ones must be passed again once there is room in the output.
+		/// </summary>
+		size_t read;
+
+		/// <summary>
+		/// Count of code units written to the output.
+		/// </summary>
+		size_t written;
+
+		/// <summary>
+		/// Whether the stream stopped at invalid input.
+		/// </summary>
+		bool isInvalid;
+	};
+
+	/// <summary>
+	/// Transcodes UTF-16 to UTF-8 in chunks of any size, such as from a pipe or a huge file.
+	/// A surrogate pair split between chunks is carried along, so memory use is constant.
+	/// Wide chars are UTF-32 where wchar_t has 32 bits, as for mincpp::Win32ApiStrings.
+	/// </summary>
+	class Utf16ToUtf8Stream
+	{
+	private:
+
+		uint64_t m_position;
+		char16_t m_pendingLead;
+		bool m_hasPendingLead;
+		bool m_isInvalid;
+
+	public:
+
+		Utf16ToUtf8Stream() noexcept;
+
+		/// <summary>
+		/// Transcodes the next chunk of the stream.
+		/// </summary>
+		/// <param name="chunk">The next wide chars of UTF-16 text.</param>
+		/// <param name="output">
+		/// Receives UTF-8 text, which needs room for at least one code point (4 chars) to make progress.
+		/// </param>
+		/// <returns>How much was read and written, or whether the input is invalid.</returns>
+		TranscodingProgress Transcode(std::wstring_view chunk, std::span<char> output) noexcept;
+
+		/// <summary>
+		/// Ends the stream, which becomes invalid if a surrogate pair was left incomplete.
+		/// </summary>
+		/// <returns>Whether the whole stream was valid.</returns>
+		bool Finish() noexcept;
+
+		/// <summary>
+		/// Gets the position in the input (in wide chars since the start of the stream) up to
+		/// which it has been transcoded, which is where invalid input starts, if that is the case.
+		/// </summary>
+		uint64_t GetPosition() const noexcept;
+
+		/// <summary>
+		/// Starts a new stream.
+		/// </summary>
+		void Reset() noexcept;
+	};
+
+	/// <summary>
+	/// Transcodes UTF-8 to UTF-16 in chunks of any size, such as from a pipe or a huge file.
+	/// A sequence split between chunks is carried along, so memory use is constant.
+	/// Wide chars are UTF-32 where wchar_t has 32 bits, as for mincpp::Win32ApiStrings.
+	/// </summary>
+	class Utf8ToUtf16Stream
+	{
+	private:
+
+		uint64_t m_position;
+		char m_pendingBytes[3];
+		uint8_t m_pendingCount;
+		bool m_isInvalid;
+
+	public:
+
+		Utf8ToUtf16Stream() noexcept;
+
+		/// <summary>
+		/// Transcodes the next chunk of the stream.
+		/// </summary>
+		/// <param name="chunk">The next chars of UTF-8 text.</param>
+		/// <param name="output">
+		/// Receives UTF-16 text, which needs room for at least one code point (2 wide chars) to make progress.
+		/// </param>
+		/// <returns>How much was read and written, or whether the input is invalid.</returns>
+		TranscodingProgress Transcode(std::string_view chunk, std::span<wchar_t> output) noexcept;
+
+		/// <summary>
+		/// Ends the stream, which becomes invalid if a sequence was left incomplete.
+		/// </summary>
+		/// <returns>Whether the whole stream was valid.</returns>
+		bool Finish() noexcept;
+
+		/// <summary>
+		/// Gets the position in the input (in chars since the start of the stream) up to
+		/// which it has been transcoded, which is where invalid input starts, if that is the case.
+		/// </summary>
+		uint64_t GetPosition() const noexcept;
+
+		/// <summary>
+		/// Starts a new stream.
+		/// </summary>
+		void Reset() noexcept;
+	};
+}
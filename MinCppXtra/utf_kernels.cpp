@@ -0,0 +1,540 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "internal/utf_kernels.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#   define MINCPP_X64_KERNELS
+#   ifdef _MSC_VER
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif
+
+namespace mincpp
+{
+    namespace
+    {
+        bool IsSurrogate(uint32_t codeUnit) noexcept
+        {
+            return (codeUnit & 0xF800) == 0xD800;
+        }
+
+        bool IsLeadSurrogate(uint32_t codeUnit) noexcept
+        {
+            return (codeUnit & 0xFC00) == 0xD800;
+        }
+
+        bool IsTrailSurrogate(uint32_t codeUnit) noexcept
+        {
+            return (codeUnit & 0xFC00) == 0xDC00;
+        }
+
+        size_t GetUtf8Length(uint32_t codePoint) noexcept
+        {
+            if (codePoint < 0x80)
+                return 1;
+            if (codePoint < 0x800)
+                return 2;
+            if (codePoint < 0x10000)
+                return 3;
+            return 4;
+        }
+
+        void EncodeUtf8(uint32_t codePoint, size_t length, char* output) noexcept
+        {
+            switch (length)
+            {
+            case 1:
+                output[0] = static_cast<char>(codePoint);
+                break;
+            case 2:
+                output[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+                output[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                break;
+            case 3:
+                output[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+                output[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                break;
+            default:
+                output[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+                output[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                output[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                output[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                break;
+            }
+        }
+    }
+
+    size_t scalar::CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept
+    {
+        size_t count = length;
+        for (size_t idx = 0; idx < length; ++idx)
+        {
+            const uint32_t codeUnit = input[idx];
+            if (codeUnit >= 0x80)
+            {
+                count += (codeUnit >= 0x800 && !IsSurrogate(codeUnit)) ? 2 : 1;
+            }
+        }
+        return count;
+    }
+
+    TranscodingResult scalar::TranscodeUtf16ToUtf8(
+        const char16_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        while (read < length)
+        {
+            uint32_t codePoint = input[read];
+            size_t codeUnitCount = 1;
+            if (IsSurrogate(codePoint))
+            {
+                // same as utfcpp: a pair must be complete
+                if (!IsLeadSurrogate(codePoint)
+                    || read + 1 == length
+                    || !IsTrailSurrogate(input[read + 1]))
+                {
+                    return { read, written, true };
+                }
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (input[read + 1] - 0xDC00);
+                codeUnitCount = 2;
+            }
+
+            const size_t encodedLength = GetUtf8Length(codePoint);
+            if (capacity - written < encodedLength)
+                break;
+
+            EncodeUtf8(codePoint, encodedLength, output + written);
+            read += codeUnitCount;
+            written += encodedLength;
+        }
+        return { read, written, false };
+    }
+
+    namespace
+    {
+        bool IsContinuation(uint8_t byte) noexcept
+        {
+            return (byte & 0xC0) == 0x80;
+        }
+
+        /// <summary>
+        /// Decodes the UTF-8 sequence at the start of the input, accepting the same as utfcpp.
+        /// </summary>
+        /// <returns>The length of the sequence, or 0 if invalid (or incomplete).</returns>
+        size_t DecodeUtf8(const uint8_t* input, size_t length, uint32_t& codePoint) noexcept
+        {
+            const uint32_t lead = input[0];
+            size_t sequenceLength;
+            uint32_t minimum;
+            if (lead < 0x80)
+            {
+                codePoint = lead;
+                return 1;
+            }
+            else if ((lead >> 5) == 0x6)
+            {
+                sequenceLength = 2;
+                minimum = 0x80;
+                codePoint = lead & 0x1F;
+            }
+            else if ((lead >> 4) == 0xE)
+            {
+                sequenceLength = 3;
+                minimum = 0x800;
+                codePoint = lead & 0x0F;
+            }
+            else if ((lead >> 3) == 0x1E)
+            {
+                sequenceLength = 4;
+                minimum = 0x10000;
+                codePoint = lead & 0x07;
+            }
+            else
+            {
+                return 0;
+            }
+
+            if (length < sequenceLength)
+                return 0;
+
+            for (size_t idx = 1; idx < sequenceLength; ++idx)
+            {
+                if (!IsContinuation(input[idx]))
+                    return 0;
+
+                codePoint = (codePoint << 6) | (input[idx] & 0x3F);
+            }
+
+            // overlong, out of range, or surrogate
+            if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+                return 0;
+
+            return sequenceLength;
+        }
+    }
+
+    size_t scalar::CountUtf16OfUtf8(const char* input, size_t length) noexcept
+    {
+        // 1 code unit per sequence, +1 for those of 4 bytes
+        size_t count = 0;
+        for (size_t idx = 0; idx < length; ++idx)
+        {
+            const auto byte = static_cast<uint8_t>(input[idx]);
+            count += !IsContinuation(byte) + (byte >= 0xF0);
+        }
+        return count;
+    }
+
+    TranscodingResult scalar::TranscodeUtf8ToUtf16(
+        const char* input, size_t length, char16_t* output, size_t capacity) noexcept
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(input);
+        size_t read = 0;
+        size_t written = 0;
+        while (read < length)
+        {
+            uint32_t codePoint;
+            const size_t sequenceLength = DecodeUtf8(bytes + read, length - read, codePoint);
+            if (sequenceLength == 0)
+                return { read, written, true };
+
+            if (codePoint < 0x10000)
+            {
+                if (written == capacity)
+                    break;
+
+                output[written++] = static_cast<char16_t>(codePoint);
+            }
+            else
+            {
+                if (capacity - written < 2)
+                    break;
+
+                output[written++] = static_cast<char16_t>(0xD7C0 + (codePoint >> 10));
+                output[written++] = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+            }
+            read += sequenceLength;
+        }
+        return { read, written, false };
+    }
+
+    size_t scalar::MeasureValidUtf8(const char* input, size_t length) noexcept
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(input);
+        size_t read = 0;
+        while (read < length)
+        {
+            uint32_t codePoint;
+            const size_t sequenceLength = DecodeUtf8(bytes + read, length - read, codePoint);
+            if (sequenceLength == 0)
+                break;
+
+            read += sequenceLength;
+        }
+        return read;
+    }
+
+    size_t scalar::CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept
+    {
+        size_t count = 0;
+        for (size_t idx = 0; idx < length; ++idx)
+            count += GetUtf8Length(input[idx]);
+
+        return count;
+    }
+
+    TranscodingResult scalar::TranscodeUtf32ToUtf8(
+        const char32_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        while (read < length)
+        {
+            // same as utfcpp: no surrogates, nor beyond the last plane
+            const uint32_t codePoint = input[read];
+            if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+                return { read, written, true };
+
+            const size_t encodedLength = GetUtf8Length(codePoint);
+            if (capacity - written < encodedLength)
+                break;
+
+            EncodeUtf8(codePoint, encodedLength, output + written);
+            ++read;
+            written += encodedLength;
+        }
+        return { read, written, false };
+    }
+
+    size_t scalar::CountUtf32OfUtf8(const char* input, size_t length) noexcept
+    {
+        // 1 code point per sequence
+        size_t count = 0;
+        for (size_t idx = 0; idx < length; ++idx)
+            count += !IsContinuation(static_cast<uint8_t>(input[idx]));
+
+        return count;
+    }
+
+    TranscodingResult scalar::TranscodeUtf8ToUtf32(
+        const char* input, size_t length, char32_t* output, size_t capacity) noexcept
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(input);
+        size_t read = 0;
+        size_t written = 0;
+        while (read < length)
+        {
+            // (invalid input is reported even when the output is full, as it takes no room)
+            uint32_t codePoint;
+            const size_t sequenceLength = DecodeUtf8(bytes + read, length - read, codePoint);
+            if (sequenceLength == 0)
+                return { read, written, true };
+
+            if (written == capacity)
+                break;
+
+            output[written++] = codePoint;
+            read += sequenceLength;
+        }
+        return { read, written, false };
+    }
+
+    size_t FindUtf8SequenceStart(const char* input, size_t length, size_t position) noexcept
+    {
+        // (no valid sequence has more than 3 continuation bytes)
+        const auto bytes = reinterpret_cast<const uint8_t*>(input);
+        for (size_t back = 0; back <= 3 && back <= position && position - back < length; ++back)
+        {
+            if (!IsContinuation(bytes[position - back]))
+                return position - back;
+        }
+        return position;
+    }
+
+    size_t GetUtf8SequenceLength(char lead) noexcept
+    {
+        const auto byte = static_cast<uint8_t>(lead);
+        if (byte < 0x80)
+            return 1;
+        else if ((byte >> 5) == 0x6)
+            return 2;
+        else if ((byte >> 4) == 0xE)
+            return 3;
+        else if ((byte >> 3) == 0x1E)
+            return 4;
+        else
+            return 0;
+    }
+
+    size_t MeasureIncompleteUtf8Tail(const char* input, size_t length) noexcept
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(input);
+        for (size_t back = 1; back <= 3 && back <= length; ++back)
+        {
+            if (IsContinuation(bytes[length - back]))
+                continue;
+
+            return GetUtf8SequenceLength(input[length - back]) > back ? back : 0;
+        }
+        return 0;
+    }
+
+    namespace
+    {
+        struct UtfKernels
+        {
+            Win32ApiStrings::Acceleration acceleration;
+            decltype(&scalar::CountUtf8OfUtf16) countUtf8OfUtf16;
+            decltype(&scalar::TranscodeUtf16ToUtf8) transcodeUtf16ToUtf8;
+            decltype(&scalar::CountUtf16OfUtf8) countUtf16OfUtf8;
+            decltype(&scalar::TranscodeUtf8ToUtf16) transcodeUtf8ToUtf16;
+            decltype(&scalar::MeasureValidUtf8) measureValidUtf8;
+            decltype(&scalar::CountUtf8OfUtf32) countUtf8OfUtf32;
+            decltype(&scalar::TranscodeUtf32ToUtf8) transcodeUtf32ToUtf8;
+            decltype(&scalar::CountUtf32OfUtf8) countUtf32OfUtf8;
+            decltype(&scalar::TranscodeUtf8ToUtf32) transcodeUtf8ToUtf32;
+        };
+
+        // indexed by level of acceleration
+        constexpr UtfKernels s_kernels[] =
+        {
+            {
+                Win32ApiStrings::Acceleration::None,
+                &scalar::CountUtf8OfUtf16,
+                &scalar::TranscodeUtf16ToUtf8,
+                &scalar::CountUtf16OfUtf8,
+                &scalar::TranscodeUtf8ToUtf16,
+                &scalar::MeasureValidUtf8,
+                &scalar::CountUtf8OfUtf32,
+                &scalar::TranscodeUtf32ToUtf8,
+                &scalar::CountUtf32OfUtf8,
+                &scalar::TranscodeUtf8ToUtf32,
+            },
+#ifdef MINCPP_X64_KERNELS
+            {
+                Win32ApiStrings::Acceleration::Sse2,
+                &sse2::CountUtf8OfUtf16,
+                &sse2::TranscodeUtf16ToUtf8,
+                &sse2::CountUtf16OfUtf8,
+                &sse2::TranscodeUtf8ToUtf16,
+                &sse2::MeasureValidUtf8,
+                &sse2::CountUtf8OfUtf32,
+                &sse2::TranscodeUtf32ToUtf8,
+                &sse2::CountUtf32OfUtf8,
+                &sse2::TranscodeUtf8ToUtf32,
+            },
+            {
+                Win32ApiStrings::Acceleration::Avx2,
+                &avx2::CountUtf8OfUtf16,
+                &avx2::TranscodeUtf16ToUtf8,
+                &avx2::CountUtf16OfUtf8,
+                &avx2::TranscodeUtf8ToUtf16,
+                &avx2::MeasureValidUtf8,
+                &avx2::CountUtf8OfUtf32,
+                &avx2::TranscodeUtf32ToUtf8,
+                &avx2::CountUtf32OfUtf8,
+                &avx2::TranscodeUtf8ToUtf32,
+            },
+#endif
+        };
+
+        Win32ApiStrings::Acceleration DetectAcceleration() noexcept
+        {
+#ifdef MINCPP_X64_KERNELS
+            // SSE2 is part of x64, but AVX2 needs both the processor and the OS (saving YMM registers)
+            uint32_t regs[4];
+            auto cpuid = [&regs](uint32_t leaf) {
+#   ifdef _MSC_VER
+                __cpuidex(reinterpret_cast<int*>(regs), leaf, 0);
+#   else
+                __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#   endif
+            };
+
+            cpuid(0);
+            if (regs[0] < 7)
+                return Win32ApiStrings::Acceleration::Sse2;
+
+            cpuid(1);
+            const bool hasOsSupport = (regs[2] & (1 << 27)) != 0;
+            const bool hasAvx = (regs[2] & (1 << 28)) != 0;
+            if (!hasOsSupport || !hasAvx)
+                return Win32ApiStrings::Acceleration::Sse2;
+
+#   ifdef _MSC_VER
+            const uint64_t enabledStates = _xgetbv(0);
+#   else
+            uint32_t eax, edx;
+            __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            const uint64_t enabledStates = (static_cast<uint64_t>(edx) << 32) | eax;
+#   endif
+            if ((enabledStates & 0x6) != 0x6)
+                return Win32ApiStrings::Acceleration::Sse2;
+
+            cpuid(7);
+            const bool hasAvx2 = (regs[1] & (1 << 5)) != 0;
+            return hasAvx2 ? Win32ApiStrings::Acceleration::Avx2 : Win32ApiStrings::Acceleration::Sse2;
+#else
+            return Win32ApiStrings::Acceleration::None;
+#endif
+        }
+
+        std::atomic<const UtfKernels*> s_activeKernels = nullptr;
+
+        const UtfKernels& SelectKernels(Win32ApiStrings::Acceleration limit) noexcept
+        {
+            static const Win32ApiStrings::Acceleration supported = DetectAcceleration();
+            const auto level = std::min(static_cast<size_t>(std::min(limit, supported)), std::size(s_kernels) - 1);
+            const UtfKernels& kernels = s_kernels[level];
+            s_activeKernels.store(&kernels, std::memory_order_release);
+            return kernels;
+        }
+
+        const UtfKernels& GetKernels() noexcept
+        {
+            const UtfKernels* kernels = s_activeKernels.load(std::memory_order_acquire);
+            if (kernels != nullptr)
+                return *kernels;
+
+            return SelectKernels(Win32ApiStrings::Acceleration::Avx2);
+        }
+    }
+
+    size_t CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept
+    {
+        return GetKernels().countUtf8OfUtf16(input, length);
+    }
+
+    TranscodingResult TranscodeUtf16ToUtf8(
+        const char16_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        return GetKernels().transcodeUtf16ToUtf8(input, length, output, capacity);
+    }
+
+    size_t CountUtf16OfUtf8(const char* input, size_t length) noexcept
+    {
+        return GetKernels().countUtf16OfUtf8(input, length);
+    }
+
+    TranscodingResult TranscodeUtf8ToUtf16(
+        const char* input, size_t length, char16_t* output, size_t capacity) noexcept
+    {
+        return GetKernels().transcodeUtf8ToUtf16(input, length, output, capacity);
+    }
+
+    size_t MeasureValidUtf8(const char* input, size_t length) noexcept
+    {
+        return GetKernels().measureValidUtf8(input, length);
+    }
+
+    size_t CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept
+    {
+        return GetKernels().countUtf8OfUtf32(input, length);
+    }
+
+    TranscodingResult TranscodeUtf32ToUtf8(
+        const char32_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        return GetKernels().transcodeUtf32ToUtf8(input, length, output, capacity);
+    }
+
+    size_t CountUtf32OfUtf8(const char* input, size_t length) noexcept
+    {
+        return GetKernels().countUtf32OfUtf8(input, length);
+    }
+
+    TranscodingResult TranscodeUtf8ToUtf32(
+        const char* input, size_t length, char32_t* output, size_t capacity) noexcept
+    {
+        return GetKernels().transcodeUtf8ToUtf32(input, length, output, capacity);
+    }
+
+    Win32ApiStrings::Acceleration GetUtfKernelsAcceleration() noexcept
+    {
+        return GetKernels().acceleration;
+    }
+
+    void LimitUtfKernelsAcceleration(Win32ApiStrings::Acceleration limit) noexcept
+    {
+        SelectKernels(limit);
+    }
+}
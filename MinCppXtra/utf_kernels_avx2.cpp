@@ -0,0 +1,820 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "internal/utf_kernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+#include <algorithm>
+
+// (only this translation unit may use AVX2, because it only runs after detecting support)
+#ifdef __GNUC__
+#   pragma GCC target("avx2")
+#endif
+
+#include <immintrin.h>
+
+namespace mincpp
+{
+    namespace
+    {
+        /// <summary>
+        /// Masks for _mm_shuffle_epi8 that compress lanes of encoded UTF-8 into contiguous output.
+        /// </summary>
+        struct ShuffleTable
+        {
+            alignas(16) uint8_t shuffles[256][16];
+            uint8_t lengths[256];
+        };
+
+        // lanes of 2 bytes, where bit N of the index tells whether lane N is ASCII
+        constexpr ShuffleTable MakeTableFor2ByteLanes()
+        {
+            ShuffleTable table{};
+            for (int index = 0; index < 256; ++index)
+            {
+                int length = 0;
+                for (int lane = 0; lane < 8; ++lane)
+                {
+                    table.shuffles[index][length++] = static_cast<uint8_t>(2 * lane);
+                    if ((index & (1 << lane)) == 0)
+                        table.shuffles[index][length++] = static_cast<uint8_t>(2 * lane + 1);
+                }
+                table.lengths[index] = static_cast<uint8_t>(length);
+                while (length < 16)
+                    table.shuffles[index][length++] = 0x80;
+            }
+            return table;
+        }
+
+        // lanes of 4 bytes, where bit N of the index tells whether lane N is ASCII,
+        // and bit 4+N whether it encodes 3 bytes (otherwise 2)
+        constexpr ShuffleTable MakeTableFor4ByteLanes()
+        {
+            ShuffleTable table{};
+            for (int index = 0; index < 256; ++index)
+            {
+                int length = 0;
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    int laneLength = 2;
+                    if ((index & (1 << lane)) != 0)
+                        laneLength = 1;
+                    else if ((index & (0x10 << lane)) != 0)
+                        laneLength = 3;
+
+                    for (int pos = 0; pos < laneLength; ++pos)
+                        table.shuffles[index][length++] = static_cast<uint8_t>(4 * lane + pos);
+                }
+                table.lengths[index] = static_cast<uint8_t>(length);
+                while (length < 16)
+                    table.shuffles[index][length++] = 0x80;
+            }
+            return table;
+        }
+
+        constexpr ShuffleTable s_tableFor2ByteLanes = MakeTableFor2ByteLanes();
+        constexpr ShuffleTable s_tableFor4ByteLanes = MakeTableFor4ByteLanes();
+
+        __m128i LoadShuffle(const ShuffleTable& table, int index) noexcept
+        {
+            return _mm_load_si128(reinterpret_cast<const __m128i*>(table.shuffles[index]));
+        }
+
+        /// <summary>
+        /// Encodes 8 code units below U+0800 and stores 16 bytes, of which the returned count is UTF-8.
+        /// </summary>
+        size_t Encode2ByteLanes(__m128i codeUnits, char* output) noexcept
+        {
+            const __m128i leads = _mm_or_si128(_mm_srli_epi16(codeUnits, 6), _mm_set1_epi16(0xC0));
+            const __m128i trails = _mm_or_si128(
+                _mm_and_si128(codeUnits, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+
+            const __m128i asciiLanes = _mm_cmpeq_epi16(
+                _mm_and_si128(codeUnits, _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128());
+
+            const __m128i lanes = _mm_blendv_epi8(
+                _mm_or_si128(leads, _mm_slli_epi16(trails, 8)), codeUnits, asciiLanes);
+
+            const int index = _mm_movemask_epi8(_mm_packs_epi16(asciiLanes, _mm_setzero_si128()));
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(output),
+                _mm_shuffle_epi8(lanes, LoadShuffle(s_tableFor2ByteLanes, index)));
+
+            return s_tableFor2ByteLanes.lengths[index];
+        }
+
+        /// <summary>
+        /// Encodes 8 code units that are not surrogates and stores up to 28 bytes, of which the returned count is UTF-8.
+        /// </summary>
+        size_t Encode3ByteLanes(__m128i codeUnits, char* output) noexcept
+        {
+            const __m256i codePoints = _mm256_cvtepu16_epi32(codeUnits);
+            const __m256i lastByte = _mm256_or_si256(
+                _mm256_and_si256(codePoints, _mm256_set1_epi32(0x3F)), _mm256_set1_epi32(0x80));
+
+            const __m256i threeBytes = _mm256_or_si256(
+                _mm256_or_si256(_mm256_srli_epi32(codePoints, 12), _mm256_set1_epi32(0xE0)),
+                _mm256_or_si256(
+                    _mm256_slli_epi32(
+                        _mm256_or_si256(
+                            _mm256_and_si256(_mm256_srli_epi32(codePoints, 6), _mm256_set1_epi32(0x3F)),
+                            _mm256_set1_epi32(0x80)),
+                        8),
+                    _mm256_slli_epi32(lastByte, 16)));
+
+            const __m256i twoBytes = _mm256_or_si256(
+                _mm256_or_si256(_mm256_srli_epi32(codePoints, 6), _mm256_set1_epi32(0xC0)),
+                _mm256_slli_epi32(lastByte, 8));
+
+            const __m256i asciiLanes = _mm256_cmpgt_epi32(_mm256_set1_epi32(0x80), codePoints);
+            const __m256i threeByteLanes = _mm256_cmpgt_epi32(codePoints, _mm256_set1_epi32(0x7FF));
+            const __m256i lanes = _mm256_blendv_epi8(
+                _mm256_blendv_epi8(twoBytes, threeBytes, threeByteLanes), codePoints, asciiLanes);
+
+            const int asciiBits = _mm256_movemask_ps(_mm256_castsi256_ps(asciiLanes));
+            const int threeByteBits = _mm256_movemask_ps(_mm256_castsi256_ps(threeByteLanes));
+
+            const int lowIndex = (asciiBits & 0xF) | ((threeByteBits & 0xF) << 4);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(output),
+                _mm_shuffle_epi8(_mm256_castsi256_si128(lanes), LoadShuffle(s_tableFor4ByteLanes, lowIndex)));
+
+            const size_t lowLength = s_tableFor4ByteLanes.lengths[lowIndex];
+            const int highIndex = (asciiBits >> 4) | (threeByteBits & 0xF0);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(output + lowLength),
+                _mm_shuffle_epi8(_mm256_extracti128_si256(lanes, 1), LoadShuffle(s_tableFor4ByteLanes, highIndex)));
+
+            return lowLength + s_tableFor4ByteLanes.lengths[highIndex];
+        }
+
+        /// <summary>
+        /// Encodes 8 code units that are not surrogates and stores up to 32 bytes, unless they are.
+        /// </summary>
+        /// <returns>Whether the code units were encoded (otherwise there are surrogates among them).</returns>
+        bool TryEncodeBmpLanes(__m128i codeUnits, char* output, size_t& written) noexcept
+        {
+            const __m128i shortMask = _mm_set1_epi16(static_cast<short>(0xF800));
+            if (_mm_testz_si128(codeUnits, _mm_set1_epi16(static_cast<short>(0xFF80))))
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(output), _mm_packus_epi16(codeUnits, codeUnits));
+                written += 8;
+                return true;
+            }
+
+            if (_mm_testz_si128(codeUnits, shortMask))
+            {
+                written += Encode2ByteLanes(codeUnits, output);
+                return true;
+            }
+
+            const __m128i surrogateLanes = _mm_cmpeq_epi16(
+                _mm_and_si128(codeUnits, shortMask), _mm_set1_epi16(static_cast<short>(0xD800)));
+            if (_mm_testz_si128(surrogateLanes, surrogateLanes))
+            {
+                written += Encode3ByteLanes(codeUnits, output);
+                return true;
+            }
+
+            return false;
+        }
+
+        // lanes of 16 bits, where bit N of the index tells whether lane N is kept
+        constexpr ShuffleTable MakeTableFor16BitLanes()
+        {
+            ShuffleTable table{};
+            for (int index = 0; index < 256; ++index)
+            {
+                int length = 0;
+                for (int lane = 0; lane < 8; ++lane)
+                {
+                    if ((index & (1 << lane)) != 0)
+                    {
+                        table.shuffles[index][length++] = static_cast<uint8_t>(2 * lane);
+                        table.shuffles[index][length++] = static_cast<uint8_t>(2 * lane + 1);
+                    }
+                }
+                table.lengths[index] = static_cast<uint8_t>(length / 2);
+                while (length < 16)
+                    table.shuffles[index][length++] = 0x80;
+            }
+            return table;
+        }
+
+        constexpr ShuffleTable s_tableFor16BitLanes = MakeTableFor16BitLanes();
+
+        int GetBitWidth(uint32_t bits) noexcept
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            return _BitScanReverse(&index, bits) ? static_cast<int>(index) + 1 : 0;
+#else
+            return bits == 0 ? 0 : 32 - __builtin_clz(bits);
+#endif
+        }
+
+        __m256i Lookup16(__m256i indices, const uint8_t(&table)[16]) noexcept
+        {
+            const __m128i entries = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+            return _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(entries), indices);
+        }
+
+        /// <summary>
+        /// Validates UTF-8 in consecutive blocks of 32 bytes, using lookup tables to classify errors
+        /// from the high and low nibbles of each pair of adjacent bytes (Keiser and Lemire, 2021).
+        /// The accepted text is the same as for utfcpp, except for incomplete sequences at the end.
+        /// </summary>
+        class Utf8Validator
+        {
+        private:
+
+            static constexpr uint8_t TOO_SHORT = 1 << 0; // 11______ 0_______ or 11______ 11______
+            static constexpr uint8_t TOO_LONG = 1 << 1; // 0_______ 10______
+            static constexpr uint8_t OVERLONG_3 = 1 << 2; // 11100000 100_____
+            static constexpr uint8_t TOO_LARGE = 1 << 3; // 11110100 1001____ and above
+            static constexpr uint8_t SURROGATE = 1 << 4; // 11101101 101_____
+            static constexpr uint8_t OVERLONG_2 = 1 << 5; // 1100000_ 10______
+            static constexpr uint8_t TOO_LARGE_1000 = 1 << 6; // 11110101 1000____ and above
+            static constexpr uint8_t OVERLONG_4 = 1 << 6; // 11110000 1000____
+            static constexpr uint8_t TWO_CONTINUATIONS = 1 << 7; // 10______ 10______
+            static constexpr uint8_t CARRY = TOO_SHORT | TOO_LONG | TWO_CONTINUATIONS;
+
+            // by high nibble of the first byte
+            static constexpr uint8_t s_firstHighNibble[16] =
+            {
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+                TWO_CONTINUATIONS, TWO_CONTINUATIONS, TWO_CONTINUATIONS, TWO_CONTINUATIONS,
+                TOO_SHORT | OVERLONG_2,
+                TOO_SHORT,
+                TOO_SHORT | OVERLONG_3 | SURROGATE,
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+            };
+
+            // by low nibble of the first byte
+            static constexpr uint8_t s_firstLowNibble[16] =
+            {
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                CARRY | OVERLONG_2,
+                CARRY,
+                CARRY,
+                CARRY | TOO_LARGE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000
+            };
+
+            // by high nibble of the second byte
+            static constexpr uint8_t s_secondHighNibble[16] =
+            {
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+                TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | OVERLONG_3 | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | SURROGATE | TOO_LARGE,
+                TOO_LONG | OVERLONG_2 | TWO_CONTINUATIONS | SURROGATE | TOO_LARGE,
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+            };
+
+            __m256i m_previous;
+            __m256i m_previousIncomplete;
+            __m256i m_error;
+
+            static __m256i GetHighNibbles(__m256i bytes) noexcept
+            {
+                return _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+            }
+
+        public:
+
+            Utf8Validator() noexcept
+                : m_previous(_mm256_setzero_si256())
+                , m_previousIncomplete(_mm256_setzero_si256())
+                , m_error(_mm256_setzero_si256())
+            {
+            }
+
+            /// <summary>
+            /// Checks the next 32 bytes.
+            /// </summary>
+            void Check(__m256i bytes) noexcept
+            {
+                if (_mm256_movemask_epi8(bytes) == 0)
+                {
+                    // ASCII is only wrong when a sequence is left incomplete
+                    m_error = _mm256_or_si256(m_error, m_previousIncomplete);
+                    m_previousIncomplete = _mm256_setzero_si256();
+                }
+                else
+                {
+                    // the bytes 1, 2 and 3 positions before, across the previous block
+                    const __m256i previousHalves = _mm256_permute2x128_si256(m_previous, bytes, 0x21);
+                    const __m256i previous1 = _mm256_alignr_epi8(bytes, previousHalves, 15);
+                    const __m256i previous2 = _mm256_alignr_epi8(bytes, previousHalves, 14);
+                    const __m256i previous3 = _mm256_alignr_epi8(bytes, previousHalves, 13);
+
+                    const __m256i specialCases = _mm256_and_si256(
+                        _mm256_and_si256(
+                            Lookup16(GetHighNibbles(previous1), s_firstHighNibble),
+                            Lookup16(_mm256_and_si256(previous1, _mm256_set1_epi8(0x0F)), s_firstLowNibble)),
+                        Lookup16(GetHighNibbles(bytes), s_secondHighNibble));
+
+                    // 3rd and 4th bytes of sequences must be continuations, and no other bytes
+                    const __m256i isThirdByte = _mm256_subs_epu8(previous2, _mm256_set1_epi8(0xE0 - 0x80));
+                    const __m256i isFourthByte = _mm256_subs_epu8(previous3, _mm256_set1_epi8(0xF0 - 0x80));
+                    const __m256i mustBeContinuation = _mm256_and_si256(
+                        _mm256_or_si256(isThirdByte, isFourthByte), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+                    m_error = _mm256_or_si256(m_error, _mm256_xor_si256(mustBeContinuation, specialCases));
+
+                    // whether the last bytes start sequences that need more bytes
+                    const __m256i incompleteMax = _mm256_setr_epi8(
+                        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+                    m_previousIncomplete = _mm256_subs_epu8(bytes, incompleteMax);
+                }
+                m_previous = bytes;
+            }
+
+            /// <summary>
+            /// Skips 32 bytes of ASCII that follow complete sequences.
+            /// </summary>
+            void SkipAscii(__m256i bytes) noexcept
+            {
+                m_previous = bytes;
+                m_previousIncomplete = _mm256_setzero_si256();
+            }
+
+            bool HasError() const noexcept
+            {
+                return !_mm256_testz_si256(m_error, m_error);
+            }
+        };
+
+        /// <summary>
+        /// Decodes the valid sequences of up to 3 bytes that end within the next 16 bytes of input,
+        /// given the byte after them, and stores 16 code units, of which the count written is UTF-16.
+        /// </summary>
+        /// <returns>The count of bytes consumed.</returns>
+        size_t DecodeWindow(const char* input, char16_t* output, size_t& written) noexcept
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+            // (continuation bytes are the lowest when signed)
+            const __m128i continuations = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(0xC0)), bytes);
+            const uint32_t continuationBits = static_cast<uint32_t>(_mm_movemask_epi8(continuations))
+                | ((static_cast<uint8_t>(input[16]) & 0xC0) == 0x80 ? 0x10000 : 0);
+
+            // where a byte is not followed by a continuation, a code point ends
+            const uint32_t endBits = ~(continuationBits >> 1) & 0xFFFF;
+
+            // the code point ending at each byte (only meaningful where they end): the payload
+            // of ASCII has 7 bits, and that of continuations has 6, to which prefix up to 10 bits
+            // from the 2 bytes before (regardless of the lead, since they are valid)
+            const __m128i previous1 = _mm_slli_si128(bytes, 1);
+            const __m128i previous2 = _mm_slli_si128(bytes, 2);
+            const __m128i previous1Continuations = _mm_slli_si128(continuations, 1);
+
+            const __m128i payload = _mm_and_si128(
+                bytes, _mm_xor_si128(_mm_set1_epi8(0x7F), _mm_and_si128(continuations, _mm_set1_epi8(0x40))));
+
+            const __m128i lowBytes = _mm_or_si128(
+                payload,
+                _mm_and_si128(
+                    continuations,
+                    _mm_and_si128(_mm_slli_epi16(previous1, 6), _mm_set1_epi8(static_cast<char>(0xC0)))));
+
+            const __m128i highBytes = _mm_and_si128(
+                continuations,
+                _mm_or_si128(
+                    _mm_srli_epi16(_mm_and_si128(previous1, _mm_set1_epi8(0x3C)), 2),
+                    _mm_and_si128(
+                        previous1Continuations,
+                        _mm_slli_epi16(_mm_and_si128(previous2, _mm_set1_epi8(0x0F)), 4))));
+
+            const int lowIndex = endBits & 0xFF;
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(output),
+                _mm_shuffle_epi8(_mm_unpacklo_epi8(lowBytes, highBytes), LoadShuffle(s_tableFor16BitLanes, lowIndex)));
+
+            const size_t lowLength = s_tableFor16BitLanes.lengths[lowIndex];
+            const int highIndex = endBits >> 8;
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(output + lowLength),
+                _mm_shuffle_epi8(_mm_unpackhi_epi8(lowBytes, highBytes), LoadShuffle(s_tableFor16BitLanes, highIndex)));
+
+            written += lowLength + s_tableFor16BitLanes.lengths[highIndex];
+            return GetBitWidth(endBits);
+        }
+    }
+
+    size_t avx2::CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept
+    {
+        const __m256i asciiMask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+        const __m256i shortMask = _mm256_set1_epi16(static_cast<short>(0xF800));
+        const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xD800));
+
+        // every code unit takes 3 bytes, -1 if ASCII, -1 if below U+0800, -1 if surrogate,
+        // which is summed up with the masks of comparisons (-1 when true) in lanes of 16 bits
+        const size_t vectorizedLength = length - length % 16;
+        int64_t count = 3 * static_cast<int64_t>(vectorizedLength);
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go down by 2 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + 16 * 8192);
+            __m256i sums = _mm256_setzero_si256();
+            for (; idx < blockEnd; idx += 16)
+            {
+                const __m256i codeUnits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + idx));
+                const __m256i shortBits = _mm256_and_si256(codeUnits, shortMask);
+                const __m256i asciiLanes = _mm256_cmpeq_epi16(
+                    _mm256_and_si256(codeUnits, asciiMask), _mm256_setzero_si256());
+                const __m256i shortLanes = _mm256_cmpeq_epi16(shortBits, _mm256_setzero_si256());
+                const __m256i surrogateLanes = _mm256_cmpeq_epi16(shortBits, surrogate);
+                sums = _mm256_add_epi16(
+                    sums, _mm256_add_epi16(asciiLanes, _mm256_add_epi16(shortLanes, surrogateLanes)));
+            }
+
+            alignas(32) int32_t totals[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(totals), _mm256_madd_epi16(sums, _mm256_set1_epi16(1)));
+            for (int32_t total : totals)
+                count += total;
+        }
+        return static_cast<size_t>(count) + scalar::CountUtf8OfUtf16(input + idx, length - idx);
+    }
+
+    TranscodingResult avx2::TranscodeUtf16ToUtf8(
+        const char16_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        // (no path stores more than 32 bytes)
+        while (length - read >= 8 && capacity - written >= 32)
+        {
+            if (length - read >= 32)
+            {
+                const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read));
+                const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read + 16));
+                if (_mm256_testz_si256(_mm256_or_si256(low, high), _mm256_set1_epi16(static_cast<short>(0xFF80))))
+                {
+                    // packing works within 128-bit halves, then these get back in order
+                    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + written), packed);
+                    read += 32;
+                    written += 32;
+                    continue;
+                }
+            }
+
+            const __m128i codeUnits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+            if (TryEncodeBmpLanes(codeUnits, output + written, written))
+            {
+                read += 8;
+                continue;
+            }
+
+            // a surrogate pair crossing the end of the block is taken along
+            size_t blockLength = 8;
+            if ((input[read + 7] & 0xFC00) == 0xD800 && length - read > blockLength)
+                ++blockLength;
+
+            const TranscodingResult result = scalar::TranscodeUtf16ToUtf8(
+                input + read, blockLength, output + written, capacity - written);
+
+            read += result.read;
+            written += result.written;
+            if (result.isInvalid || result.read < blockLength)
+                return { read, written, result.isInvalid };
+        }
+
+        const TranscodingResult result = scalar::TranscodeUtf16ToUtf8(
+            input + read, length - read, output + written, capacity - written);
+
+        return { read + result.read, written + result.written, result.isInvalid };
+    }
+
+    size_t avx2::CountUtf16OfUtf8(const char* input, size_t length) noexcept
+    {
+        // 1 code unit per sequence, +1 for those of 4 bytes, which is summed up
+        // in lanes of 8 bits with the masks of comparisons (-1 when true)
+        const __m256i leadMin = _mm256_set1_epi8(static_cast<char>(0xC0));
+        const __m256i fourByteLead = _mm256_set1_epi8(static_cast<char>(0xF0));
+        const size_t vectorizedLength = length - length % 32;
+        size_t count = vectorizedLength;
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go up or down by 1 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + 32 * 127);
+            __m256i sums = _mm256_set1_epi8(127);
+            for (; idx < blockEnd; idx += 32)
+            {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + idx));
+                // (continuation bytes are the lowest when signed)
+                const __m256i continuations = _mm256_cmpgt_epi8(leadMin, bytes);
+                const __m256i fourByteLeads = _mm256_cmpeq_epi8(_mm256_max_epu8(bytes, fourByteLead), bytes);
+                sums = _mm256_sub_epi8(_mm256_add_epi8(sums, continuations), fourByteLeads);
+            }
+
+            alignas(32) uint64_t totals[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(totals), _mm256_sad_epu8(sums, _mm256_setzero_si256()));
+            count += totals[0] + totals[1] + totals[2] + totals[3] - 32 * 127;
+        }
+        return count + scalar::CountUtf16OfUtf8(input + idx, length - idx);
+    }
+
+    namespace
+    {
+        /// <summary>
+        /// Stores 32 bytes of ASCII as code units.
+        /// </summary>
+        void StoreAscii(__m256i bytes, char16_t* output) noexcept
+        {
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(output), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(output + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+        }
+
+        void StoreAscii(__m256i bytes, char32_t* output) noexcept
+        {
+            const __m128i low = _mm256_castsi256_si128(bytes);
+            const __m128i high = _mm256_extracti128_si256(bytes, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), _mm256_cvtepu8_epi32(low));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 16), _mm256_cvtepu8_epi32(high));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+        }
+
+        size_t DecodeWindow(const char* input, char32_t* output, size_t& written) noexcept
+        {
+            // code points below U+10000 are the same in UTF-16, so these only need widening
+            alignas(16) char16_t codeUnits[16];
+            size_t count = 0;
+            const size_t read = DecodeWindow(input, codeUnits, count);
+            const __m128i* const lanes = reinterpret_cast<const __m128i*>(codeUnits);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), _mm256_cvtepu16_epi32(_mm_load_si128(lanes)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 8), _mm256_cvtepu16_epi32(_mm_load_si128(lanes + 1)));
+            written += count;
+            return read;
+        }
+
+        TranscodingResult TranscodeUtf8Scalar(
+            const char* input, size_t length, char16_t* output, size_t capacity) noexcept
+        {
+            return scalar::TranscodeUtf8ToUtf16(input, length, output, capacity);
+        }
+
+        TranscodingResult TranscodeUtf8Scalar(
+            const char* input, size_t length, char32_t* output, size_t capacity) noexcept
+        {
+            return scalar::TranscodeUtf8ToUtf32(input, length, output, capacity);
+        }
+
+        /// <summary>
+        /// Transcodes UTF-8 to either UTF-16 or UTF-32, whose code units are the same
+        /// as long as sequences have up to 3 bytes.
+        /// </summary>
+        template <typename OutputChar>
+        TranscodingResult TranscodeUtf8(
+            const char* input, size_t length, OutputChar* output, size_t capacity) noexcept
+        {
+            // Validation runs ahead of decoding, which takes windows of 16 bytes where the
+            // sequences are then known to be valid. The exact position of an error is left
+            // for scalar code to find.
+            Utf8Validator validator;
+            size_t validated = 0;
+            size_t read = 0;
+            size_t written = 0;
+            // (no path stores more than 32 code units)
+            while (capacity - written >= 32)
+            {
+                if (length - read >= 32)
+                {
+                    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read));
+                    if (_mm256_movemask_epi8(bytes) == 0)
+                    {
+                        StoreAscii(bytes, output + written);
+
+                        // (ASCII is valid by itself)
+                        if (validated <= read)
+                        {
+                            validator.SkipAscii(bytes);
+                            validated = read + 32;
+                        }
+                        read += 32;
+                        written += 32;
+                        continue;
+                    }
+                }
+
+                while (validated < read + 17 && length - validated >= 32)
+                {
+                    validator.Check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + validated)));
+                    validated += 32;
+                }
+
+                if (validated < read + 17 || validator.HasError())
+                    break;
+
+                const __m128i window = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+                const __m128i fourByteLeads = _mm_cmpeq_epi8(
+                    _mm_max_epu8(window, _mm_set1_epi8(static_cast<char>(0xF0))), window);
+
+                if (_mm_movemask_epi8(fourByteLeads) == 0)
+                {
+                    read += DecodeWindow(input + read, output + written, written);
+                    continue;
+                }
+
+                // sequences of 4 bytes are rather left for scalar code
+                const size_t blockEnd = FindUtf8SequenceStart(input, length, read + 16);
+                const TranscodingResult result = TranscodeUtf8Scalar(
+                    input + read, blockEnd - read, output + written, capacity - written);
+
+                read += result.read;
+                written += result.written;
+                if (result.isInvalid || read < blockEnd)
+                    return { read, written, result.isInvalid };
+            }
+
+            const TranscodingResult result = TranscodeUtf8Scalar(
+                input + read, length - read, output + written, capacity - written);
+
+            return { read + result.read, written + result.written, result.isInvalid };
+        }
+    }
+
+    TranscodingResult avx2::TranscodeUtf8ToUtf16(
+        const char* input, size_t length, char16_t* output, size_t capacity) noexcept
+    {
+        return TranscodeUtf8(input, length, output, capacity);
+    }
+
+    size_t avx2::MeasureValidUtf8(const char* input, size_t length) noexcept
+    {
+        // blocks are validated in groups, and once a group has an error, scalar code
+        // tells where it is, from the last sequence before the group on
+        constexpr size_t groupSize = 4 * sizeof(__m256i);
+        Utf8Validator validator;
+        size_t read = 0;
+        while (length - read >= groupSize)
+        {
+            for (size_t offset = 0; offset < groupSize; offset += sizeof(__m256i))
+                validator.Check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read + offset)));
+
+            if (validator.HasError())
+                break;
+
+            read += groupSize;
+        }
+
+        const size_t start = (read == 0) ? 0 : FindUtf8SequenceStart(input, length, read - 1);
+        return start + scalar::MeasureValidUtf8(input + start, length - start);
+    }
+
+    size_t avx2::CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept
+    {
+        // every code point takes 1 byte, +1 from U+0080, +1 from U+0800, +1 from U+10000,
+        // which is summed up with the masks of comparisons (-1 when true) in lanes of 32 bits
+        const __m256i twoByteMin = _mm256_set1_epi32(0x7F);
+        const __m256i threeByteMin = _mm256_set1_epi32(0x7FF);
+        const __m256i fourByteMin = _mm256_set1_epi32(0xFFFF);
+        const size_t vectorizedLength = length - length % 8;
+        size_t count = vectorizedLength;
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go up by 3 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + (size_t{8} << 28));
+            __m256i sums = _mm256_setzero_si256();
+            for (; idx < blockEnd; idx += 8)
+            {
+                const __m256i codePoints = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + idx));
+                sums = _mm256_sub_epi32(sums, _mm256_add_epi32(
+                    _mm256_cmpgt_epi32(codePoints, twoByteMin),
+                    _mm256_add_epi32(
+                        _mm256_cmpgt_epi32(codePoints, threeByteMin), _mm256_cmpgt_epi32(codePoints, fourByteMin))));
+            }
+
+            alignas(32) uint32_t totals[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(totals), sums);
+            for (uint32_t total : totals)
+                count += total;
+        }
+        return count + scalar::CountUtf8OfUtf32(input + idx, length - idx);
+    }
+
+    TranscodingResult avx2::TranscodeUtf32ToUtf8(
+        const char32_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        // (no path stores more than 32 bytes)
+        while (length - read >= 8 && capacity - written >= 32)
+        {
+            if (length - read >= 32)
+            {
+                const __m256i codePoints0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read));
+                const __m256i codePoints1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read + 8));
+                const __m256i codePoints2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read + 16));
+                const __m256i codePoints3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read + 24));
+                const __m256i allBits = _mm256_or_si256(
+                    _mm256_or_si256(codePoints0, codePoints1), _mm256_or_si256(codePoints2, codePoints3));
+
+                if (_mm256_testz_si256(allBits, _mm256_set1_epi32(~0x7F)))
+                {
+                    // packing works within 128-bit halves, then groups of 4 bytes get back in order
+                    const __m256i packed = _mm256_packus_epi16(
+                        _mm256_packs_epi32(codePoints0, codePoints1), _mm256_packs_epi32(codePoints2, codePoints3));
+                    _mm256_storeu_si256(
+                        reinterpret_cast<__m256i*>(output + written),
+                        _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+                    read += 32;
+                    written += 32;
+                    continue;
+                }
+            }
+
+            // code points below U+10000 are encoded from UTF-16
+            const __m256i codePoints = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + read));
+            if (_mm256_testz_si256(codePoints, _mm256_set1_epi32(~0xFFFF)))
+            {
+                const __m128i codeUnits = _mm_packus_epi32(
+                    _mm256_castsi256_si128(codePoints), _mm256_extracti128_si256(codePoints, 1));
+                if (TryEncodeBmpLanes(codeUnits, output + written, written))
+                {
+                    read += 8;
+                    continue;
+                }
+            }
+
+            const TranscodingResult result = scalar::TranscodeUtf32ToUtf8(
+                input + read, 8, output + written, capacity - written);
+
+            read += result.read;
+            written += result.written;
+            if (result.isInvalid || result.read < 8)
+                return { read, written, result.isInvalid };
+        }
+
+        const TranscodingResult result = scalar::TranscodeUtf32ToUtf8(
+            input + read, length - read, output + written, capacity - written);
+
+        return { read + result.read, written + result.written, result.isInvalid };
+    }
+
+    size_t avx2::CountUtf32OfUtf8(const char* input, size_t length) noexcept
+    {
+        // 1 code point per sequence, which is summed up
+        // in lanes of 8 bits with the masks of comparisons (-1 when true)
+        const __m256i leadMin = _mm256_set1_epi8(static_cast<char>(0xC0));
+        const size_t vectorizedLength = length - length % 32;
+        size_t count = vectorizedLength;
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go down by 1 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + 32 * 255);
+            __m256i sums = _mm256_set1_epi8(static_cast<char>(255));
+            for (; idx < blockEnd; idx += 32)
+            {
+                const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + idx));
+                // (continuation bytes are the lowest when signed)
+                sums = _mm256_add_epi8(sums, _mm256_cmpgt_epi8(leadMin, bytes));
+            }
+
+            alignas(32) uint64_t totals[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(totals), _mm256_sad_epu8(sums, _mm256_setzero_si256()));
+            count += totals[0] + totals[1] + totals[2] + totals[3] - 32 * 255;
+        }
+        return count + scalar::CountUtf32OfUtf8(input + idx, length - idx);
+    }
+
+    TranscodingResult avx2::TranscodeUtf8ToUtf32(
+        const char* input, size_t length, char32_t* output, size_t capacity) noexcept
+    {
+        return TranscodeUtf8(input, length, output, capacity);
+    }
+}
+
+#endif
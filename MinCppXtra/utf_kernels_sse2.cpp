@@ -0,0 +1,343 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "internal/utf_kernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+#include <algorithm>
+#include <emmintrin.h>
+
+namespace mincpp
+{
+    // SSE2 is granted in x64, but lacks byte shuffles, so only ASCII is vectorized here
+
+    namespace
+    {
+        bool IsAscii(__m128i codeUnits) noexcept
+        {
+            const __m128i nonAsciiBits = _mm_and_si128(codeUnits, _mm_set1_epi16(static_cast<short>(0xFF80)));
+            return _mm_movemask_epi8(_mm_cmpeq_epi16(nonAsciiBits, _mm_setzero_si128())) == 0xFFFF;
+        }
+
+        bool EndsInLeadSurrogate(const char16_t* block, size_t length) noexcept
+        {
+            return (block[length - 1] & 0xFC00) == 0xD800;
+        }
+    }
+
+    size_t sse2::CountUtf8OfUtf16(const char16_t* input, size_t length) noexcept
+    {
+        const __m128i asciiMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+        const __m128i shortMask = _mm_set1_epi16(static_cast<short>(0xF800));
+        const __m128i surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+
+        // every code unit takes 3 bytes, -1 if ASCII, -1 if below U+0800, -1 if surrogate,
+        // which is summed up with the masks of comparisons (-1 when true) in lanes of 16 bits
+        const size_t vectorizedLength = length - length % 8;
+        int64_t count = 3 * static_cast<int64_t>(vectorizedLength);
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go down by 2 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + 8 * 8192);
+            __m128i sums = _mm_setzero_si128();
+            for (; idx < blockEnd; idx += 8)
+            {
+                const __m128i codeUnits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + idx));
+                const __m128i shortBits = _mm_and_si128(codeUnits, shortMask);
+                const __m128i asciiLanes = _mm_cmpeq_epi16(_mm_and_si128(codeUnits, asciiMask), _mm_setzero_si128());
+                const __m128i shortLanes = _mm_cmpeq_epi16(shortBits, _mm_setzero_si128());
+                const __m128i surrogateLanes = _mm_cmpeq_epi16(shortBits, surrogate);
+                sums = _mm_add_epi16(sums, _mm_add_epi16(asciiLanes, _mm_add_epi16(shortLanes, surrogateLanes)));
+            }
+
+            alignas(16) int32_t totals[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(totals), _mm_madd_epi16(sums, _mm_set1_epi16(1)));
+            count += static_cast<int64_t>(totals[0]) + totals[1] + totals[2] + totals[3];
+        }
+        return static_cast<size_t>(count) + scalar::CountUtf8OfUtf16(input + idx, length - idx);
+    }
+
+    TranscodingResult sse2::TranscodeUtf16ToUtf8(
+        const char16_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        while (length - read >= 16 && capacity - written >= 16)
+        {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read + 8));
+            if (IsAscii(_mm_or_si128(low, high)))
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + written), _mm_packus_epi16(low, high));
+                read += 16;
+                written += 16;
+                continue;
+            }
+
+            // a surrogate pair crossing the end of the block is taken along
+            size_t blockLength = 16;
+            if (EndsInLeadSurrogate(input + read, blockLength) && length - read > blockLength)
+                ++blockLength;
+
+            const TranscodingResult result = scalar::TranscodeUtf16ToUtf8(
+                input + read, blockLength, output + written, capacity - written);
+
+            read += result.read;
+            written += result.written;
+            if (result.isInvalid || result.read < blockLength)
+                return { read, written, result.isInvalid };
+        }
+
+        const TranscodingResult result = scalar::TranscodeUtf16ToUtf8(
+            input + read, length - read, output + written, capacity - written);
+
+        return { read + result.read, written + result.written, result.isInvalid };
+    }
+
+    size_t sse2::CountUtf16OfUtf8(const char* input, size_t length) noexcept
+    {
+        // 1 code unit per sequence, +1 for those of 4 bytes, which is summed up
+        // in lanes of 8 bits with the masks of comparisons (-1 when true)
+        const __m128i leadMin = _mm_set1_epi8(static_cast<char>(0xC0));
+        const __m128i fourByteLead = _mm_set1_epi8(static_cast<char>(0xF0));
+        const size_t vectorizedLength = length - length % 16;
+        size_t count = vectorizedLength;
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go up or down by 1 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + 16 * 127);
+            __m128i sums = _mm_set1_epi8(127);
+            for (; idx < blockEnd; idx += 16)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + idx));
+                // (continuation bytes are the lowest when signed)
+                const __m128i continuations = _mm_cmpgt_epi8(leadMin, bytes);
+                const __m128i fourByteLeads = _mm_cmpeq_epi8(_mm_max_epu8(bytes, fourByteLead), bytes);
+                sums = _mm_sub_epi8(_mm_add_epi8(sums, continuations), fourByteLeads);
+            }
+
+            alignas(16) uint64_t totals[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(totals), _mm_sad_epu8(sums, _mm_setzero_si128()));
+            count += totals[0] + totals[1] - 16 * 127;
+        }
+        return count + scalar::CountUtf16OfUtf8(input + idx, length - idx);
+    }
+
+    TranscodingResult sse2::TranscodeUtf8ToUtf16(
+        const char* input, size_t length, char16_t* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        while (length - read >= 16 && capacity - written >= 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+            if (_mm_movemask_epi8(bytes) == 0)
+            {
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written), _mm_unpacklo_epi8(bytes, _mm_setzero_si128()));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written + 8), _mm_unpackhi_epi8(bytes, _mm_setzero_si128()));
+                read += 16;
+                written += 16;
+                continue;
+            }
+
+            // a sequence crossing the end of the block is left for the next one
+            const size_t blockEnd = FindUtf8SequenceStart(input, length, read + 16);
+
+            const TranscodingResult result = scalar::TranscodeUtf8ToUtf16(
+                input + read, blockEnd - read, output + written, capacity - written);
+
+            read += result.read;
+            written += result.written;
+            if (result.isInvalid || read < blockEnd)
+                return { read, written, result.isInvalid };
+        }
+
+        const TranscodingResult result = scalar::TranscodeUtf8ToUtf16(
+            input + read, length - read, output + written, capacity - written);
+
+        return { read + result.read, written + result.written, result.isInvalid };
+    }
+
+    size_t sse2::MeasureValidUtf8(const char* input, size_t length) noexcept
+    {
+        // only ASCII is vectorized, other blocks are left to scalar code
+        size_t read = 0;
+        while (length - read >= sizeof(__m128i))
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+            if (_mm_movemask_epi8(bytes) == 0)
+            {
+                read += sizeof(__m128i);
+                continue;
+            }
+
+            // (a sequence cut short here would be invalid anyway, at the same position)
+            const size_t blockEnd = FindUtf8SequenceStart(input, length, read + sizeof(__m128i));
+            const size_t valid = scalar::MeasureValidUtf8(input + read, blockEnd - read);
+            if (valid < blockEnd - read)
+                return read + valid;
+
+            read = blockEnd;
+        }
+        return read + scalar::MeasureValidUtf8(input + read, length - read);
+    }
+
+    size_t sse2::CountUtf8OfUtf32(const char32_t* input, size_t length) noexcept
+    {
+        // every code point takes 1 byte, +1 from U+0080, +1 from U+0800, +1 from U+10000,
+        // which is summed up with the masks of comparisons (-1 when true) in lanes of 32 bits
+        const __m128i twoByteMin = _mm_set1_epi32(0x7F);
+        const __m128i threeByteMin = _mm_set1_epi32(0x7FF);
+        const __m128i fourByteMin = _mm_set1_epi32(0xFFFF);
+        const size_t vectorizedLength = length - length % 4;
+        size_t count = vectorizedLength;
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go up by 3 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + (size_t{4} << 28));
+            __m128i sums = _mm_setzero_si128();
+            for (; idx < blockEnd; idx += 4)
+            {
+                const __m128i codePoints = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + idx));
+                sums = _mm_sub_epi32(sums, _mm_add_epi32(
+                    _mm_cmpgt_epi32(codePoints, twoByteMin),
+                    _mm_add_epi32(_mm_cmpgt_epi32(codePoints, threeByteMin), _mm_cmpgt_epi32(codePoints, fourByteMin))));
+            }
+
+            alignas(16) uint32_t totals[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(totals), sums);
+            count += static_cast<size_t>(totals[0]) + totals[1] + totals[2] + totals[3];
+        }
+        return count + scalar::CountUtf8OfUtf32(input + idx, length - idx);
+    }
+
+    TranscodingResult sse2::TranscodeUtf32ToUtf8(
+        const char32_t* input, size_t length, char* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        while (length - read >= 16 && capacity - written >= 16)
+        {
+            const __m128i codePoints0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+            const __m128i codePoints1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read + 4));
+            const __m128i codePoints2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read + 8));
+            const __m128i codePoints3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read + 12));
+            const __m128i allBits = _mm_or_si128(
+                _mm_or_si128(codePoints0, codePoints1), _mm_or_si128(codePoints2, codePoints3));
+
+            const __m128i nonAsciiBits = _mm_and_si128(allBits, _mm_set1_epi32(~0x7F));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(nonAsciiBits, _mm_setzero_si128())) == 0xFFFF)
+            {
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written),
+                    _mm_packus_epi16(
+                        _mm_packs_epi32(codePoints0, codePoints1), _mm_packs_epi32(codePoints2, codePoints3)));
+                read += 16;
+                written += 16;
+                continue;
+            }
+
+            const TranscodingResult result = scalar::TranscodeUtf32ToUtf8(
+                input + read, 16, output + written, capacity - written);
+
+            read += result.read;
+            written += result.written;
+            if (result.isInvalid || result.read < 16)
+                return { read, written, result.isInvalid };
+        }
+
+        const TranscodingResult result = scalar::TranscodeUtf32ToUtf8(
+            input + read, length - read, output + written, capacity - written);
+
+        return { read + result.read, written + result.written, result.isInvalid };
+    }
+
+    size_t sse2::CountUtf32OfUtf8(const char* input, size_t length) noexcept
+    {
+        // 1 code point per sequence, which is summed up
+        // in lanes of 8 bits with the masks of comparisons (-1 when true)
+        const __m128i leadMin = _mm_set1_epi8(static_cast<char>(0xC0));
+        const size_t vectorizedLength = length - length % 16;
+        size_t count = vectorizedLength;
+        size_t idx = 0;
+        while (idx < vectorizedLength)
+        {
+            // (lanes can go down by 1 each time, so they are summed up before overflowing)
+            const size_t blockEnd = std::min(vectorizedLength, idx + 16 * 255);
+            __m128i sums = _mm_set1_epi8(static_cast<char>(255));
+            for (; idx < blockEnd; idx += 16)
+            {
+                const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + idx));
+                // (continuation bytes are the lowest when signed)
+                sums = _mm_add_epi8(sums, _mm_cmpgt_epi8(leadMin, bytes));
+            }
+
+            alignas(16) uint64_t totals[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(totals), _mm_sad_epu8(sums, _mm_setzero_si128()));
+            count += totals[0] + totals[1] - 16 * 255;
+        }
+        return count + scalar::CountUtf32OfUtf8(input + idx, length - idx);
+    }
+
+    TranscodingResult sse2::TranscodeUtf8ToUtf32(
+        const char* input, size_t length, char32_t* output, size_t capacity) noexcept
+    {
+        size_t read = 0;
+        size_t written = 0;
+        while (length - read >= 16 && capacity - written >= 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + read));
+            if (_mm_movemask_epi8(bytes) == 0)
+            {
+                const __m128i low = _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+                const __m128i high = _mm_unpackhi_epi8(bytes, _mm_setzero_si128());
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written), _mm_unpacklo_epi16(low, _mm_setzero_si128()));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written + 4), _mm_unpackhi_epi16(low, _mm_setzero_si128()));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written + 8), _mm_unpacklo_epi16(high, _mm_setzero_si128()));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(output + written + 12), _mm_unpackhi_epi16(high, _mm_setzero_si128()));
+                read += 16;
+                written += 16;
+                continue;
+            }
+
+            // a sequence crossing the end of the block is left for the next one
+            const size_t blockEnd = FindUtf8SequenceStart(input, length, read + 16);
+
+            const TranscodingResult result = scalar::TranscodeUtf8ToUtf32(
+                input + read, blockEnd - read, output + written, capacity - written);
+
+            read += result.read;
+            written += result.written;
+            if (result.isInvalid || read < blockEnd)
+                return { read, written, result.isInvalid };
+        }
+
+        const TranscodingResult result = scalar::TranscodeUtf8ToUtf32(
+            input + read, length - read, output + written, capacity - written);
+
+        return { read + result.read, written + result.written, result.isInvalid };
+    }
+}
+
+#endif
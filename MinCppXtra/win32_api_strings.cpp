@@ -13,26 +13,107 @@
 
 #include "internal/pch.h"
 #include "win32_api_strings.hpp"
+#include "internal/utf_kernels.h"
 
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+#include <numeric>
+#include <thread>
 #include <vector>
 #include <utf8/cpp20.h>
 
 namespace mincpp
 {
-    Win32ApiStrings::StaticInitializer s_initializer;
+    Win32ApiStrings::Acceleration Win32ApiStrings::GetAcceleration() noexcept
+    {
+        return GetUtfKernelsAcceleration();
+    }
 
-    Win32ApiStrings::StaticInitializer::StaticInitializer()
+    void Win32ApiStrings::LimitAcceleration(Acceleration limit) noexcept
     {
-        // allow UTF-8 in standard output
-        SetConsoleOutputCP(CP_UTF8);
+        LimitUtfKernelsAcceleration(limit);
+    }
+
+    namespace
+    {
+        /// <summary>
+        /// Lets utfcpp report the invalid code unit in wide text as it always did,
+        /// which is UTF-16 or UTF-32 depending on the width of wchar_t.
+        /// </summary>
+        void ReportInvalidWide(const wchar_t* begin, const wchar_t* end)
+        {
+            if constexpr (IsWideCharUtf16)
+            {
+                utf8::utf16to8(std::u16string_view(
+                    reinterpret_cast<const char16_t*>(begin), reinterpret_cast<const char16_t*>(end)));
+            }
+            else
+            {
+                utf8::utf32to8(std::u32string_view(
+                    reinterpret_cast<const char32_t*>(begin), reinterpret_cast<const char32_t*>(end)));
+            }
+        }
+
+        /// <summary>
+        /// Transcodes wide text to UTF-8 into a string of any allocator.
+        /// </summary>
+        template <typename String>
+        void TranscodeWideToString(const wchar_t* widestr, size_t wideCharCount, String& utf8str)
+        {
+            utf8str.resize(CountUtf8OfWide(widestr, wideCharCount));
+            const TranscodingResult result =
+                TranscodeWideToUtf8(widestr, wideCharCount, utf8str.data(), utf8str.size());
+
+            if (result.isInvalid)
+                ReportInvalidWide(widestr + result.read, widestr + wideCharCount);
+        }
+
+        /// <summary>
+        /// Transcodes UTF-8 text to wide text into a wide-string of any allocator,
+        /// up to the first invalid sequence.
+        /// </summary>
+        /// <returns>The position of the invalid sequence, or std::string_view::npos.</returns>
+        template <typename WideString>
+        size_t TranscodeUtf8ToWideString(std::string_view utf8str, WideString& widestr)
+        {
+            widestr.resize(CountWideOfUtf8(utf8str.data(), utf8str.length()));
+            const TranscodingResult result = TranscodeUtf8ToWide(
+                utf8str.data(),
+                utf8str.length(),
+                widestr.data(),
+                widestr.size());
+
+            if (result.isInvalid)
+            {
+                widestr.resize(result.written);
+                return result.read;
+            }
+            return std::string_view::npos;
+        }
+
+        /// <summary>
+        /// Lets utfcpp report the invalid sequence in UTF-8 text as it always did.
+        /// </summary>
+        void ReportInvalidUtf8(std::string_view utf8str, size_t invalidPosition)
+        {
+            auto iter = utf8str.begin() + invalidPosition;
+            utf8::next(iter, utf8str.end());
+        }
     }
 
     std::string Win32ApiStrings::ToUtf8(const wchar_t* utf16str, size_t wideCharCount)
     {
-        static_assert(sizeof(wchar_t) == sizeof(char16_t));
-        const auto begin = reinterpret_cast<const char16_t*>(utf16str);
-        const auto end = begin + wideCharCount;
-        return utf8::utf16to8(std::u16string_view(begin, end));
+        std::string utf8str;
+        TranscodeWideToString(utf16str, wideCharCount, utf8str);
+        return utf8str;
+    }
+
+    std::pmr::string Win32ApiStrings::ToUtf8(std::wstring_view widestr, std::pmr::memory_resource* resource)
+    {
+        std::pmr::string utf8str(resource);
+        TranscodeWideToString(widestr.data(), widestr.length(), utf8str);
+        return utf8str;
     }
 
     std::string Win32ApiStrings::ToUtf8(const wchar_t* utf16str)
@@ -40,13 +121,139 @@ namespace mincpp
         return ToUtf8(utf16str, wcslen(utf16str));
     }
 
+    std::string Win32ApiStrings::ToUtf8(std::wstring_view widestr)
+    {
+        return ToUtf8(widestr.data(), widestr.length());
+    }
+
+    size_t Win32ApiStrings::RequiredUtf8Length(std::wstring_view utf16str) noexcept
+    {
+        return CountUtf8OfWide(utf16str.data(), utf16str.length());
+    }
+
+    size_t Win32ApiStrings::ToUtf8Into(std::wstring_view utf16str, std::span<char> utf8buffer)
+    {
+        const wchar_t* const begin = utf16str.data();
+        const TranscodingResult result =
+            TranscodeWideToUtf8(begin, utf16str.length(), utf8buffer.data(), utf8buffer.size());
+
+        if (result.isInvalid)
+            ReportInvalidWide(begin + result.read, begin + utf16str.length());
+
+        // when the buffer is too small, count what is missing
+        if (result.read < utf16str.length())
+            return result.written + CountUtf8OfWide(begin + result.read, utf16str.length() - result.read);
+
+        return result.written;
+    }
+
+    size_t Win32ApiStrings::TryToUtf16(const std::string_view utf8str, std::wstring& utf16str)
+    {
+        return TranscodeUtf8ToWideString(utf8str, utf16str);
+    }
+
+    size_t Win32ApiStrings::RequiredUtf16Length(std::string_view utf8str) noexcept
+    {
+        return CountWideOfUtf8(utf8str.data(), utf8str.length());
+    }
+
+    size_t Win32ApiStrings::ToUtf16Into(std::string_view utf8str, std::span<wchar_t> utf16buffer)
+    {
+        const TranscodingResult result = TranscodeUtf8ToWide(
+            utf8str.data(),
+            utf8str.length(),
+            utf16buffer.data(),
+            utf16buffer.size());
+
+        if (result.isInvalid)
+            ReportInvalidUtf8(utf8str, result.read);
+
+        // when the buffer is too small, count what is missing
+        if (result.read < utf8str.length())
+            return result.written + CountWideOfUtf8(utf8str.data() + result.read, utf8str.length() - result.read);
+
+        return result.written;
+    }
+
     std::wstring Win32ApiStrings::ToUtf16(const std::string_view utf8str)
     {
-        std::u16string utf16str = utf8::utf8to16(utf8str);
-        static_assert(sizeof(wchar_t) == sizeof(char16_t));
-        const auto begin = reinterpret_cast<const wchar_t*>(utf16str.data());
-        const auto end = begin + utf16str.length();
-        return std::wstring(begin, end);
+        std::wstring utf16str;
+        const size_t invalidPosition = TranscodeUtf8ToWideString(utf8str, utf16str);
+        if (invalidPosition != std::string_view::npos)
+            ReportInvalidUtf8(utf8str, invalidPosition);
+
+        return utf16str;
+    }
+
+    std::pmr::wstring Win32ApiStrings::ToUtf16(std::string_view utf8str, std::pmr::memory_resource* resource)
+    {
+        std::pmr::wstring utf16str(resource);
+        const size_t invalidPosition = TranscodeUtf8ToWideString(utf8str, utf16str);
+        if (invalidPosition != std::string_view::npos)
+            ReportInvalidUtf8(utf8str, invalidPosition);
+
+        return utf16str;
+    }
+
+    bool Win32ApiStrings::IsValidUtf8(std::string_view utf8str) noexcept
+    {
+        return MeasureValidUtf8(utf8str.data(), utf8str.length()) == utf8str.length();
+    }
+
+    size_t Win32ApiStrings::FindInvalidUtf8(std::string_view utf8str) noexcept
+    {
+        const size_t validLength = MeasureValidUtf8(utf8str.data(), utf8str.length());
+        return validLength == utf8str.length() ? std::string_view::npos : validLength;
+    }
+
+    std::string Win32ApiStrings::ReplaceInvalidUtf8(std::string_view utf8str, char32_t replacement)
+    {
+        size_t position = MeasureValidUtf8(utf8str.data(), utf8str.length());
+        if (position == utf8str.length())
+            return std::string(utf8str);
+
+        std::string encodedReplacement;
+        utf8::append(replacement, encodedReplacement);
+
+        std::string result;
+        result.reserve(utf8str.length() + encodedReplacement.length());
+        result.append(utf8str.data(), position);
+        while (position < utf8str.length())
+        {
+            // skip the invalid sequence as utfcpp does
+            result.append(encodedReplacement);
+            const size_t sequenceLength = GetUtf8SequenceLength(utf8str[position]);
+            size_t sequenceEnd = position + 1;
+            while (sequenceEnd < utf8str.length()
+                && sequenceEnd - position < sequenceLength
+                && (utf8str[sequenceEnd] & 0xC0) == 0x80)
+            {
+                ++sequenceEnd;
+            }
+
+            if (sequenceLength == 0)
+            {
+                // invalid lead byte: only itself
+                ++position;
+            }
+            else if (sequenceEnd == utf8str.length() && sequenceEnd - position < sequenceLength)
+            {
+                // incomplete at the end: the rest
+                break;
+            }
+            else
+            {
+                // the lead byte and whatever continuation bytes follow it
+                ++position;
+                while (position < utf8str.length() && (utf8str[position] & 0xC0) == 0x80)
+                    ++position;
+            }
+
+            const size_t validLength = MeasureValidUtf8(utf8str.data() + position, utf8str.length() - position);
+            result.append(utf8str.data() + position, validLength);
+            position += validLength;
+        }
+        return result;
     }
 
     std::wstring Win32ApiStrings::ToUtf16(const std::u8string_view utf8str)
@@ -66,4 +273,138 @@ namespace mincpp
     {
         return ToUtf16(utf8str, strlen(utf8str));
     }
+
+    std::wstring Win32ApiStrings::ToWide(std::string_view utf8str)
+    {
+        return ToUtf16(utf8str);
+    }
+
+    std::wstring Win32ApiStrings::ToWide(const char* utf8str)
+    {
+        return ToUtf16(utf8str, strlen(utf8str));
+    }
+
+    namespace
+    {
+        // (a split moves back by 3 code units at most, so that chunks this long never collapse)
+        constexpr size_t s_minChunkLength = 16;
+
+        bool IsLeadSurrogate(wchar_t codeUnit) noexcept
+        {
+            return codeUnit >= 0xD800 && codeUnit <= 0xDBFF;
+        }
+
+        void RunTasks(
+            const TranscodingParallelism& parallelism, size_t taskCount, const std::function<void(size_t)>& task)
+        {
+            if (parallelism.executor)
+            {
+                parallelism.executor(taskCount, task);
+                return;
+            }
+
+            // the calling thread takes the first task, and the others are joined on return
+            std::vector<std::jthread> threads;
+            threads.reserve(taskCount - 1);
+            for (size_t idx = 1; idx < taskCount; ++idx)
+                threads.emplace_back(task, idx);
+
+            task(0);
+        }
+
+        /// <summary>
+        /// Transcodes text split into chunks in parallel. The lengths of the chunks in the output are
+        /// counted first, so that each one is then transcoded right into its place in the output.
+        /// </summary>
+        /// <returns>Whether the whole text was transcoded, otherwise it is invalid.</returns>
+        template <typename InputChar, typename OutputString, typename SplitFn, typename CountFn, typename TranscodeFn>
+        bool TranscodeInParallel(
+            const InputChar* input,
+            size_t length,
+            OutputString& output,
+            const TranscodingParallelism& parallelism,
+            SplitFn split,
+            CountFn count,
+            TranscodeFn transcode)
+        {
+            const size_t threadCount = parallelism.threadCount != 0
+                ? parallelism.threadCount
+                : std::max(1U, std::thread::hardware_concurrency());
+
+            const size_t taskCount = std::clamp<size_t>(length / s_minChunkLength, 1, threadCount);
+            std::vector<size_t> inputOffsets(taskCount + 1);
+            for (size_t idx = 1; idx < taskCount; ++idx)
+                inputOffsets[idx] = split(input, length, idx * (length / taskCount));
+
+            inputOffsets[taskCount] = length;
+
+            std::vector<size_t> outputOffsets(taskCount + 1);
+            RunTasks(parallelism, taskCount, [&](size_t idx) {
+                outputOffsets[idx + 1] = count(input + inputOffsets[idx], inputOffsets[idx + 1] - inputOffsets[idx]);
+            });
+            std::inclusive_scan(outputOffsets.begin(), outputOffsets.end(), outputOffsets.begin());
+            output.resize(outputOffsets[taskCount]);
+
+            // (not std::vector<bool>, whose elements cannot be written by different threads)
+            std::vector<uint8_t> isComplete(taskCount);
+            RunTasks(parallelism, taskCount, [&](size_t idx) {
+                const size_t chunkLength = inputOffsets[idx + 1] - inputOffsets[idx];
+                const TranscodingResult result = transcode(
+                    input + inputOffsets[idx],
+                    chunkLength,
+                    output.data() + outputOffsets[idx],
+                    outputOffsets[idx + 1] - outputOffsets[idx]);
+
+                isComplete[idx] = !result.isInvalid && result.read == chunkLength;
+            });
+            return std::all_of(isComplete.begin(), isComplete.end(), [](uint8_t flag) { return flag != 0; });
+        }
+    }
+
+    std::string Win32ApiStrings::ToUtf8Parallel(std::wstring_view utf16str, const TranscodingParallelism& parallelism)
+    {
+        if (utf16str.length() < parallelism.serialThreshold)
+            return ToUtf8(utf16str.data(), utf16str.length());
+
+        std::string utf8str;
+        const bool isValid = TranscodeInParallel(
+            utf16str.data(),
+            utf16str.length(),
+            utf8str,
+            parallelism,
+            [](const wchar_t* input, size_t, size_t position) {
+                // do not split a surrogate pair (which is not in valid UTF-32 anyway)
+                return IsLeadSurrogate(input[position - 1]) ? position - 1 : position;
+            },
+            CountUtf8OfWide,
+            TranscodeWideToUtf8);
+
+        // the serial path reports the first error just as usual
+        if (!isValid)
+            return ToUtf8(utf16str.data(), utf16str.length());
+
+        return utf8str;
+    }
+
+    std::wstring Win32ApiStrings::ToUtf16Parallel(std::string_view utf8str, const TranscodingParallelism& parallelism)
+    {
+        if (utf8str.length() < parallelism.serialThreshold)
+            return ToUtf16(utf8str);
+
+        std::wstring utf16str;
+        const bool isValid = TranscodeInParallel(
+            utf8str.data(),
+            utf8str.length(),
+            utf16str,
+            parallelism,
+            FindUtf8SequenceStart,
+            CountWideOfUtf8,
+            TranscodeUtf8ToWide);
+
+        // the serial path reports the first error just as usual
+        if (!isValid)
+            return ToUtf16(utf8str);
+
+        return utf16str;
+    }
 }
@@ -13,12 +13,48 @@
 
 #pragma once
 
+#include "small_string.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace mincpp
 {
+	/// <summary>
+	/// Settings for transcoding very large text on several threads.
+	/// </summary>
+	struct TranscodingParallelism
+	{
+		/// <summary>
+		/// Runs a count of tasks concurrently, each called with its index, and returns when all are complete.
+		/// </summary>
+		using Executor = std::function<void(size_t taskCount, const std::function<void(size_t taskIndex)>& task)>;
+
+		/// <summary>
+		/// The count of tasks to split the text into (0 = one per hardware thread).
+		/// </summary>
+		unsigned int threadCount = 0;
+
+		/// <summary>
+		/// The length of text (in code units) below which it is transcoded on the calling thread only.
+		/// </summary>
+		size_t serialThreshold = 1 << 20;
+
+		/// <summary>
+		/// Runs the tasks, such as in a thread pool. If not set, a thread is started for each task.
+		/// </summary>
+		Executor executor;
+	};
+
 	/// <summary>
 	/// Handles common tasks for text encoding when dealing with Win32 API.
+	/// Wide-chars are UTF-16 in Windows, but UTF-32 in Linux and others (where wchar_t has 32 bits),
+	/// so the routines for "UTF-16" transcode wide-strings in whichever encoding fits wchar_t.
+	/// Only transcoding of text is portable, as the routines for files use Win32 API.
 	/// </summary>
 	class Win32ApiStrings
 	{
@@ -32,6 +68,39 @@ namespace mincpp
 			StaticInitializer();
 		};
 
+		/// <summary>
+		/// Directions for transcoding files.
+		/// </summary>
+		enum class TranscodingDirection
+		{
+			Utf8ToUtf16,
+			Utf16ToUtf8
+		};
+
+		/// <summary>
+		/// Levels of hardware acceleration for the transcoding kernels.
+		/// </summary>
+		enum class Acceleration
+		{
+			None,
+			Sse2,
+			Avx2
+		};
+
+		/// <summary>
+		/// Gets the level of acceleration used for transcoding, which is the best
+		/// one the processor supports, unless limited by mincpp::Win32ApiStrings::LimitAcceleration.
+		/// </summary>
+		/// <returns>The level of acceleration in use.</returns>
+		static Acceleration GetAcceleration() noexcept;
+
+		/// <summary>
+		/// Limits the acceleration used for transcoding (such as for comparison in benchmarks).
+		/// The output does not depend on which level is in use.
+		/// </summary>
+		/// <param name="limit">The highest level of acceleration to use.</param>
+		static void LimitAcceleration(Acceleration limit) noexcept;
+
 		/// <summary>
 		/// Transcodes UTF-16 text to UTF-8.
 		/// </summary>
@@ -49,6 +118,22 @@ namespace mincpp
 		/// <returns>A UTF-8 encoded string.</returns>
 		static std::string ToUtf8(const wchar_t* utf16str, size_t wideCharCount);
 
+		/// <summary>
+		/// Transcodes wide text (UTF-16 in Windows, UTF-32 elsewhere) to UTF-8.
+		/// </summary>
+		/// <param name="widestr">A wide-string with text encoded as fits wchar_t.</param>
+		/// <returns>A UTF-8 encoded string.</returns>
+		static std::string ToUtf8(std::wstring_view widestr);
+
+		/// <summary>
+		/// Transcodes wide text (UTF-16 in Windows, UTF-32 elsewhere) to UTF-8,
+		/// into memory from the given resource (such as an arena).
+		/// </summary>
+		/// <param name="widestr">A wide-string with text encoded as fits wchar_t.</param>
+		/// <param name="resource">The memory resource for the returned string.</param>
+		/// <returns>A UTF-8 encoded string.</returns>
+		static std::pmr::string ToUtf8(std::wstring_view widestr, std::pmr::memory_resource* resource);
+
 		/// <summary>
 		/// Transcodes UTF-8 text to UTF-16.
 		/// </summary>
@@ -56,6 +141,50 @@ namespace mincpp
 		/// <returns>A UTF-16 encoded wide-string.</returns>
 		static std::wstring ToUtf16(const std::string_view utf8str);
 
+		/// <summary>
+		/// Transcodes UTF-8 text to UTF-16, into memory from the given resource (such as an arena).
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <param name="resource">The memory resource for the returned wide-string.</param>
+		/// <returns>A UTF-16 encoded wide-string.</returns>
+		static std::pmr::wstring ToUtf16(std::string_view utf8str, std::pmr::memory_resource* resource);
+
+		/// <summary>
+		/// Transcodes UTF-8 text to UTF-16, without throwing when the input is invalid.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <param name="utf16str">Receives the UTF-16 encoded text, up to the first invalid sequence.</param>
+		/// <returns>
+		/// The position of the first invalid (or incomplete) sequence in the input,
+		/// or std::string_view::npos when the whole input is valid.
+		/// </returns>
+		static size_t TryToUtf16(const std::string_view utf8str, std::wstring& utf16str);
+
+		/// <summary>
+		/// Tells whether UTF-8 text is valid, accepting the same as utfcpp.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <returns>Whether the whole text is valid.</returns>
+		static bool IsValidUtf8(std::string_view utf8str) noexcept;
+
+		/// <summary>
+		/// Finds the first invalid sequence in UTF-8 text, just like utf8::find_invalid.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <returns>
+		/// The position of the first invalid (or incomplete) sequence,
+		/// or std::string_view::npos when the whole text is valid.
+		/// </returns>
+		static size_t FindInvalidUtf8(std::string_view utf8str) noexcept;
+
+		/// <summary>
+		/// Replaces the invalid sequences in UTF-8 text, just like utf8::replace_invalid.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <param name="replacement">The code point to replace each invalid sequence with.</param>
+		/// <returns>A copy of the text where invalid sequences are replaced.</returns>
+		static std::string ReplaceInvalidUtf8(std::string_view utf8str, char32_t replacement = 0xFFFD);
+
 		/// <summary>
 		/// Transcodes UTF-8 text to UTF-16.
 		/// </summary>
@@ -80,6 +209,143 @@ namespace mincpp
 		/// <returns>A UTF-16 encoded wide-string.</returns>
 		static std::wstring ToUtf16(const char* utf8str, size_t charCount);
 
+		/// <summary>
+		/// Transcodes UTF-8 text to wide text (UTF-16 in Windows, UTF-32 elsewhere),
+		/// which is the same as mincpp::Win32ApiStrings::ToUtf16, but named for portable code.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <returns>A wide-string with text encoded as fits wchar_t.</returns>
+		static std::wstring ToWide(std::string_view utf8str);
+
+		/// <summary>
+		/// Transcodes UTF-8 text to wide text (UTF-16 in Windows, UTF-32 elsewhere).
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text and 0-terminated.</param>
+		/// <returns>A wide-string with text encoded as fits wchar_t.</returns>
+		static std::wstring ToWide(const char* utf8str);
+
+		/// <summary>
+		/// Transcodes UTF-16 text to UTF-8, splitting large text into chunks that are transcoded in parallel.
+		/// </summary>
+		/// <param name="utf16str">A wide-string with UTF-16 encoded text.</param>
+		/// <param name="parallelism">How to split the text and run the tasks.</param>
+		/// <returns>A UTF-8 encoded string, or the same error as mincpp::Win32ApiStrings::ToUtf8.</returns>
+		static std::string ToUtf8Parallel(std::wstring_view utf16str, const TranscodingParallelism& parallelism = {});
+
+		/// <summary>
+		/// Transcodes UTF-8 text to UTF-16, splitting large text into chunks that are transcoded in parallel.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <param name="parallelism">How to split the text and run the tasks.</param>
+		/// <returns>A UTF-16 encoded wide-string, or the same error as mincpp::Win32ApiStrings::ToUtf16.</returns>
+		static std::wstring ToUtf16Parallel(std::string_view utf8str, const TranscodingParallelism& parallelism = {});
+
+#ifdef _WIN32
+		/// <summary>
+		/// Transcodes a whole file, which is mapped into memory a window at a time (rather than read)
+		/// and written through a fixed-size buffer, so that memory use does not depend on its size.
+		/// UTF-16 is little-endian, and a byte order mark is transcoded like any other character.
+		/// </summary>
+		/// <param name="source">The file to transcode.</param>
+		/// <param name="destination">The file to create (or overwrite) with the transcoded text.</param>
+		/// <param name="direction">From which encoding to which.</param>
+		/// <exception cref="TraceableException">
+		/// Thrown when a file cannot be accessed, or at invalid text in the source (with its offset in bytes),
+		/// in which case the destination is left incomplete.
+		/// </exception>
+		static void TranscodeFile(
+			const std::filesystem::path& source,
+			const std::filesystem::path& destination,
+			TranscodingDirection direction);
+
+		/// <summary>
+		/// Validates a whole UTF-8 file, which is mapped into memory a window at a time (rather than read).
+		/// </summary>
+		/// <param name="path">The file to validate.</param>
+		/// <returns>
+		/// The offset of the first invalid (or incomplete) sequence in the file,
+		/// or std::string_view::npos when the whole file is valid.
+		/// </returns>
+		/// <exception cref="TraceableException">Thrown when the file cannot be accessed.</exception>
+		static size_t ValidateUtf8File(const std::filesystem::path& path);
+#endif
+
+		/// <summary>
+		/// Counts the chars required to transcode UTF-16 text to UTF-8.
+		/// </summary>
+		/// <param name="utf16str">A wide-string with UTF-16 encoded text.</param>
+		/// <returns>The count of chars, which is exact unless the input is invalid.</returns>
+		static size_t RequiredUtf8Length(std::wstring_view utf16str) noexcept;
+
+		/// <summary>
+		/// Counts the wide chars required to transcode UTF-8 text to UTF-16.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <returns>The count of wide chars, which is exact unless the input is invalid.</returns>
+		static size_t RequiredUtf16Length(std::string_view utf8str) noexcept;
+
+		/// <summary>
+		/// Transcodes UTF-16 text to UTF-8 into a buffer, without allocating memory.
+		/// </summary>
+		/// <param name="utf16str">A wide-string with UTF-16 encoded text.</param>
+		/// <param name="utf8buffer">Receives the UTF-8 encoded text (not terminated by '\0').</param>
+		/// <returns>
+		/// The count of chars written, unless it is greater than the size of the buffer,
+		/// which is then too small and not completely written, but the count required is returned.
+		/// </returns>
+		static size_t ToUtf8Into(std::wstring_view utf16str, std::span<char> utf8buffer);
+
+		/// <summary>
+		/// Transcodes UTF-8 text to UTF-16 into a buffer, without allocating memory.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <param name="utf16buffer">Receives the UTF-16 encoded text (not terminated by '\0').</param>
+		/// <returns>
+		/// The count of wide chars written, unless it is greater than the size of the buffer,
+		/// which is then too small and not completely written, but the count required is returned.
+		/// </returns>
+		static size_t ToUtf16Into(std::string_view utf8str, std::span<wchar_t> utf16buffer);
+
+		/// <summary>
+		/// Transcodes UTF-16 text to UTF-8 into a string with inline capacity,
+		/// which does not allocate memory as long as the capacity suffices.
+		/// </summary>
+		/// <param name="utf16str">A wide-string with UTF-16 encoded text.</param>
+		/// <param name="utf8str">Receives the UTF-8 encoded text.</param>
+		template <size_t InlineCapacity>
+		static void ToUtf8(std::wstring_view utf16str, SmallString<InlineCapacity>& utf8str)
+		{
+			// the capacity at hand is tried first, so that most texts are transcoded in a single pass
+			utf8str.Resize(utf8str.GetCapacity());
+			size_t length = ToUtf8Into(utf16str, std::span(utf8str.GetData(), utf8str.GetLength()));
+			if (length > utf8str.GetLength())
+			{
+				utf8str.Resize(length);
+				length = ToUtf8Into(utf16str, std::span(utf8str.GetData(), length));
+			}
+			utf8str.Resize(length);
+		}
+
+		/// <summary>
+		/// Transcodes UTF-8 text to UTF-16 into a wide-string with inline capacity,
+		/// which does not allocate memory as long as the capacity suffices.
+		/// </summary>
+		/// <param name="utf8str">A string with UTF-8 encoded text.</param>
+		/// <param name="utf16str">Receives the UTF-16 encoded text.</param>
+		template <size_t InlineCapacity>
+		static void ToUtf16(std::string_view utf8str, SmallWString<InlineCapacity>& utf16str)
+		{
+			// the capacity at hand is tried first, so that most texts are transcoded in a single pass
+			utf16str.Resize(utf16str.GetCapacity());
+			size_t length = ToUtf16Into(utf8str, std::span(utf16str.GetData(), utf16str.GetLength()));
+			if (length > utf16str.GetLength())
+			{
+				utf16str.Resize(length);
+				length = ToUtf16Into(utf8str, std::span(utf16str.GetData(), length));
+			}
+			utf16str.Resize(length);
+		}
+
 	private:
 
 		StaticInitializer s_initializer;
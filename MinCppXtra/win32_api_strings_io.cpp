@@ -0,0 +1,328 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+#include "internal/pch.h"
+#include "win32_api_strings.hpp"
+#include "internal/utf_kernels.h"
+#include "traceable_exception.hpp"
+#include "transcoding_streams.hpp"
+#include "win32_errors.hpp"
+
+#include <algorithm>
+
+// The parts of Win32ApiStrings that depend on Win32 API (as opposed to the portable transcoding)
+
+namespace mincpp
+{
+    Win32ApiStrings::StaticInitializer s_initializer;
+
+    Win32ApiStrings::StaticInitializer::StaticInitializer()
+    {
+        // allow UTF-8 in standard output
+        SetConsoleOutputCP(CP_UTF8);
+    }
+
+    namespace
+    {
+        // (a multiple of the allocation granularity for views of files, which is 64 KB)
+        constexpr size_t s_mappedWindowSize = 64 << 20;
+
+        constexpr size_t s_writeBufferSize = 1 << 20;
+
+        /// <summary>
+        /// Maps a file into memory for sequential reading, one window at a time,
+        /// so that memory use does not depend on the size of the file.
+        /// </summary>
+        class MappedFileReader
+        {
+        private:
+
+            HANDLE m_fileHandle;
+            HANDLE m_mappingHandle;
+            uint64_t m_fileSize;
+            uint64_t m_offset;
+            void* m_view;
+
+        public:
+
+            MappedFileReader(const std::filesystem::path& path)
+                : m_mappingHandle(nullptr)
+                , m_fileSize(0)
+                , m_offset(0)
+                , m_view(nullptr)
+            {
+                m_fileHandle = CreateFileW(
+                    path.c_str(),
+                    GENERIC_READ,
+                    FILE_SHARE_READ,
+                    nullptr,
+                    OPEN_EXISTING,
+                    FILE_FLAG_SEQUENTIAL_SCAN,
+                    nullptr);
+
+                if (m_fileHandle == INVALID_HANDLE_VALUE)
+                {
+                    throw TraceableException(
+                        Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(CreateFileW)));
+                }
+
+                LARGE_INTEGER fileSize{};
+                if (GetFileSizeEx(m_fileHandle, &fileSize) == FALSE)
+                {
+                    const DWORD errCode = GetLastError();
+                    CloseHandle(m_fileHandle);
+                    throw TraceableException(Win32Errors::GetErrorMessage(errCode, NAMEOF(GetFileSizeEx)));
+                }
+                m_fileSize = static_cast<uint64_t>(fileSize.QuadPart);
+
+                // (an empty file cannot be mapped)
+                if (m_fileSize != 0)
+                {
+                    m_mappingHandle = CreateFileMappingW(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if (m_mappingHandle == nullptr)
+                    {
+                        const DWORD errCode = GetLastError();
+                        CloseHandle(m_fileHandle);
+                        throw TraceableException(Win32Errors::GetErrorMessage(errCode, NAMEOF(CreateFileMappingW)));
+                    }
+                }
+            }
+
+            ~MappedFileReader()
+            {
+                if (m_view != nullptr)
+                {
+                    UnmapViewOfFile(m_view);
+                }
+                if (m_mappingHandle != nullptr)
+                {
+                    CloseHandle(m_mappingHandle);
+                }
+                CloseHandle(m_fileHandle);
+            }
+
+            MappedFileReader(const MappedFileReader&) = delete;
+            MappedFileReader& operator=(const MappedFileReader&) = delete;
+
+            uint64_t GetFileSize() const noexcept
+            {
+                return m_fileSize;
+            }
+
+            /// <summary>
+            /// Maps the next window of the file, and unmaps the previous one.
+            /// </summary>
+            /// <returns>The contents of the window, which are empty at the end of the file.</returns>
+            std::string_view MapNextWindow()
+            {
+                if (m_view != nullptr)
+                {
+                    UnmapViewOfFile(m_view);
+                    m_view = nullptr;
+                }
+
+                if (m_offset == m_fileSize)
+                    return {};
+
+                const auto windowSize =
+                    static_cast<size_t>(std::min<uint64_t>(s_mappedWindowSize, m_fileSize - m_offset));
+
+                m_view = MapViewOfFile(
+                    m_mappingHandle,
+                    FILE_MAP_READ,
+                    static_cast<DWORD>(m_offset >> 32),
+                    static_cast<DWORD>(m_offset),
+                    windowSize);
+
+                if (m_view == nullptr)
+                {
+                    throw TraceableException(
+                        Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(MapViewOfFile)));
+                }
+
+                // read ahead, because the window is about to be scanned from start to end
+                WIN32_MEMORY_RANGE_ENTRY range{ m_view, windowSize };
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+
+                m_offset += windowSize;
+                return std::string_view(static_cast<const char*>(m_view), windowSize);
+            }
+        };
+
+        /// <summary>
+        /// Writes a file sequentially through a buffer of fixed size.
+        /// </summary>
+        class BufferedFileWriter
+        {
+        private:
+
+            HANDLE m_fileHandle;
+            std::unique_ptr<char[]> m_buffer;
+            size_t m_length;
+
+        public:
+
+            BufferedFileWriter(const std::filesystem::path& path)
+                : m_buffer(std::make_unique_for_overwrite<char[]>(s_writeBufferSize))
+                , m_length(0)
+            {
+                m_fileHandle = CreateFileW(
+                    path.c_str(),
+                    GENERIC_WRITE,
+                    0,
+                    nullptr,
+                    CREATE_ALWAYS,
+                    FILE_FLAG_SEQUENTIAL_SCAN,
+                    nullptr);
+
+                if (m_fileHandle == INVALID_HANDLE_VALUE)
+                {
+                    throw TraceableException(
+                        Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(CreateFileW)));
+                }
+            }
+
+            ~BufferedFileWriter()
+            {
+                CloseHandle(m_fileHandle);
+            }
+
+            BufferedFileWriter(const BufferedFileWriter&) = delete;
+            BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+            /// <summary>
+            /// Gets the free space in the buffer, which is flushed first when nearly full,
+            /// so that there is always room for a code point at least.
+            /// </summary>
+            template <typename CharType>
+            std::span<CharType> GetFreeSpace()
+            {
+                if (s_writeBufferSize - m_length < 64)
+                    Flush();
+
+                return std::span(
+                    reinterpret_cast<CharType*>(m_buffer.get() + m_length),
+                    (s_writeBufferSize - m_length) / sizeof(CharType));
+            }
+
+            /// <summary>
+            /// Takes what was written into the free space of the buffer.
+            /// </summary>
+            template <typename CharType>
+            void Commit(size_t count) noexcept
+            {
+                m_length += count * sizeof(CharType);
+            }
+
+            void Flush()
+            {
+                DWORD writtenSize;
+                if (m_length != 0
+                    && WriteFile(m_fileHandle, m_buffer.get(), static_cast<DWORD>(m_length), &writtenSize, nullptr) == FALSE)
+                {
+                    throw TraceableException(Win32Errors::GetErrorMessage(GetLastError(), NAMEOF(WriteFile)));
+                }
+                m_length = 0;
+            }
+        };
+
+        [[noreturn]] void ThrowInvalidText(
+            const std::filesystem::path& path, std::string_view encoding, uint64_t offset)
+        {
+            throw TraceableException("Invalid {} at byte {} of file {}", encoding, offset, path.string());
+        }
+
+        template <typename StreamType, typename InputChar, typename OutputChar>
+        void TranscodeMappedFile(
+            const std::filesystem::path& source,
+            const std::filesystem::path& destination,
+            std::string_view sourceEncoding)
+        {
+            MappedFileReader reader(source);
+            BufferedFileWriter writer(destination);
+            StreamType stream;
+            for (std::string_view window = reader.MapNextWindow(); !window.empty(); window = reader.MapNextWindow())
+            {
+                // (a trailing odd byte is left out, and then taken as invalid)
+                std::basic_string_view<InputChar> input(
+                    reinterpret_cast<const InputChar*>(window.data()), window.size() / sizeof(InputChar));
+
+                while (!input.empty())
+                {
+                    const TranscodingProgress progress = stream.Transcode(input, writer.GetFreeSpace<OutputChar>());
+                    writer.Commit<OutputChar>(progress.written);
+                    input.remove_prefix(progress.read);
+                    if (progress.isInvalid)
+                        ThrowInvalidText(source, sourceEncoding, stream.GetPosition() * sizeof(InputChar));
+                }
+            }
+
+            if (!stream.Finish() || reader.GetFileSize() % sizeof(InputChar) != 0)
+                ThrowInvalidText(source, sourceEncoding, stream.GetPosition() * sizeof(InputChar));
+
+            writer.Flush();
+        }
+    }
+
+    void Win32ApiStrings::TranscodeFile(
+        const std::filesystem::path& source,
+        const std::filesystem::path& destination,
+        TranscodingDirection direction)
+    {
+        switch (direction)
+        {
+        case TranscodingDirection::Utf8ToUtf16:
+            TranscodeMappedFile<Utf8ToUtf16Stream, char, wchar_t>(source, destination, "UTF-8");
+            break;
+        case TranscodingDirection::Utf16ToUtf8:
+            TranscodeMappedFile<Utf16ToUtf8Stream, wchar_t, char>(source, destination, "UTF-16");
+            break;
+        }
+    }
+
+    size_t Win32ApiStrings::ValidateUtf8File(const std::filesystem::path& path)
+    {
+        MappedFileReader reader(path);
+        uint64_t windowOffset = 0;
+        char pendingBytes[4];
+        size_t pendingCount = 0;
+        for (std::string_view window = reader.MapNextWindow(); !window.empty(); window = reader.MapNextWindow())
+        {
+            // complete the sequence split by the previous window (which only the last one is too short for)
+            if (pendingCount != 0)
+            {
+                const size_t sequenceLength = GetUtf8SequenceLength(pendingBytes[0]);
+                const size_t available = std::min(sequenceLength - pendingCount, window.length());
+                std::copy_n(window.data(), available, pendingBytes + pendingCount);
+                if (MeasureValidUtf8(pendingBytes, pendingCount + available) != sequenceLength)
+                    return static_cast<size_t>(windowOffset - pendingCount);
+
+                window.remove_prefix(available);
+                windowOffset += available;
+                pendingCount = 0;
+            }
+
+            // hold back a sequence at the end, whose remaining bytes are in the next window
+            const size_t tailLength = MeasureIncompleteUtf8Tail(window.data(), window.length());
+            const size_t bodyLength = window.length() - tailLength;
+            const size_t validLength = MeasureValidUtf8(window.data(), bodyLength);
+            if (validLength < bodyLength)
+                return static_cast<size_t>(windowOffset + validLength);
+
+            std::copy_n(window.data() + bodyLength, tailLength, pendingBytes);
+            pendingCount = tailLength;
+            windowOffset += window.length();
+        }
+        return pendingCount == 0 ? std::string_view::npos : static_cast<size_t>(windowOffset - pendingCount);
+    }
+}
@@ -15,32 +15,400 @@
 #include "win32_errors.hpp"
 #include "win32_api_strings.hpp"
 
-#include <sstream>
-#include <comdef.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <string_view>
 
 namespace mincpp
 {
+    // codes whose messages are formatted up front, as soon as the first message is needed
+    static constexpr uint32_t COMMON_WIN32_ERRORS[] = {
+        ERROR_SUCCESS,
+        ERROR_INVALID_FUNCTION,
+        ERROR_FILE_NOT_FOUND,
+        ERROR_PATH_NOT_FOUND,
+        ERROR_TOO_MANY_OPEN_FILES,
+        ERROR_ACCESS_DENIED,
+        ERROR_INVALID_HANDLE,
+        ERROR_NOT_ENOUGH_MEMORY,
+        ERROR_OUTOFMEMORY,
+        ERROR_WRITE_PROTECT,
+        ERROR_SHARING_VIOLATION,
+        ERROR_LOCK_VIOLATION,
+        ERROR_HANDLE_EOF,
+        ERROR_NOT_SUPPORTED,
+        ERROR_FILE_EXISTS,
+        ERROR_INVALID_PARAMETER,
+        ERROR_BROKEN_PIPE,
+        ERROR_DISK_FULL,
+        ERROR_INSUFFICIENT_BUFFER,
+        ERROR_INVALID_NAME,
+        ERROR_MOD_NOT_FOUND,
+        ERROR_PROC_NOT_FOUND,
+        ERROR_DIR_NOT_EMPTY,
+        ERROR_BAD_PATHNAME,
+        ERROR_ALREADY_EXISTS,
+        ERROR_FILENAME_EXCED_RANGE,
+        ERROR_ENVVAR_NOT_FOUND,
+        ERROR_NO_DATA,
+        ERROR_PIPE_NOT_CONNECTED,
+        ERROR_MORE_DATA,
+        ERROR_NO_MORE_ITEMS,
+        ERROR_DIRECTORY,
+        ERROR_OPERATION_ABORTED,
+        ERROR_IO_INCOMPLETE,
+        ERROR_IO_PENDING,
+        ERROR_NOACCESS,
+        ERROR_STACK_OVERFLOW,
+        ERROR_INVALID_FLAGS,
+        ERROR_NO_UNICODE_TRANSLATION,
+        ERROR_PRIVILEGE_NOT_HELD,
+        ERROR_TIMEOUT,
+        ERROR_CANCELLED,
+        ERROR_NOT_FOUND,
+    };
+
+    // (those mapped from Win32 errors above are left out)
+    static constexpr HRESULT COMMON_HRESULTS[] = {
+        E_UNEXPECTED,
+        E_NOTIMPL,
+        E_NOINTERFACE,
+        E_POINTER,
+        E_ABORT,
+        E_FAIL,
+        E_PENDING,
+        E_BOUNDS,
+    };
+
+    // the messages of other codes are added as they show up, until the catalog is full
+    static constexpr uint32_t CATALOG_INDEX_BITS = 10;
+    static constexpr size_t CATALOG_CAPACITY = size_t{ 1 } << CATALOG_INDEX_BITS;
+
+    // beyond this, a code is taken as absent, so that a full catalog does not cost a scan of it
+    static constexpr size_t CATALOG_MAX_PROBE_COUNT = 16;
+
+    static_assert(std::size(COMMON_WIN32_ERRORS) + std::size(COMMON_HRESULTS) < CATALOG_CAPACITY / 4,
+                  "common codes must leave room for the others");
+
+    // the kind of code goes into the upper half of the key, which is then never zero
+    enum class MessageKind : uint64_t
+    {
+        System = 1,
+        Errno = 2
+    };
+
+    // immutable once published, so the key and its text show up together
+    struct CatalogEntry
+    {
+        uint64_t key;
+        std::string text;
+    };
+
+    static std::atomic<const CatalogEntry*> s_catalog[CATALOG_CAPACITY]; // null when free
+
+    // the entries live as long as the process
+    static struct CatalogRelease
+    {
+        ~CatalogRelease()
+        {
+            for (auto& entry : s_catalog)
+            {
+                delete entry.exchange(nullptr, std::memory_order_acq_rel);
+            }
+        }
+    } s_catalogRelease;
+
+    static uint64_t ToCatalogKey(MessageKind kind, uint32_t code) noexcept
+    {
+        return (static_cast<uint64_t>(kind) << 32) | code;
+    }
+
+    static size_t ToFirstIndex(uint64_t key) noexcept
+    {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - CATALOG_INDEX_BITS));
+    }
+
+    /// <summary>
+    /// Looks up the text for a key in the catalog, and formats it when not found.
+    /// The text is formatted before an entry is claimed for it, so a failure leaves no trace.
+    /// </summary>
+    /// <returns>
+    /// The text in the catalog, or else in the scratch string
+    /// (when there is no free entry among the first ones probed).
+    /// </returns>
+    template <typename FormatText>
+    static std::string_view LookUpText(uint64_t key, std::string& scratch, const FormatText& formatText)
+    {
+        std::unique_ptr<CatalogEntry> newEntry; // formatted once a free entry is found
+
+        for (size_t probe = 0; probe < CATALOG_MAX_PROBE_COUNT; ++probe)
+        {
+            auto& slot = s_catalog[(ToFirstIndex(key) + probe) & (CATALOG_CAPACITY - 1)];
+            const CatalogEntry* entry = slot.load(std::memory_order_acquire);
+            if (entry == nullptr)
+            {
+                if (!newEntry)
+                {
+                    newEntry.reset(new CatalogEntry{ key, formatText() });
+                }
+
+                if (slot.compare_exchange_strong(entry, newEntry.get(), std::memory_order_acq_rel))
+                {
+                    return newEntry.release()->text;
+                }
+                // (another thread has just published its entry here)
+            }
+
+            if (entry->key == key)
+            {
+                return entry->text;
+            }
+        }
+
+        scratch = newEntry ? std::move(newEntry->text) : formatText();
+        return scratch;
+    }
+
+    /// <summary>
+    /// Queries the text of the system for an HRESULT (empty when there is none).
+    /// </summary>
+    static std::string QuerySystemText(HRESULT hr)
+    {
+        wchar_t* buffer = nullptr;
+        const DWORD length = FormatMessageW(
+            FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+            nullptr,
+            static_cast<DWORD>(hr),
+            MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+            reinterpret_cast<wchar_t*>(&buffer),
+            0,
+            nullptr);
+
+        if (length == 0)
+            return std::string();
+
+        std::unique_ptr<wchar_t, decltype(&LocalFree)> bufferOwner(buffer, &LocalFree);
+
+        // just like _com_error, drop the line break at the end
+        std::wstring_view text(buffer, length);
+        if (text.ends_with(L'\n'))
+            text.remove_suffix(1);
+        if (text.ends_with(L'\r'))
+            text.remove_suffix(1);
+
+        return Win32ApiStrings::ToUtf8(text);
+    }
+
+    static std::string_view LookUpSystemText(HRESULT hr, std::string& scratch)
+    {
+        return LookUpText(
+            ToCatalogKey(MessageKind::System, static_cast<uint32_t>(hr)),
+            scratch,
+            [hr]() { return QuerySystemText(hr); });
+    }
+
+    static void PrecomputeCommonTexts()
+    {
+        std::string scratch;
+        for (uint32_t errCode : COMMON_WIN32_ERRORS)
+        {
+            LookUpSystemText(HRESULT_FROM_WIN32(errCode), scratch);
+        }
+        for (HRESULT hr : COMMON_HRESULTS)
+        {
+            LookUpSystemText(hr, scratch);
+        }
+    }
+
+    static std::string_view GetSystemText(HRESULT hr, std::string& scratch)
+    {
+        [[maybe_unused]] static const bool isPrecomputed = (PrecomputeCommonTexts(), true);
+        return LookUpSystemText(hr, scratch);
+    }
+
+#ifndef _WIN32
+    // strerror_r either returns the text (GNU) or fills the buffer (POSIX)
+    [[maybe_unused]] static const char* GetStrErrorText(const char* text, const char*) noexcept
+    {
+        return text;
+    }
+
+    [[maybe_unused]] static const char* GetStrErrorText(int result, const char* buffer) noexcept
+    {
+        return result == 0 ? buffer : "";
+    }
+#endif
+
+    static std::string QueryErrnoText(int errnum)
+    {
+        char buffer[256] = {};
+#ifdef _WIN32
+        if (strerror_s(buffer, std::size(buffer), errnum) != 0)
+            return std::string();
+
+        return std::string(buffer);
+#else
+        return std::string(GetStrErrorText(strerror_r(errnum, buffer, std::size(buffer)), buffer));
+#endif
+    }
+
+    static std::string_view GetErrnoText(int errnum, std::string& scratch)
+    {
+        return LookUpText(
+            ToCatalogKey(MessageKind::Errno, static_cast<uint32_t>(errnum)),
+            scratch,
+            [errnum]() { return QueryErrnoText(errnum); });
+    }
+
+    template <typename OutputIterator>
+    static OutputIterator WriteSystemText(HRESULT hr, OutputIterator out)
+    {
+        std::string scratch;
+        const std::string_view text = GetSystemText(hr, scratch);
+        if (text.empty())
+            return std::format_to(out, "Unknown error 0x{:X}", static_cast<uint32_t>(hr));
+
+        return std::copy(text.begin(), text.end(), out);
+    }
+
+    template <typename OutputIterator>
+    static OutputIterator WriteErrnoText(int errnum, OutputIterator out)
+    {
+        std::string scratch;
+        const std::string_view text = GetErrnoText(errnum, scratch);
+        if (text.empty())
+            return std::format_to(out, "Unknown error {}", errnum);
+
+        return std::copy(text.begin(), text.end(), out);
+    }
+
+    template <typename OutputIterator>
+    static OutputIterator FormatErrorMessage(uint32_t errCode, const char* funcName, OutputIterator out)
+    {
+        if (funcName != nullptr && funcName[0] != 0)
+            out = std::format_to(out, "{} returned error {}: ", funcName, errCode);
+        else
+            out = std::format_to(out, "Win32 API error code {}: ", errCode);
+
+        return WriteSystemText(HRESULT_FROM_WIN32(errCode), out);
+    }
+
+    template <typename OutputIterator>
+    static OutputIterator FormatErrnoMessage(int errnum, const char* funcName, OutputIterator out)
+    {
+        if (funcName != nullptr && funcName[0] != 0)
+            out = std::format_to(out, "{} returned errno {}: ", funcName, errnum);
+        else
+            out = std::format_to(out, "errno {}: ", errnum);
+
+        return WriteErrnoText(errnum, out);
+    }
+
+    class Win32ErrorCategory : public std::error_category
+    {
+    public:
+
+        const char* name() const noexcept override
+        {
+            return "win32";
+        }
+
+        std::string message(int errCode) const override
+        {
+            std::string message;
+            WriteSystemText(HRESULT_FROM_WIN32(static_cast<uint32_t>(errCode)), std::back_inserter(message));
+            return message;
+        }
+
+        std::error_condition default_error_condition(int errCode) const noexcept override
+        {
+            return std::system_category().default_error_condition(errCode);
+        }
+    };
+
+    class ErrnoCategory : public std::error_category
+    {
+    public:
+
+        const char* name() const noexcept override
+        {
+            return "errno";
+        }
+
+        std::string message(int errnum) const override
+        {
+            std::string message;
+            WriteErrnoText(errnum, std::back_inserter(message));
+            return message;
+        }
+
+        std::error_condition default_error_condition(int errnum) const noexcept override
+        {
+            return std::error_condition(errnum, std::generic_category());
+        }
+    };
+
+    static const Win32ErrorCategory s_win32ErrorCategory;
+    static const ErrnoCategory s_errnoCategory;
+
     std::ostream& Win32Errors::AppendErrorMessage(
         uint32_t errCode,
         const char* funcName,
         std::ostream& oss)
     {
-        if (funcName != nullptr && funcName[0] != 0)
-            oss << funcName << " returned error ";
-        else
-            oss << "Win32 API error code ";
+        FormatErrorMessage(errCode, funcName, std::ostreambuf_iterator<char>(oss));
+        return oss;
+    }
 
-        oss << errCode;
+    std::string Win32Errors::GetErrorMessage(uint32_t errCode, const char* funcName)
+    {
+        std::string message;
+        FormatErrorMessage(errCode, funcName, std::back_inserter(message));
+        return message;
+    }
 
-        HRESULT hr = HRESULT_FROM_WIN32(errCode);
-        _com_error err(hr);
-        return oss << ": " << Win32ApiStrings::ToUtf8(err.ErrorMessage());
+    std::pmr::string Win32Errors::GetErrorMessage(
+        uint32_t errCode,
+        const char* funcName,
+        std::pmr::memory_resource* resource)
+    {
+        std::pmr::string message(resource);
+        FormatErrorMessage(errCode, funcName, std::back_inserter(message));
+        return message;
     }
 
-    std::string Win32Errors::GetErrorMessage(uint32_t errCode, const char* funcName)
+    std::ostream& Win32Errors::AppendErrnoMessage(
+        int errnum,
+        const char* funcName,
+        std::ostream& oss)
+    {
+        FormatErrnoMessage(errnum, funcName, std::ostreambuf_iterator<char>(oss));
+        return oss;
+    }
+
+    std::string Win32Errors::GetErrnoMessage(int errnum, const char* funcName)
+    {
+        std::string message;
+        FormatErrnoMessage(errnum, funcName, std::back_inserter(message));
+        return message;
+    }
+
+    const std::error_category& Win32Errors::GetCategory() noexcept
+    {
+        return s_win32ErrorCategory;
+    }
+
+    const std::error_category& Win32Errors::GetErrnoCategory() noexcept
+    {
+        return s_errnoCategory;
+    }
+
+    std::error_code Win32Errors::MakeErrorCode(uint32_t errCode) noexcept
     {
-        std::ostringstream oss;
-        AppendErrorMessage(errCode, funcName, oss);
-        return oss.str();
+        return std::error_code(static_cast<int>(errCode), s_win32ErrorCategory);
     }
-}
\ No newline at end of file
+}
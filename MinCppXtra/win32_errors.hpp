@@ -14,10 +14,19 @@
 #pragma once
 
 #include <cinttypes>
+#include <memory_resource>
 #include <ostream>
+#include <string>
+#include <system_error>
 
 namespace mincpp
 {
+	/// <summary>
+	/// Generates messages for error codes.
+	/// The texts of the system are kept in a process-wide catalog once formatted,
+	/// with those of the most common codes formatted up front, so that failing
+	/// repeatedly with the same error does not pay for FormatMessage every time.
+	/// </summary>
 	class Win32Errors
 	{
     public:
@@ -28,5 +37,48 @@ namespace mincpp
             std::ostream& oss);
 
         static std::string GetErrorMessage(uint32_t errCode, const char* funcName);
+
+        /// <summary>
+        /// Gets the message for an error code into memory from the given resource (such as an arena).
+        /// </summary>
+        static std::pmr::string GetErrorMessage(
+            uint32_t errCode,
+            const char* funcName,
+            std::pmr::memory_resource* resource);
+
+        /// <summary>
+        /// Appends the message for an errno value (as given by strerror) to a stream.
+        /// </summary>
+        /// <param name="errnum">The errno value.</param>
+        /// <param name="funcName">The function that failed, if any.</param>
+        /// <param name="oss">The output stream.</param>
+        /// <returns>The same output stream.</returns>
+        static std::ostream& AppendErrnoMessage(
+            int errnum,
+            const char* funcName,
+            std::ostream& oss);
+
+        /// <summary>
+        /// Gets the message for an errno value (as given by strerror).
+        /// </summary>
+        static std::string GetErrnoMessage(int errnum, const char* funcName);
+
+        /// <summary>
+        /// Gets the category of Win32 error codes (and HRESULT's), whose messages come from the catalog.
+        /// Its codes are equivalent to those of std::errc where the system has a match.
+        /// </summary>
+        static const std::error_category& GetCategory() noexcept;
+
+        /// <summary>
+        /// Gets the category of errno values, whose messages come from the catalog.
+        /// Its codes are equivalent to those of std::errc.
+        /// </summary>
+        static const std::error_category& GetErrnoCategory() noexcept;
+
+        /// <summary>
+        /// Makes an error code of the Win32 category.
+        /// </summary>
+        /// <param name="errCode">The Win32 error code (or HRESULT).</param>
+        static std::error_code MakeErrorCode(uint32_t errCode) noexcept;
 	};
 }
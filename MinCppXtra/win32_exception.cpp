@@ -18,6 +18,7 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #define ADD_MESSAGE(map, code) map[code] = #code
 
@@ -131,12 +132,53 @@ namespace mincpp
 #   define ENABLE_STACK_TRACE true
 #endif
 
-    Win32Exception::Win32Exception(const void* exceptionPointers)
+    /// <summary>
+    /// Makes a key for the address where an exception was raised, which is stable
+    /// across runs of the same build, because it is relative to the module.
+    /// </summary>
+    /// <returns>The key, or zero when there is no address.</returns>
+    static uint64_t MakeFaultSiteKey(const EXCEPTION_RECORD* exRecord)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(exRecord->ExceptionAddress);
+        if (address == 0)
+            return 0;
+
+        uint64_t moduleStamp = 0;
+        uintptr_t offset = address;
+        HMODULE module = nullptr;
+        if (GetModuleHandleExW(
+                GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                static_cast<LPCWSTR>(exRecord->ExceptionAddress),
+                &module))
+        {
+            // the image base is where its headers are mapped
+            const auto dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(module);
+            const auto ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(
+                reinterpret_cast<const char*>(module) + dosHeader->e_lfanew);
+
+            moduleStamp = ntHeaders->FileHeader.TimeDateStamp;
+            offset = address - reinterpret_cast<uintptr_t>(module);
+        }
+
+        // FNV-1a over the module stamp, the offset and the exception code
+        const uint64_t words[] = { moduleStamp, static_cast<uint64_t>(offset), exRecord->ExceptionCode };
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const unsigned char byte : std::string_view(reinterpret_cast<const char*>(words), sizeof words))
+        {
+            hash ^= byte;
+            hash *= 0x100000001b3ULL;
+        }
+        return hash != 0 ? hash : 1;
+    }
+
+    Win32Exception::Win32Exception(const void* exceptionPointers, const std::source_location& throwSite)
         : TraceableException(
             CreateExceptionMessage(
                 static_cast<const EXCEPTION_POINTERS*>(exceptionPointers)->ExceptionRecord),
             static_cast<const EXCEPTION_POINTERS*>(exceptionPointers)->ContextRecord,
-            ENABLE_STACK_TRACE)
+            ENABLE_STACK_TRACE,
+            MakeFaultSiteKey(static_cast<const EXCEPTION_POINTERS*>(exceptionPointers)->ExceptionRecord),
+            throwSite)
     {
     }
 }
\ No newline at end of file
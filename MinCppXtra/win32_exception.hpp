@@ -26,11 +26,18 @@ namespace mincpp
 
 		/// <summary>
 		/// Creates an instance of Win32Exception.
+		/// Its throw site key comes from the address where the exception was raised
+		/// (relative to its module), so translated faults are told apart by where they happen.
 		/// </summary>
 		/// <param name="exceptionPointers">
 		/// This is provided by the caught Win32 exception.
 		/// (The erased type is PEXCEPTION_POINTERS).
 		/// </param>
-		Win32Exception(const void* exceptionPointers);
+		/// <param name="throwSite">
+		/// Where in source code the exception is thrown (subclasses must forward it).
+		/// </param>
+		Win32Exception(
+			const void* exceptionPointers,
+			const std::source_location& throwSite = std::source_location::current());
 	};
 }
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+ * MinCppXtra - A minimalistic C++ utility library
+ *
+ * Author: Felipe Vieira Aburaya, 2025
+ * License: The Unlicense (public domain)
+ * Repository: https://github.com/faburaya/MinCppXtra
+ *
+ * This software is released into the public domain.
+ * You can freely use, modify, and distribute it without restrictions.
+ *
+ * For more details, see: https://unlicense.org
+ */
+
+// Prints the live statistics that a process exports with mincpp::StatisticsExportScope.
+// Usage: MinCppXtraStats [--no-color] <process ID> [refresh interval in ms]
+
+#include <MinCppXtra/console.hpp>
+#include <MinCppXtra/statistics_reader.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+static constexpr const char* USAGE =
+    "Usage: MinCppXtraStats [--no-color] <process ID> [refresh interval in ms]";
+
+static void Print(const mincpp::ExportedStatistics& statistics, bool useColors)
+{
+    const mincpp::Console::Color color(useColors);
+    std::cout << std::format("\033[2J\033[H{}process {}{} (published {} times, last at {:%T} UTC)\n\n",
+                             color.BrightWhite(),
+                             statistics.processId,
+                             color.Reset(),
+                             statistics.publishCount,
+                             std::chrono::floor<std::chrono::seconds>(statistics.publishTime));
+
+    for (const auto& counter : statistics.counters)
+    {
+        std::cout << std::format("  {:<40}{:>16}\n", counter.name, counter.value);
+    }
+
+    std::cout << std::format("\n  {:>10}  {:>14}  throw site\n", "rate/s", "total");
+    for (const auto& site : statistics.throwSites)
+    {
+        std::cout << std::format("{}  {:>10}  {:>14}  {} ({}, line {}){}\n",
+                                 site.isStorming ? color.BrightRed() : "",
+                                 site.ratePerSecond,
+                                 site.totalCount,
+                                 site.functionName,
+                                 site.fileName,
+                                 site.line,
+                                 color.Reset());
+    }
+    std::cout << std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+    bool useColors = true;
+    std::vector<std::string> arguments;
+    for (int idx = 1; idx < argc; ++idx)
+    {
+        if (std::string_view(argv[idx]) == "--no-color")
+            useColors = false;
+        else
+            arguments.emplace_back(argv[idx]);
+    }
+
+    if (arguments.empty())
+    {
+        std::cerr << USAGE << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        const uint32_t processId = static_cast<uint32_t>(std::stoul(arguments[0]));
+        const std::chrono::milliseconds refreshInterval(arguments.size() > 1 ? std::stoul(arguments[1]) : 1000);
+
+        mincpp::StatisticsReader reader(processId);
+        while (true)
+        {
+            if (auto statistics = reader.Read())
+            {
+                Print(*statistics, useColors);
+            }
+            std::this_thread::sleep_for(refreshInterval);
+        }
+    }
+    catch (std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -4,7 +4,9 @@
 #include <MinCppXtra/call_stack.hpp>
 #include <MinCppXtra/call_stack_access_scope.hpp>
 
+#include <atomic>
 #include <string>
+#include <thread>
 
 namespace unit_tests
 {
@@ -30,6 +32,44 @@ namespace unit_tests
 		EXPECT_EQ(expectedMatchCount, CountMatches(line, cst));
 	}
 
+	TEST(CallStack, NestedAccessScopes)
+	{
+		mincpp::CallStackAccessScope outerScope;
+		{
+			mincpp::CallStackAccessScope innerScope;
+		}
+		std::string cst = GetCallStackTrace(1, false);
+		EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::GetCallStackTrace), cst)) << cst;
+	}
+
+	static __declspec(noinline) void WaitForRelease(const std::atomic<bool>& isReleased)
+	{
+		while (!isReleased.load())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	TEST(CallStack, CaptureAllThreads)
+	{
+		mincpp::CallStackAccessScope scope;
+		std::atomic<bool> isReleased(false);
+		std::thread waitingThread([&isReleased]() { WaitForRelease(isReleased); });
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		mincpp::ThreadsSnapshot snapshot = mincpp::CallStack::CaptureAllThreads();
+		isReleased.store(true);
+		waitingThread.join();
+
+		EXPECT_TRUE(snapshot.isComplete);
+		EXPECT_LE(2, snapshot.threads.size());
+		EXPECT_LE(snapshot.longestPause, snapshot.totalDuration);
+
+		std::string cst = mincpp::CallStack::GetTrace(snapshot);
+		EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::WaitForRelease), cst)) << cst;
+		EXPECT_EQ(static_cast<int>(snapshot.threads.size()), CountMatches("=== THREAD ", cst));
+	}
+
 	INSTANTIATE_TEST_CASE_P(
 		GetCallStackTraceWithVaryingDepth,
 		CallStackTestFixture,
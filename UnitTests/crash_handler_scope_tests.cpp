@@ -0,0 +1,125 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/crash_handler_scope.hpp>
+
+#include <excpt.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <windows.h>
+
+namespace unit_tests
+{
+	static __declspec(noinline) bool WriteCrashReportUponFault()
+	{
+		bool isWritten = false;
+		__try
+		{
+			*static_cast<volatile int*>(nullptr) = 0;
+		}
+		__except (isWritten = mincpp::CrashHandlerScope::WriteReport(GetExceptionInformation()),
+			EXCEPTION_EXECUTE_HANDLER)
+		{
+		}
+		return isWritten;
+	}
+
+	static int s_previousFilterCallCount;
+
+	static LONG WINAPI CountCallsOfPreviousFilter(EXCEPTION_POINTERS*)
+	{
+		++s_previousFilterCallCount;
+		return EXCEPTION_EXECUTE_HANDLER;
+	}
+
+	static LPTOP_LEVEL_EXCEPTION_FILTER GetInstalledFilter()
+	{
+		LPTOP_LEVEL_EXCEPTION_FILTER filter = SetUnhandledExceptionFilter(nullptr);
+		SetUnhandledExceptionFilter(filter);
+		return filter;
+	}
+
+	// calls the filter the way the system does when the exception is unhandled
+	static __declspec(noinline) LONG RaiseThroughFilter(LPTOP_LEVEL_EXCEPTION_FILTER filter)
+	{
+		LONG result = EXCEPTION_CONTINUE_SEARCH;
+		__try
+		{
+			*static_cast<volatile int*>(nullptr) = 0;
+		}
+		__except (result = filter(GetExceptionInformation()), EXCEPTION_EXECUTE_HANDLER)
+		{
+		}
+		return result;
+	}
+
+	static std::string ReadAndRemove(const std::filesystem::path& filePath)
+	{
+		std::ostringstream content;
+		content << std::ifstream(filePath).rdbuf();
+		std::filesystem::remove(filePath);
+		return content.str();
+	}
+
+	TEST(CrashHandlerScope, UnhandledExceptionFilter)
+	{
+		const auto outerReportFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_crash_report_outer_test.txt";
+		const auto innerReportFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_crash_report_inner_test.txt";
+
+		std::filesystem::remove(outerReportFilePath);
+		std::filesystem::remove(innerReportFilePath);
+
+		const LPTOP_LEVEL_EXCEPTION_FILTER originalFilter =
+			SetUnhandledExceptionFilter(&CountCallsOfPreviousFilter);
+		s_previousFilterCallCount = 0;
+		{
+			mincpp::CrashHandlerScope outerScope(outerReportFilePath);
+			const LPTOP_LEVEL_EXCEPTION_FILTER installedFilter = GetInstalledFilter();
+			EXPECT_NE(&CountCallsOfPreviousFilter, installedFilter);
+
+			// the report is written, then the previous filter decides
+			EXPECT_EQ(EXCEPTION_EXECUTE_HANDLER, RaiseThroughFilter(installedFilter));
+			EXPECT_EQ(1, s_previousFilterCallCount);
+			{
+				mincpp::CrashHandlerScope innerScope(innerReportFilePath);
+				EXPECT_EQ(EXCEPTION_EXECUTE_HANDLER, RaiseThroughFilter(GetInstalledFilter()));
+				EXPECT_EQ(2, s_previousFilterCallCount);
+			}
+			EXPECT_EQ(installedFilter, GetInstalledFilter());
+		}
+		EXPECT_EQ(&CountCallsOfPreviousFilter, GetInstalledFilter());
+		SetUnhandledExceptionFilter(originalFilter);
+
+		const std::string outerReport = ReadAndRemove(outerReportFilePath);
+		const std::string innerReport = ReadAndRemove(innerReportFilePath);
+		EXPECT_EQ(1, CountMatches("=== CRASH REPORT ===", outerReport)) << outerReport;
+		EXPECT_EQ(1, CountMatches("=== CRASH REPORT ===", innerReport)) << innerReport;
+	}
+
+	TEST(CrashHandlerScope, WriteReport)
+	{
+		const auto reportFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_crash_report_test.txt";
+
+		std::filesystem::remove(reportFilePath);
+		{
+			mincpp::CrashHandlerScope crashHandlerScope(reportFilePath);
+			EXPECT_TRUE(WriteCrashReportUponFault());
+		}
+		EXPECT_FALSE(WriteCrashReportUponFault());
+
+		std::ostringstream report;
+		report << std::ifstream(reportFilePath).rdbuf();
+		std::filesystem::remove(reportFilePath);
+
+		EXPECT_EQ(1, CountMatches("=== CRASH REPORT ===", report.str())) << report.str();
+		EXPECT_EQ(1, CountMatches("exception code 0xc0000005", report.str())) << report.str();
+		EXPECT_EQ(1, CountMatches("frames:", report.str())) << report.str();
+		EXPECT_LE(1, CountMatches(" pdb ", report.str())) << report.str();
+	}
+}
@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/call_stack.hpp>
+#include <MinCppXtra/call_stack_access_scope.hpp>
+#include <MinCppXtra/exception_journal_scope.hpp>
+#include <MinCppXtra/traceable_exception.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace unit_tests
+{
+	static __declspec(noinline) void ThrowJournaledException(int idx)
+	{
+		throw mincpp::TraceableException("journaled exception #{}", idx);
+	}
+
+	TEST(ExceptionJournalScope, RecordAndRead)
+	{
+		const auto journalFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_exception_journal_test.bin";
+
+		std::filesystem::remove(journalFilePath);
+
+		mincpp::CallStackAccessScope callStackAccessScope;
+		constexpr size_t recordCount = 4;
+		{
+			mincpp::ExceptionJournalScope journalScope(journalFilePath, recordCount);
+			for (int idx = 0; idx < 6; ++idx)
+			{
+				try
+				{
+					ThrowJournaledException(idx);
+				}
+				catch (mincpp::TraceableException&)
+				{
+				}
+			}
+		}
+
+		// throws out of scope are not recorded
+		EXPECT_FALSE(mincpp::ExceptionJournalScope::IsActive());
+		try
+		{
+			ThrowJournaledException(-1);
+		}
+		catch (mincpp::TraceableException&)
+		{
+		}
+
+		const auto records = mincpp::ExceptionJournalScope::Read(journalFilePath);
+		std::filesystem::remove(journalFilePath);
+
+		ASSERT_EQ(recordCount, records.size());
+		for (size_t idx = 0; idx < records.size(); ++idx)
+		{
+			EXPECT_EQ(idx + 3, records[idx].sequence);
+			EXPECT_EQ("journaled exception #{}", records[idx].messagePrefix);
+			EXPECT_EQ(records[0].throwSiteKey, records[idx].throwSiteKey);
+		}
+
+		std::string cst = mincpp::CallStack::GetTrace(records.back().rawTrace);
+		EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::ThrowJournaledException), cst)) << cst;
+	}
+
+	TEST(ExceptionJournalScope, ConcurrentAppends)
+	{
+		const auto journalFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_exception_journal_concurrent_test.bin";
+
+		std::filesystem::remove(journalFilePath);
+
+		// the ring wraps many times, with writers meeting in the same slots
+		constexpr size_t recordCount = 16;
+		{
+			mincpp::ExceptionJournalScope journalScope(journalFilePath, recordCount);
+			std::vector<std::thread> threads;
+			for (uint64_t threadIdx = 0; threadIdx < 8; ++threadIdx)
+			{
+				threads.emplace_back([threadIdx]()
+				{
+					const std::string message(mincpp::ExceptionJournalScope::MaxMessageLength, 'a' + static_cast<char>(threadIdx));
+					for (int idx = 0; idx < 1000; ++idx)
+					{
+						mincpp::ExceptionJournalScope::Append(message, threadIdx);
+					}
+				});
+			}
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		const auto records = mincpp::ExceptionJournalScope::Read(journalFilePath);
+		std::filesystem::remove(journalFilePath);
+
+		EXPECT_LT(0, records.size());
+		for (const auto& record : records)
+		{
+			const std::string expectedMessage(
+				mincpp::ExceptionJournalScope::MaxMessageLength, 'a' + static_cast<char>(record.throwSiteKey));
+			EXPECT_EQ(expectedMessage, record.messagePrefix);
+		}
+	}
+
+	TEST(ExceptionJournalScope, ScopesEndOutOfOrder)
+	{
+		const auto firstFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_exception_journal_first_test.bin";
+		const auto secondFilePath =
+			std::filesystem::temp_directory_path() / "mincpp_exception_journal_second_test.bin";
+
+		std::filesystem::remove(firstFilePath);
+		std::filesystem::remove(secondFilePath);
+
+		auto firstScope = std::make_unique<mincpp::ExceptionJournalScope>(firstFilePath, 4);
+		auto secondScope = std::make_unique<mincpp::ExceptionJournalScope>(secondFilePath, 4);
+
+		firstScope.reset();
+		EXPECT_TRUE(mincpp::ExceptionJournalScope::IsActive());
+		mincpp::ExceptionJournalScope::Append("after the first scope ended", 1);
+
+		secondScope.reset();
+		EXPECT_FALSE(mincpp::ExceptionJournalScope::IsActive());
+
+		EXPECT_EQ(0, mincpp::ExceptionJournalScope::Read(firstFilePath).size());
+		EXPECT_EQ(1, mincpp::ExceptionJournalScope::Read(secondFilePath).size());
+		std::filesystem::remove(firstFilePath);
+		std::filesystem::remove(secondFilePath);
+	}
+}
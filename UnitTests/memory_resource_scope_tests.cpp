@@ -0,0 +1,142 @@
+﻿#include "pch.h"
+#include <MinCppXtra/memory_resource_scope.hpp>
+#include <MinCppXtra/traceable_exception.hpp>
+#include <MinCppXtra/win32_api_strings.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace unit_tests
+{
+	// counts what is allocated through it, and forwards to the default resource
+	// (what is given back is overwritten first, so that a use after release shows)
+	class CountingResource : public std::pmr::memory_resource
+	{
+	private:
+
+		std::pmr::memory_resource* m_upstream = std::pmr::get_default_resource();
+
+	public:
+
+		size_t allocationCount = 0;
+		size_t bytesInUse = 0;
+
+	private:
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			++allocationCount;
+			bytesInUse += bytes;
+			return m_upstream->allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			bytesInUse -= bytes;
+			std::memset(ptr, 0xdd, bytes);
+			m_upstream->deallocate(ptr, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+
+	TEST(MemoryResourceScope, DefaultOutsideScope)
+	{
+		EXPECT_EQ(std::pmr::get_default_resource(), mincpp::MemoryResourceScope::GetResource());
+	}
+
+	TEST(MemoryResourceScope, NestedScopesRestore)
+	{
+		CountingResource outer;
+		CountingResource inner;
+		{
+			mincpp::MemoryResourceScope outerScope(&outer);
+			EXPECT_EQ(&outer, mincpp::MemoryResourceScope::GetResource());
+			{
+				mincpp::MemoryResourceScope innerScope(&inner);
+				EXPECT_EQ(&inner, mincpp::MemoryResourceScope::GetResource());
+			}
+			EXPECT_EQ(&outer, mincpp::MemoryResourceScope::GetResource());
+		}
+		EXPECT_EQ(std::pmr::get_default_resource(), mincpp::MemoryResourceScope::GetResource());
+	}
+
+	TEST(MemoryResourceScope, ExceptionFormatsInScratch)
+	{
+		CountingResource resource;
+		{
+			mincpp::MemoryResourceScope scope(&resource);
+			try
+			{
+				throw mincpp::TraceableException("request {} failed with code {}", 42, 7);
+			}
+			catch (mincpp::TraceableException& ex)
+			{
+				// nothing the exception keeps is in the resource
+				EXPECT_EQ(0, resource.allocationCount);
+				EXPECT_STREQ("request 42 failed with code 7", ex.what());
+				EXPECT_LT(0, resource.allocationCount);
+				EXPECT_EQ(0, resource.bytesInUse);
+			}
+		}
+	}
+
+	static void ThrowFromRequestArena(std::pmr::memory_resource* upstream, std::string_view userName)
+	{
+		std::pmr::monotonic_buffer_resource arena(upstream);
+		mincpp::MemoryResourceScope scope(&arena);
+		throw mincpp::TraceableException("user {} not found", userName);
+	}
+
+	TEST(MemoryResourceScope, ExceptionOutlivesArena)
+	{
+		CountingResource upstream;
+		const std::string userName(1000, 'x');
+		std::exception_ptr exPtr;
+		try
+		{
+			ThrowFromRequestArena(&upstream, userName);
+		}
+		catch (mincpp::TraceableException&)
+		{
+			exPtr = std::current_exception();
+		}
+
+		// the arena has been destroyed while the exception was unwinding
+		EXPECT_EQ(0, upstream.bytesInUse);
+		ASSERT_TRUE(exPtr);
+		try
+		{
+			std::rethrow_exception(exPtr);
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			EXPECT_EQ("user " + userName + " not found", ex.what());
+			EXPECT_FALSE(ex.GetCallStackTrace().empty());
+		}
+	}
+
+	TEST(MemoryResourceScope, TranscodeIntoResource)
+	{
+		CountingResource resource;
+		{
+			const std::string utf8str(100, 'x');
+			const std::pmr::wstring widestr = mincpp::Win32ApiStrings::ToUtf16(utf8str, &resource);
+			EXPECT_EQ(std::wstring(100, L'x'), widestr);
+			EXPECT_EQ(&resource, widestr.get_allocator().resource());
+
+			const std::pmr::string roundTrip = mincpp::Win32ApiStrings::ToUtf8(widestr, &resource);
+			EXPECT_EQ(utf8str, roundTrip);
+			EXPECT_EQ(&resource, roundTrip.get_allocator().resource());
+			EXPECT_EQ(2, resource.allocationCount);
+		}
+		EXPECT_EQ(0, resource.bytesInUse);
+	}
+}
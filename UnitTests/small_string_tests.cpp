@@ -0,0 +1,60 @@
+﻿#include "pch.h"
+#include <MinCppXtra/small_string.hpp>
+
+#include <string>
+
+namespace unit_tests
+{
+	TEST(SmallString, StaysInline)
+	{
+		mincpp::SmallString<16> text("short text");
+		EXPECT_TRUE(text.IsInline());
+		EXPECT_EQ(16, text.GetCapacity());
+		EXPECT_EQ(10, text.GetLength());
+		EXPECT_STREQ("short text", text.GetData());
+
+		text.Assign("exactly 16 chars");
+		EXPECT_TRUE(text.IsInline());
+		EXPECT_STREQ("exactly 16 chars", text.GetData());
+
+		text.Resize(7);
+		EXPECT_TRUE(text.IsInline());
+		EXPECT_STREQ("exactly", text.GetData());
+	}
+
+	TEST(SmallString, GrowsOnHeap)
+	{
+		mincpp::SmallWString<4> text(L"abc");
+		text.Resize(3 + 8);
+		std::copy_n(L"defghijk", 8, text.GetData() + 3);
+		EXPECT_FALSE(text.IsInline());
+		EXPECT_GE(text.GetCapacity(), 11);
+		EXPECT_STREQ(L"abcdefghijk", text.GetData());
+		EXPECT_EQ(std::wstring_view(L"abcdefghijk"), text.GetView());
+	}
+
+	TEST(SmallString, CopyAndMove)
+	{
+		const mincpp::SmallString<8> shortText("short");
+		const mincpp::SmallString<8> longText("longer than inline");
+
+		for (const auto* original : { &shortText, &longText })
+		{
+			mincpp::SmallString<8> copy(*original);
+			EXPECT_EQ(original->GetView(), copy.GetView());
+
+			mincpp::SmallString<8> moved(std::move(copy));
+			EXPECT_EQ(original->GetView(), moved.GetView());
+			EXPECT_EQ(0, copy.GetLength());
+			EXPECT_STREQ("", copy.GetData());
+
+			copy = moved;
+			EXPECT_EQ(original->GetView(), copy.GetView());
+
+			mincpp::SmallString<8> assigned("something else entirely");
+			assigned = std::move(moved);
+			EXPECT_EQ(original->GetView(), assigned.GetView());
+			EXPECT_EQ(original->IsInline(), assigned.IsInline());
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/call_stack.hpp>
+#include <MinCppXtra/call_stack_access_scope.hpp>
+#include <MinCppXtra/stall_watchdog.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace unit_tests
+{
+	static __declspec(noinline) void StallFor(std::chrono::milliseconds duration)
+	{
+		std::this_thread::sleep_for(duration);
+	}
+
+	TEST(StallWatchdog, SampleStalledThread)
+	{
+		mincpp::CallStackAccessScope callStackAccessScope;
+		mincpp::StallWatchdog watchdog(2);
+		{
+			mincpp::StallWatchdog::ArmedScope armedScope(watchdog, std::chrono::milliseconds(10));
+			StallFor(std::chrono::milliseconds(100));
+		}
+
+		auto stalls = watchdog.TakeStalls();
+		ASSERT_EQ(1, stalls.size());
+		EXPECT_EQ(GetCurrentThreadId(), stalls[0].threadId);
+		EXPECT_GE(stalls[0].overdue, std::chrono::milliseconds(0));
+		ASSERT_FALSE(stalls[0].samples.empty());
+		for (const auto& sample : stalls[0].samples)
+		{
+			std::string cst = mincpp::CallStack::GetTrace(sample);
+			EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::StallFor), cst)) << cst;
+		}
+
+		EXPECT_TRUE(watchdog.TakeStalls().empty());
+	}
+
+	TEST(StallWatchdog, IgnoreThreadWithinBudget)
+	{
+		mincpp::StallWatchdog watchdog;
+		for (int idx = 0; idx < 10; ++idx)
+		{
+			mincpp::StallWatchdog::ArmedScope armedScope(watchdog, std::chrono::seconds(10));
+			StallFor(std::chrono::milliseconds(1));
+		}
+		watchdog.Disarm();
+		EXPECT_TRUE(watchdog.TakeStalls().empty());
+	}
+
+	TEST(StallWatchdog, RateLimit)
+	{
+		mincpp::StallWatchdog watchdog(1, std::chrono::milliseconds(1), 1);
+		for (int idx = 0; idx < 5; ++idx)
+		{
+			mincpp::StallWatchdog::ArmedScope armedScope(watchdog, std::chrono::milliseconds(1));
+			StallFor(std::chrono::milliseconds(30));
+		}
+		EXPECT_EQ(1, watchdog.TakeStalls().size());
+	}
+}
@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/call_stack_access_scope.hpp>
+#include <MinCppXtra/statistics_export_scope.hpp>
+#include <MinCppXtra/statistics_reader.hpp>
+#include <MinCppXtra/traceable_exception.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace unit_tests
+{
+	static __declspec(noinline) uint64_t ThrowExportedException()
+	{
+		try
+		{
+			throw mincpp::TraceableException("exported");
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			return ex.GetThrowSiteKey();
+		}
+	}
+
+	TEST(StatisticsExportScope, ReadExportedStatistics)
+	{
+		uint64_t throwSiteKey = 0;
+		{
+			mincpp::CallStackAccessScope scope;
+			throwSiteKey = ThrowExportedException();
+		}
+
+		mincpp::StatisticsExportScope exportScope(std::chrono::milliseconds(10));
+		EXPECT_THROW(mincpp::StatisticsExportScope(), mincpp::TraceableException);
+
+		mincpp::StatisticsReader reader(GetCurrentProcessId());
+		std::optional<mincpp::ExportedStatistics> statistics;
+		for (int attempt = 0; attempt < 100 && !statistics; ++attempt)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			statistics = reader.Read();
+		}
+
+		ASSERT_TRUE(statistics.has_value());
+		EXPECT_EQ(GetCurrentProcessId(), statistics->processId);
+		EXPECT_LT(0, statistics->publishCount);
+		EXPECT_TRUE(std::any_of(statistics->counters.begin(), statistics->counters.end(),
+			[](const auto& counter) { return counter.name == "throw_sites.throttled"; }));
+
+		auto site = std::find_if(statistics->throwSites.begin(), statistics->throwSites.end(),
+			[throwSiteKey](const auto& site) { return site.throwSiteKey == throwSiteKey; });
+
+		if (site != statistics->throwSites.end())
+		{
+			EXPECT_EQ(1, CountMatches(NAMEOF(ThrowExportedException), site->functionName));
+			EXPECT_LE(1, site->totalCount);
+		}
+	}
+
+	TEST(StatisticsExportScope, ReadWithoutExport)
+	{
+		EXPECT_THROW(mincpp::StatisticsReader(GetCurrentProcessId()), mincpp::TraceableException);
+	}
+}
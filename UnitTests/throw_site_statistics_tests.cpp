@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/call_stack_access_scope.hpp>
+#include <MinCppXtra/throw_site_statistics.hpp>
+#include <MinCppXtra/traceable_exception.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace unit_tests
+{
+	static __declspec(noinline) uint64_t ThrowAndCatch()
+	{
+		try
+		{
+			throw mincpp::TraceableException("hot site");
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			return ex.GetThrowSiteKey();
+		}
+	}
+
+	static const mincpp::ThrowSiteStatistics::Site* FindSite(
+		const std::vector<mincpp::ThrowSiteStatistics::Site>& sites, uint64_t throwSiteKey)
+	{
+		auto iter = std::find_if(sites.begin(), sites.end(),
+			[throwSiteKey](const auto& site) { return site.throwSiteKey == throwSiteKey; });
+
+		return iter != sites.end() ? &*iter : nullptr;
+	}
+
+	TEST(ThrowSiteStatistics, CountThrows)
+	{
+		mincpp::CallStackAccessScope scope;
+		uint64_t throwSiteKey = 0;
+		for (int idx = 0; idx < 100; ++idx)
+		{
+			throwSiteKey = ThrowAndCatch();
+		}
+
+		auto sites = mincpp::ThrowSiteStatistics::GetTopSites(mincpp::ThrowSiteStatistics::Capacity);
+		const auto* site = FindSite(sites, throwSiteKey);
+		ASSERT_NE(nullptr, site);
+		EXPECT_GE(site->totalCount, 100);
+		EXPECT_EQ(1, CountMatches(NAMEOF(ThrowAndCatch), site->throwSite.function_name()));
+		EXPECT_EQ(1, CountMatches("thrown", site->Summarize())) << site->Summarize();
+
+		EXPECT_LE(mincpp::ThrowSiteStatistics::GetTopSites(1).size(), 1);
+	}
+
+	TEST(ThrowSiteStatistics, DetectStorm)
+	{
+		mincpp::CallStackAccessScope scope;
+		mincpp::ThrowSiteStatistics::SetStormThreshold(50);
+
+		uint64_t throwSiteKey = 0;
+		const auto startTime = std::chrono::steady_clock::now();
+		do
+		{
+			throwSiteKey = ThrowAndCatch();
+		} while (!mincpp::ThrowSiteStatistics::IsStorming(throwSiteKey)
+			&& std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5));
+
+		mincpp::ThrowSiteStatistics::SetStormThreshold(
+			mincpp::ThrowSiteStatistics::DefaultStormThreshold);
+
+		EXPECT_TRUE(mincpp::ThrowSiteStatistics::IsStorming(throwSiteKey));
+
+		auto sites = mincpp::ThrowSiteStatistics::GetTopSites(mincpp::ThrowSiteStatistics::Capacity);
+		const auto* site = FindSite(sites, throwSiteKey);
+		ASSERT_NE(nullptr, site);
+		EXPECT_GE(site->ratePerSecond, 50);
+	}
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/call_stack.hpp>
+#include <MinCppXtra/call_stack_access_scope.hpp>
+#include <MinCppXtra/throw_tracing_scope.hpp>
+
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace unit_tests
+{
+	static __declspec(noinline) int ThrowOutOfRange()
+	{
+		std::vector<int> empty;
+		return empty.at(1);
+	}
+
+	TEST(ThrowTracingScope, FindTraceOfCaughtException)
+	{
+		mincpp::CallStackAccessScope callStackAccessScope;
+		mincpp::ThrowTracingScope throwTracingScope;
+		try
+		{
+			ThrowOutOfRange();
+		}
+		catch (std::out_of_range& ex)
+		{
+			auto rawTrace = mincpp::ThrowTracingScope::FindTrace(&ex);
+			ASSERT_TRUE(rawTrace.has_value());
+			std::string cst = mincpp::CallStack::GetTrace(rawTrace.value());
+			EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::ThrowOutOfRange), cst)) << cst;
+
+			auto throwTrace = mincpp::ThrowTracingScope::FindCurrentExceptionTrace();
+			ASSERT_TRUE(throwTrace.has_value());
+			EXPECT_FALSE(throwTrace->isApproximate);
+			cst = mincpp::CallStack::GetTrace(throwTrace->rawTrace);
+			EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::ThrowOutOfRange), cst)) << cst;
+		}
+	}
+
+	TEST(ThrowTracingScope, FindTraceOfExceptionPointer)
+	{
+		mincpp::CallStackAccessScope callStackAccessScope;
+		mincpp::ThrowTracingScope throwTracingScope;
+		std::exception_ptr exception;
+		try
+		{
+			ThrowOutOfRange();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		auto throwTrace = mincpp::ThrowTracingScope::FindTrace(exception);
+		ASSERT_TRUE(throwTrace.has_value());
+		std::string cst = mincpp::CallStack::GetTrace(throwTrace->rawTrace);
+		EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::ThrowOutOfRange), cst)) << cst;
+	}
+
+	TEST(ThrowTracingScope, FindTraceInAnotherThread)
+	{
+		mincpp::CallStackAccessScope callStackAccessScope;
+		mincpp::ThrowTracingScope throwTracingScope;
+		std::future<int> result = std::async(std::launch::async, &ThrowOutOfRange);
+		try
+		{
+			result.get();
+		}
+		catch (std::out_of_range&)
+		{
+			auto throwTrace = mincpp::ThrowTracingScope::FindCurrentExceptionTrace();
+			ASSERT_TRUE(throwTrace.has_value());
+			std::string cst = mincpp::CallStack::GetTrace(throwTrace->rawTrace);
+			EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::ThrowOutOfRange), cst)) << cst;
+			return;
+		}
+		FAIL() << "exception has not been propagated!";
+	}
+
+	TEST(ThrowTracingScope, NoTraceOutsideScope)
+	{
+		try
+		{
+			throw std::runtime_error("not traced");
+		}
+		catch (std::exception& ex)
+		{
+			EXPECT_FALSE(mincpp::ThrowTracingScope::FindTrace(&ex).has_value());
+		}
+	}
+
+	static __declspec(noinline) bool ThrowAndFindTrace()
+	{
+		try
+		{
+			throw std::runtime_error("maybe traced");
+		}
+		catch (std::exception& ex)
+		{
+			return mincpp::ThrowTracingScope::FindTrace(&ex).has_value();
+		}
+	}
+
+	TEST(ThrowTracingScope, NoStaleTraceAfterScopeEnds)
+	{
+		{
+			mincpp::ThrowTracingScope throwTracingScope;
+			EXPECT_TRUE(ThrowAndFindTrace());
+		}
+		// (the thrown object most likely lands where the traced one was)
+		EXPECT_FALSE(ThrowAndFindTrace());
+	}
+}
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "utils.hpp"
+
+#include <MinCppXtra/call_stack.hpp>
+#include <MinCppXtra/call_stack_access_scope.hpp>
+#include <MinCppXtra/trace_metrics.hpp>
+
+#include <string>
+
+namespace unit_tests
+{
+	TEST(TraceMetrics, MeasureStages)
+	{
+		mincpp::CallStackAccessScope scope;
+		mincpp::TraceMetrics::Reset();
+
+		mincpp::CallStack::GetTrace();
+		EXPECT_EQ(0, mincpp::TraceMetrics::GetHistogram(mincpp::TraceMetric::CaptureNanoseconds).count);
+
+		mincpp::TraceMetrics::Enable(true);
+		size_t traceLength = 0;
+		for (int idx = 0; idx < 10; ++idx)
+		{
+			traceLength = mincpp::CallStack::GetTrace().size();
+		}
+		mincpp::TraceMetrics::Enable(false);
+
+		for (auto metric : {
+			mincpp::TraceMetric::CaptureNanoseconds,
+			mincpp::TraceMetric::FramesWalked,
+			mincpp::TraceMetric::FramesResolved,
+			mincpp::TraceMetric::ResolveNanoseconds,
+			mincpp::TraceMetric::RenderNanoseconds,
+			mincpp::TraceMetric::BytesRendered })
+		{
+			auto histogram = mincpp::TraceMetrics::GetHistogram(metric);
+			EXPECT_EQ(10, histogram.count) << mincpp::TraceMetrics::GetName(metric);
+			EXPECT_LT(0, histogram.max) << mincpp::TraceMetrics::GetName(metric);
+			EXPECT_FALSE(histogram.buckets.empty());
+			EXPECT_LE(histogram.GetPercentile(50), histogram.GetPercentile(99));
+			EXPECT_LE(histogram.GetPercentile(99), histogram.max);
+		}
+
+		auto bytesRendered = mincpp::TraceMetrics::GetHistogram(mincpp::TraceMetric::BytesRendered);
+		EXPECT_EQ(traceLength, bytesRendered.max);
+
+		mincpp::TraceMetrics::Reset();
+		EXPECT_EQ(0, mincpp::TraceMetrics::GetHistogram(mincpp::TraceMetric::RenderNanoseconds).count);
+	}
+}
@@ -3,7 +3,11 @@
 #include <MinCppXtra/traceable_exception.hpp>
 #include "utils.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <string_view>
+#include <windows.h>
 
 namespace unit_tests
 {
@@ -13,8 +17,9 @@ namespace unit_tests
 
 		MyTestException(
 			const std::string& message,
-			const std::exception& innerException)
-			: mincpp::TraceableException(message, innerException)
+			const std::exception& innerException,
+			const std::source_location& throwSite = std::source_location::current())
+			: mincpp::TraceableException(message, innerException, throwSite)
 		{
 		}
 	};
@@ -59,6 +64,146 @@ namespace unit_tests
 		}
 	}
 
+	TEST(TraceableException, DeferredMessageFormatting)
+	{
+		try
+		{
+			mincpp::CallStackAccessScope scope;
+			throw mincpp::TraceableException("attempt {} of {} failed: {}", 2, 3, std::string("timeout"));
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			mincpp::TraceableException copy(ex);
+			EXPECT_STREQ("attempt 2 of 3 failed: timeout", ex.what());
+			EXPECT_EQ(ex.what(), copy.what());
+			EXPECT_EQ(1, CountMatches(ex.what(), ex.Serialize()));
+		}
+	}
+
+	static __declspec(noinline) void ThrowWithTextOnStack()
+	{
+		char buffer[] = "temporary";
+		const std::string_view view(buffer);
+		throw mincpp::TraceableException("{} and {}", static_cast<const char*>(buffer), view);
+	}
+
+	TEST(TraceableException, DeferredMessageFormattingCopiesText)
+	{
+		try
+		{
+			mincpp::CallStackAccessScope scope;
+			ThrowWithTextOnStack();
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			// the stack frame with the text is gone when the message is formatted
+			char overwrite[64];
+			std::fill(std::begin(overwrite), std::end(overwrite), 'x');
+			EXPECT_EQ('x', overwrite[0]);
+			EXPECT_STREQ("temporary and temporary", ex.what());
+		}
+	}
+
+	// (a non-const pointer must not be taken as argument for a deferred message)
+	static_assert(!mincpp::MessageFormatArgument<CONTEXT*&>);
+
+	static __declspec(noinline) void ThrowFromContext(bool isMessageLiteral)
+	{
+		CONTEXT context;
+		RtlCaptureContext(&context);
+		CONTEXT* contextPtr = &context;
+		if (isMessageLiteral)
+			throw mincpp::TraceableException("thrown from context", contextPtr);
+		else
+			throw mincpp::TraceableException(std::string("thrown from context"), contextPtr);
+	}
+
+	TEST(TraceableException, NonConstContextHandle)
+	{
+		for (bool isMessageLiteral : { true, false })
+		{
+			try
+			{
+				mincpp::CallStackAccessScope scope;
+				ThrowFromContext(isMessageLiteral);
+			}
+			catch (mincpp::TraceableException& ex)
+			{
+				EXPECT_STREQ("thrown from context", ex.what());
+				EXPECT_EQ(1, CountMatches(NAMEOF(unit_tests::ThrowFromContext), ex.GetCallStackTrace()));
+			}
+		}
+	}
+
+	TEST(TraceableException, ThrowSite)
+	{
+		uint64_t throwSiteKeys[2]{};
+		for (uint64_t& throwSiteKey : throwSiteKeys)
+		{
+			try
+			{
+				mincpp::CallStackAccessScope scope;
+				ThrowTraceableException();
+			}
+			catch (mincpp::TraceableException& ex)
+			{
+				EXPECT_EQ(1, CountMatches("traceable_exception_tests.cpp", ex.GetThrowSite().file_name()));
+				EXPECT_EQ(1, CountMatches(NAMEOF(ThrowTraceableException), ex.GetThrowSite().function_name()));
+				EXPECT_EQ(1, CountMatches(ex.GetThrowSite().file_name(), ex.Serialize()));
+				throwSiteKey = ex.GetThrowSiteKey();
+			}
+		}
+		EXPECT_EQ(throwSiteKeys[0], throwSiteKeys[1]);
+
+		try
+		{
+			mincpp::CallStackAccessScope scope;
+			throw mincpp::TraceableException("formatted {}", 1);
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			EXPECT_NE(throwSiteKeys[0], ex.GetThrowSiteKey());
+			EXPECT_EQ(1, CountMatches(NAMEOF(ThrowSite), ex.GetThrowSite().function_name()));
+		}
+	}
+
+	TEST(TraceableException, Breadcrumbs)
+	{
+		mincpp::Breadcrumbs::Clear();
+		for (int idx = 0; idx < 20; ++idx)
+		{
+			MINCPP_BREADCRUMB("iteration", idx);
+		}
+		MINCPP_BREADCRUMB("request", 42);
+
+		try
+		{
+			mincpp::CallStackAccessScope scope;
+			throw mincpp::TraceableException("failed");
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			auto breadcrumbs = ex.GetBreadcrumbs();
+			ASSERT_EQ(mincpp::TraceableException::BreadcrumbCount, breadcrumbs.size());
+			EXPECT_STREQ("iteration", breadcrumbs.front().label);
+			EXPECT_EQ(13, breadcrumbs.front().value);
+			EXPECT_STREQ("request", breadcrumbs.back().label);
+			EXPECT_EQ(42, breadcrumbs.back().value);
+			EXPECT_EQ(1, CountMatches("request = 42", ex.Serialize()));
+		}
+
+		mincpp::Breadcrumbs::Clear();
+		try
+		{
+			mincpp::CallStackAccessScope scope;
+			throw mincpp::TraceableException("failed");
+		}
+		catch (mincpp::TraceableException& ex)
+		{
+			EXPECT_TRUE(ex.GetBreadcrumbs().empty());
+		}
+	}
+
 	TEST(TraceableException, PrintException)
 	{
 		mincpp::TraceableException::UseColorsOnStackTrace(true);
@@ -0,0 +1,188 @@
+﻿#include "pch.h"
+#include <MinCppXtra/transcoding_streams.hpp>
+#include <MinCppXtra/utfcpp/utf8/cpp20.h>
+
+#include <random>
+#include <string>
+
+namespace unit_tests
+{
+	using mincpp::TranscodingProgress;
+	using mincpp::Utf16ToUtf8Stream;
+	using mincpp::Utf8ToUtf16Stream;
+
+	/// <summary>
+	/// Feeds text to a stream in chunks of random size, into an output of random size.
+	/// </summary>
+	/// <returns>Whether the whole stream was valid.</returns>
+	template <typename StreamType, typename InputType, typename OutputType>
+	static bool TranscodeInChunks(
+		StreamType& stream, const InputType& text, OutputType& transcoded, std::mt19937& generator)
+	{
+		typename OutputType::value_type buffer[40];
+		size_t position = 0;
+		while (position < text.length())
+		{
+			const size_t chunkLength = std::min<size_t>(1 + generator() % 20, text.length() - position);
+			auto chunk = std::basic_string_view(text.data() + position, chunkLength);
+			const size_t bufferSize = 4 + generator() % (std::size(buffer) - 4);
+			while (!chunk.empty())
+			{
+				const TranscodingProgress progress = stream.Transcode(chunk, std::span(buffer, bufferSize));
+				transcoded.append(buffer, progress.written);
+				position += progress.read;
+				chunk.remove_prefix(progress.read);
+				if (progress.isInvalid)
+					return false;
+
+				EXPECT_NE(0, progress.read + progress.written);
+			}
+		}
+		return stream.Finish();
+	}
+
+	static size_t FindInvalidUtf16(const std::wstring& text)
+	{
+		for (size_t idx = 0; idx < text.length(); ++idx)
+		{
+			if (text[idx] >= 0xDC00 && text[idx] <= 0xDFFF)
+				return idx;
+
+			if (text[idx] >= 0xD800 && text[idx] <= 0xDBFF)
+			{
+				if (idx + 1 == text.length() || text[idx + 1] < 0xDC00 || text[idx + 1] > 0xDFFF)
+					return idx;
+
+				++idx;
+			}
+		}
+		return std::wstring::npos;
+	}
+
+	TEST(TranscodingStreams, Utf8ToUtf16_in_random_chunks)
+	{
+		std::mt19937 generator(2025);
+		Utf8ToUtf16Stream stream;
+		for (int iteration = 0; iteration < 20000; ++iteration)
+		{
+			std::string text;
+			const size_t length = generator() % 200;
+			while (text.size() < length)
+			{
+				const uint32_t choice = generator() % 8;
+				if (choice < 2)
+					text.push_back(static_cast<char>(generator() % 0x80));
+				else if (choice < 4)
+					utf8::append(0x80 + generator() % 0x780, text);
+				else if (choice < 5)
+					utf8::append(0x800 + generator() % 0xD000, text);
+				else if (choice < 7)
+					utf8::append(0x10000 + generator() % 0x100000, text);
+				else if (generator() % 40 == 0)
+					text.push_back(static_cast<char>(generator() % 0x100));
+			}
+
+			stream.Reset();
+			std::wstring transcoded;
+			const bool isValid = TranscodeInChunks(stream, text, transcoded, generator);
+			const size_t invalid = utf8::find_invalid(text);
+			ASSERT_EQ(invalid == std::string::npos, isValid);
+
+			const size_t validLength = isValid ? text.length() : invalid;
+			const std::u16string expected = utf8::utf8to16(text.substr(0, validLength));
+			ASSERT_EQ(validLength, stream.GetPosition());
+			ASSERT_EQ(std::wstring(expected.begin(), expected.end()), transcoded);
+		}
+	}
+
+	TEST(TranscodingStreams, Utf16ToUtf8_in_random_chunks)
+	{
+		std::mt19937 generator(2025);
+		Utf16ToUtf8Stream stream;
+		for (int iteration = 0; iteration < 20000; ++iteration)
+		{
+			std::wstring text;
+			const size_t length = generator() % 200;
+			while (text.size() < length)
+			{
+				const uint32_t choice = generator() % 8;
+				if (choice < 3)
+					text.push_back(static_cast<wchar_t>(generator() % 0x800));
+				else if (choice < 5)
+					text.push_back(static_cast<wchar_t>(0xE000 + generator() % 0x2000));
+				else if (choice < 7)
+				{
+					const uint32_t codePoint = 0x10000 + generator() % 0x100000;
+					text.push_back(static_cast<wchar_t>(0xD7C0 + (codePoint >> 10)));
+					text.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+				}
+				else if (generator() % 40 == 0)
+					text.push_back(static_cast<wchar_t>(0xD800 + generator() % 0x800));
+			}
+
+			stream.Reset();
+			std::string transcoded;
+			const bool isValid = TranscodeInChunks(stream, text, transcoded, generator);
+			const size_t invalid = FindInvalidUtf16(text);
+			ASSERT_EQ(invalid == std::wstring::npos, isValid);
+
+			const size_t validLength = isValid ? text.length() : invalid;
+			const std::u16string_view validText(reinterpret_cast<const char16_t*>(text.data()), validLength);
+			ASSERT_EQ(validLength, stream.GetPosition());
+			ASSERT_EQ(utf8::utf16to8(validText), transcoded);
+		}
+	}
+
+	TEST(TranscodingStreams, Utf8ToUtf16_sequence_split_between_chunks)
+	{
+		const std::string text = reinterpret_cast<const char*>(u8"ab😀c");
+		Utf8ToUtf16Stream stream;
+		wchar_t buffer[8];
+		size_t written = 0;
+		for (size_t idx = 0; idx < text.length(); ++idx)
+		{
+			const TranscodingProgress progress =
+				stream.Transcode(std::string_view(&text[idx], 1), std::span(buffer + written, 2));
+			ASSERT_FALSE(progress.isInvalid);
+			ASSERT_EQ(1, progress.read);
+			written += progress.written;
+		}
+		EXPECT_TRUE(stream.Finish());
+		EXPECT_EQ(std::wstring_view(reinterpret_cast<const wchar_t*>(u"ab😀c")), std::wstring_view(buffer, written));
+
+		// ends in the middle of a sequence
+		stream.Reset();
+		EXPECT_FALSE(stream.Transcode("ab\xF0\x9F", std::span(buffer)).isInvalid);
+		EXPECT_FALSE(stream.Finish());
+		EXPECT_EQ(2, stream.GetPosition());
+
+		// invalid sequence split between chunks
+		stream.Reset();
+		EXPECT_FALSE(stream.Transcode("abc\xE2", std::span(buffer)).isInvalid);
+		const TranscodingProgress progress = stream.Transcode("z", std::span(buffer));
+		EXPECT_TRUE(progress.isInvalid);
+		EXPECT_EQ(0, progress.read);
+		EXPECT_EQ(3, stream.GetPosition());
+		EXPECT_TRUE(stream.Transcode("abc", std::span(buffer)).isInvalid);
+	}
+
+	TEST(TranscodingStreams, Utf16ToUtf8_surrogate_pair_split_between_chunks)
+	{
+		Utf16ToUtf8Stream stream;
+		char buffer[8];
+		TranscodingProgress progress = stream.Transcode(L"a\xD83D", std::span(buffer));
+		EXPECT_EQ(2, progress.read);
+		EXPECT_EQ(1, progress.written);
+		progress = stream.Transcode(L"\xDE00", std::span(buffer + 1, 7));
+		EXPECT_EQ(1, progress.read);
+		EXPECT_EQ(4, progress.written);
+		EXPECT_TRUE(stream.Finish());
+		EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(u8"a😀")), std::string_view(buffer, 5));
+
+		// ends with a lead surrogate
+		stream.Reset();
+		EXPECT_FALSE(stream.Transcode(L"ab\xD83D", std::span(buffer)).isInvalid);
+		EXPECT_FALSE(stream.Finish());
+		EXPECT_EQ(2, stream.GetPosition());
+	}
+}
@@ -0,0 +1,228 @@
+﻿#include "pch.h"
+#include <MinCppXtra/transcoding_streams.hpp>
+#include <MinCppXtra/win32_api_strings.hpp>
+#include <MinCppXtra/utfcpp/utf8/cpp20.h>
+
+#include <random>
+#include <string>
+
+// These tests hold for wide-chars of either width (UTF-16 in Windows, UTF-32 in Linux and others),
+// so that they are also built off Windows, where the rest of the tests cannot run.
+
+namespace unit_tests
+{
+	using mincpp::Win32ApiStrings;
+
+	/// <summary>
+	/// Runs a test once for every level of acceleration this machine supports.
+	/// </summary>
+	template <typename TestFn>
+	static void ForEachWideAcceleration(TestFn test)
+	{
+		Win32ApiStrings::LimitAcceleration(Win32ApiStrings::Acceleration::Avx2);
+		const auto supported = Win32ApiStrings::GetAcceleration();
+		for (auto level : {
+			Win32ApiStrings::Acceleration::None,
+			Win32ApiStrings::Acceleration::Sse2,
+			Win32ApiStrings::Acceleration::Avx2 })
+		{
+			if (level > supported)
+				break;
+
+			Win32ApiStrings::LimitAcceleration(level);
+			SCOPED_TRACE("acceleration level " + std::to_string(static_cast<int>(level)));
+			test();
+		}
+		Win32ApiStrings::LimitAcceleration(supported);
+	}
+
+	/// <summary>
+	/// Transcodes UTF-8 to wide text with utfcpp, in whichever encoding fits wchar_t.
+	/// </summary>
+	static std::wstring ToWideWithUtfcpp(const std::string& text)
+	{
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+		{
+			const std::u16string utf16str = utf8::utf8to16(text);
+			return std::wstring(utf16str.begin(), utf16str.end());
+		}
+		else
+		{
+			const std::u32string utf32str = utf8::utf8to32(text);
+			return std::wstring(utf32str.begin(), utf32str.end());
+		}
+	}
+
+	/// <summary>
+	/// Transcodes wide text to UTF-8 with utfcpp, in whichever encoding fits wchar_t.
+	/// </summary>
+	static std::string ToUtf8WithUtfcpp(const std::wstring& text)
+	{
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+			return utf8::utf16to8(std::u16string(text.begin(), text.end()));
+		else
+			return utf8::utf32to8(std::u32string(text.begin(), text.end()));
+	}
+
+	/// <summary>
+	/// Gets a description of the outcome of transcoding, which is either the text or the error.
+	/// </summary>
+	template <typename TranscodeFn>
+	static std::string DescribeOutcome(TranscodeFn transcode)
+	{
+		try
+		{
+			const auto text = transcode();
+			std::string description = "transcoded:";
+			for (auto codeUnit : text)
+				description += ' ' + std::to_string(static_cast<uint32_t>(codeUnit));
+
+			return description;
+		}
+		catch (const utf8::exception& ex)
+		{
+			return std::string("failed: ") + ex.what();
+		}
+	}
+
+	static std::string GetAllCodePointsInUtf8()
+	{
+		std::string text;
+		for (char32_t codePoint = 1; codePoint <= 0x10FFFF; ++codePoint)
+		{
+			if (codePoint < 0xD800 || codePoint > 0xDFFF)
+				utf8::append(codePoint, text);
+		}
+		return text;
+	}
+
+	TEST(WideTranscoding, ToWide_and_back_all_code_points)
+	{
+		const std::string text = GetAllCodePointsInUtf8();
+		const std::wstring expected = ToWideWithUtfcpp(text);
+		ForEachWideAcceleration([&]() {
+			const std::wstring widestr = Win32ApiStrings::ToWide(text);
+			ASSERT_EQ(expected, widestr);
+			ASSERT_EQ(text.length(), Win32ApiStrings::RequiredUtf8Length(widestr));
+			ASSERT_EQ(widestr.length(), Win32ApiStrings::RequiredUtf16Length(text));
+			ASSERT_EQ(text, Win32ApiStrings::ToUtf8(widestr));
+		});
+	}
+
+	TEST(WideTranscoding, ToWide_fuzzing_same_as_utfcpp)
+	{
+		std::mt19937 generator(2025);
+		ForEachWideAcceleration([&]() {
+			for (int iteration = 0; iteration < 20000; ++iteration)
+			{
+				// mostly valid text, with a random byte here and there
+				std::string text;
+				const size_t length = generator() % 100;
+				while (text.size() < length)
+				{
+					if (generator() % 16 == 0)
+						text.push_back(static_cast<char>(generator()));
+					else
+						utf8::append(static_cast<char32_t>(generator() % 0x800), text);
+				}
+
+				ASSERT_EQ(
+					DescribeOutcome([&]() { return ToWideWithUtfcpp(text); }),
+					DescribeOutcome([&]() { return Win32ApiStrings::ToWide(text); }));
+			}
+		});
+	}
+
+	TEST(WideTranscoding, ToUtf8_fuzzing_same_as_utfcpp)
+	{
+		std::mt19937 generator(2025);
+		ForEachWideAcceleration([&]() {
+			for (int iteration = 0; iteration < 20000; ++iteration)
+			{
+				// code units of any value that fits, such as surrogates, and beyond U+10FFFF in UTF-32
+				std::wstring text;
+				const size_t length = generator() % 100;
+				while (text.size() < length)
+				{
+					const uint32_t choice = generator() % 16;
+					if (choice < 8)
+						text.push_back(static_cast<wchar_t>(generator() % 0x800));
+					else if (choice < 15)
+						text.push_back(static_cast<wchar_t>(0xD000 + generator() % 0x2000));
+					else
+						text.push_back(static_cast<wchar_t>(generator()));
+				}
+
+				ASSERT_EQ(
+					DescribeOutcome([&]() { return ToUtf8WithUtfcpp(text); }),
+					DescribeOutcome([&]() { return Win32ApiStrings::ToUtf8(text); }));
+			}
+		});
+	}
+
+	TEST(WideTranscoding, Into_buffers)
+	{
+		const std::string text = reinterpret_cast<const char*>(u8"excluído ausgeschloßen 除外 🚫");
+		const std::wstring widestr = ToWideWithUtfcpp(text);
+
+		wchar_t wideBuffer[64];
+		ASSERT_EQ(widestr.length(), Win32ApiStrings::ToUtf16Into(text, wideBuffer));
+		EXPECT_EQ(widestr, std::wstring_view(wideBuffer, widestr.length()));
+		EXPECT_EQ(widestr.length(), Win32ApiStrings::ToUtf16Into(text, std::span(wideBuffer, 4)));
+
+		char buffer[64];
+		ASSERT_EQ(text.length(), Win32ApiStrings::ToUtf8Into(widestr, buffer));
+		EXPECT_EQ(text, std::string_view(buffer, text.length()));
+		EXPECT_EQ(text.length(), Win32ApiStrings::ToUtf8Into(widestr, std::span(buffer, 4)));
+	}
+
+	TEST(WideTranscoding, Parallel_same_as_serial)
+	{
+		const std::string text = GetAllCodePointsInUtf8();
+		const std::wstring widestr = Win32ApiStrings::ToWide(text);
+		mincpp::TranscodingParallelism parallelism;
+		parallelism.threadCount = 7;
+		parallelism.serialThreshold = 0;
+		EXPECT_EQ(widestr, Win32ApiStrings::ToUtf16Parallel(text, parallelism));
+		EXPECT_EQ(text, Win32ApiStrings::ToUtf8Parallel(widestr, parallelism));
+	}
+
+	TEST(WideTranscoding, Streams_in_random_chunks)
+	{
+		const std::string text = GetAllCodePointsInUtf8().substr(0, 1 << 16);
+		const std::wstring widestr = Win32ApiStrings::ToWide(text);
+		std::mt19937 generator(2025);
+
+		mincpp::Utf8ToUtf16Stream wideStream;
+		std::wstring streamedWide;
+		for (size_t position = 0; position < text.length();)
+		{
+			wchar_t buffer[16];
+			const size_t chunkLength = std::min<size_t>(1 + generator() % 20, text.length() - position);
+			const mincpp::TranscodingProgress progress =
+				wideStream.Transcode(std::string_view(text.data() + position, chunkLength), buffer);
+
+			ASSERT_FALSE(progress.isInvalid);
+			streamedWide.append(buffer, progress.written);
+			position += progress.read;
+		}
+		ASSERT_TRUE(wideStream.Finish());
+		EXPECT_EQ(widestr, streamedWide);
+
+		mincpp::Utf16ToUtf8Stream utf8Stream;
+		std::string streamedUtf8;
+		for (size_t position = 0; position < widestr.length();)
+		{
+			char buffer[16];
+			const size_t chunkLength = std::min<size_t>(1 + generator() % 20, widestr.length() - position);
+			const mincpp::TranscodingProgress progress =
+				utf8Stream.Transcode(std::wstring_view(widestr.data() + position, chunkLength), buffer);
+
+			ASSERT_FALSE(progress.isInvalid);
+			streamedUtf8.append(buffer, progress.written);
+			position += progress.read;
+		}
+		ASSERT_TRUE(utf8Stream.Finish());
+		EXPECT_EQ(text, streamedUtf8);
+	}
+}
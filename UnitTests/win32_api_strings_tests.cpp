@@ -1,13 +1,130 @@
 ﻿#include "pch.h"
+#include <MinCppXtra/traceable_exception.hpp>
 #include <MinCppXtra/win32_api_strings.hpp>
+#include <MinCppXtra/utfcpp/utf8/cpp20.h>
 
 #include <fcntl.h>
+#include <filesystem>
+#include <fstream>
 #include <io.h>
 #include <iostream>
+#include <random>
 #include <string>
 
 namespace unit_tests
 {
+	using mincpp::Win32ApiStrings;
+
+	/// <summary>
+	/// Runs a test once for every level of acceleration this machine supports.
+	/// </summary>
+	template <typename TestFn>
+	static void ForEachAcceleration(TestFn test)
+	{
+		Win32ApiStrings::LimitAcceleration(Win32ApiStrings::Acceleration::Avx2);
+		const auto supported = Win32ApiStrings::GetAcceleration();
+		for (auto level : {
+			Win32ApiStrings::Acceleration::None,
+			Win32ApiStrings::Acceleration::Sse2,
+			Win32ApiStrings::Acceleration::Avx2 })
+		{
+			if (level > supported)
+				break;
+
+			Win32ApiStrings::LimitAcceleration(level);
+			ASSERT_EQ(level, Win32ApiStrings::GetAcceleration());
+			SCOPED_TRACE("acceleration level " + std::to_string(static_cast<int>(level)));
+			test();
+		}
+		Win32ApiStrings::LimitAcceleration(supported);
+	}
+
+	/// <summary>
+	/// Gets either the transcoded text or a description of the error.
+	/// </summary>
+	template <typename TranscodeFn>
+	static std::string ToUtf8OrError(TranscodeFn transcode)
+	{
+		try
+		{
+			return transcode();
+		}
+		catch (const utf8::invalid_utf16& ex)
+		{
+			return "invalid UTF-16: " + std::to_string(ex.utf16_word());
+		}
+	}
+
+	static void ExpectSameAsUtfcpp(const std::u16string& text)
+	{
+		ASSERT_EQ(
+			ToUtf8OrError([&text]() { return utf8::utf16to8(text); }),
+			ToUtf8OrError([&text]() {
+				return Win32ApiStrings::ToUtf8(reinterpret_cast<const wchar_t*>(text.data()), text.size());
+			}));
+	}
+
+	/// <summary>
+	/// Gets either the transcoded text or a description of the error.
+	/// </summary>
+	template <typename TranscodeFn>
+	static std::wstring ToUtf16OrError(TranscodeFn transcode)
+	{
+		try
+		{
+			return transcode();
+		}
+		catch (const utf8::invalid_utf8& ex)
+		{
+			return L"invalid UTF-8: " + std::to_wstring(ex.utf8_octet());
+		}
+		catch (const utf8::invalid_code_point& ex)
+		{
+			return L"invalid code point: " + std::to_wstring(ex.code_point());
+		}
+		catch (const utf8::not_enough_room&)
+		{
+			return L"incomplete UTF-8";
+		}
+	}
+
+	static void ExpectSameAsUtfcpp(const std::string& text)
+	{
+		ASSERT_EQ(
+			ToUtf16OrError([&text]() {
+				const std::u16string utf16str = utf8::utf8to16(text);
+				return std::wstring(utf16str.begin(), utf16str.end());
+			}),
+			ToUtf16OrError([&text]() { return Win32ApiStrings::ToUtf16(text); }));
+
+		std::wstring utf16str;
+		const auto invalid = utf8::find_invalid(text);
+		ASSERT_EQ(invalid, Win32ApiStrings::TryToUtf16(text, utf16str));
+		if (invalid != std::string_view::npos)
+		{
+			const std::u16string expected = utf8::utf8to16(text.substr(0, invalid));
+			ASSERT_EQ(std::wstring(expected.begin(), expected.end()), utf16str);
+		}
+	}
+
+	static void AppendUtf8(char32_t codePoint, std::string& text)
+	{
+		utf8::append(codePoint, text);
+	}
+
+	static void AppendUtf16(char32_t codePoint, std::u16string& text)
+	{
+		if (codePoint < 0x10000)
+		{
+			text.push_back(static_cast<char16_t>(codePoint));
+		}
+		else
+		{
+			text.push_back(static_cast<char16_t>(0xD7C0 + (codePoint >> 10)));
+			text.push_back(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF)));
+		}
+	}
+
 	TEST(Win32ApiStrings, ToUtf8_ASCII_only)
 	{
 		wchar_t given[] = L"whatever in English";
@@ -24,6 +141,192 @@ namespace unit_tests
 		EXPECT_EQ(expected, mincpp::Win32ApiStrings::ToUtf8(reinterpret_cast<const wchar_t*>(given), 22));
 	}
 
+	TEST(Win32ApiStrings, ToUtf8_all_code_points)
+	{
+		std::u16string allCodePoints;
+		for (char32_t codePoint = 0; codePoint < 0x110000; ++codePoint)
+		{
+			if (codePoint < 0xD800 || codePoint > 0xDFFF)
+				AppendUtf16(codePoint, allCodePoints);
+		}
+
+		ForEachAcceleration([&allCodePoints]() {
+			// different alignments in the vectorized blocks
+			for (size_t offset : { 0, 1, 2, 3, 5, 7, 8, 15, 16, 31 })
+			{
+				ExpectSameAsUtfcpp(std::u16string(offset, u'a') + allCodePoints);
+			}
+		});
+	}
+
+	TEST(Win32ApiStrings, ToUtf8_invalid_surrogates)
+	{
+		ForEachAcceleration([]() {
+			for (size_t offset = 0; offset <= 32; ++offset)
+			{
+				const std::u16string padding(offset, u'a');
+				ExpectSameAsUtfcpp(padding + u'\xDC00' + padding);
+				ExpectSameAsUtfcpp(padding + u'\xD800' + padding);
+				ExpectSameAsUtfcpp(padding + u'\xD800' + u'\xD800' + padding);
+				ExpectSameAsUtfcpp(padding + u'\xD800');
+			}
+			EXPECT_THROW(Win32ApiStrings::ToUtf8(L"lone \xDC00 trail"), utf8::invalid_utf16);
+		});
+	}
+
+	TEST(Win32ApiStrings, ToUtf8_fuzzing)
+	{
+		ForEachAcceleration([]() {
+			std::mt19937 generator(2025);
+			for (int iteration = 0; iteration < 100000; ++iteration)
+			{
+				std::u16string text;
+				const size_t length = generator() % 100;
+				// (mostly ASCII in some, mostly not in others)
+				const uint32_t asciiOdds = 4 + iteration % 2 * 90;
+				while (text.size() < length)
+				{
+					const uint32_t choice = generator() % (asciiOdds + 7);
+					if (choice < asciiOdds)
+						text.push_back(static_cast<char16_t>(generator() % 0x80));
+					else if (choice < asciiOdds + 2)
+						text.push_back(static_cast<char16_t>(0x80 + generator() % 0x780));
+					else if (choice < asciiOdds + 4)
+						AppendUtf16(0x800 + generator() % 0xD000, text);
+					else if (choice < asciiOdds + 6)
+						AppendUtf16(0x10000 + generator() % 0x100000, text);
+					else if (generator() % 30 == 0)
+						text.push_back(static_cast<char16_t>(0xD800 + generator() % 0x800));
+				}
+				ExpectSameAsUtfcpp(text);
+			}
+		});
+	}
+
+	TEST(Win32ApiStrings, ToUtf16_all_code_points)
+	{
+		std::string allCodePoints;
+		for (char32_t codePoint = 0; codePoint < 0x110000; ++codePoint)
+		{
+			if (codePoint < 0xD800 || codePoint > 0xDFFF)
+				AppendUtf8(codePoint, allCodePoints);
+		}
+
+		ForEachAcceleration([&allCodePoints]() {
+			// different alignments in the vectorized blocks
+			for (size_t offset : { 0, 1, 2, 3, 5, 7, 8, 15, 16, 31 })
+			{
+				ExpectSameAsUtfcpp(std::string(offset, 'a') + allCodePoints);
+			}
+		});
+	}
+
+	TEST(Win32ApiStrings, ToUtf16_invalid_sequences)
+	{
+		const char* invalidSequences[] = {
+			"\x80", // continuation without lead
+			"\xBF\xBF",
+			"\xC0\x80", // overlong
+			"\xC1\xBF",
+			"\xE0\x9F\xBF",
+			"\xF0\x8F\xBF\xBF",
+			"\xED\xA0\x80", // surrogate
+			"\xED\xBF\xBF",
+			"\xF4\x90\x80\x80", // above U+10FFFF
+			"\xF5\x80\x80\x80",
+			"\xF8\x88\x80\x80\x80", // invalid lead
+			"\xFF",
+			"\xC3", // incomplete
+			"\xE2\x82",
+			"\xF0\x9F\x98",
+			"\xE2\x82\xAC\xAC", // too long
+		};
+
+		ForEachAcceleration([&invalidSequences]() {
+			for (const char* invalidSequence : invalidSequences)
+			{
+				for (size_t offset = 0; offset <= 33; ++offset)
+				{
+					const std::string padding(offset, 'a');
+					ExpectSameAsUtfcpp(padding + invalidSequence + padding + padding);
+					ExpectSameAsUtfcpp(padding + reinterpret_cast<const char*>(u8"çé") + invalidSequence + padding);
+					ExpectSameAsUtfcpp(padding + invalidSequence);
+				}
+			}
+		});
+	}
+
+	TEST(Win32ApiStrings, ToUtf16_fuzzing)
+	{
+		ForEachAcceleration([]() {
+			std::mt19937 generator(2025);
+			for (int iteration = 0; iteration < 100000; ++iteration)
+			{
+				std::string text;
+				const size_t length = generator() % 150;
+				// (mostly ASCII in some, mostly not in others)
+				const uint32_t asciiOdds = 4 + iteration % 2 * 90;
+				while (text.size() < length)
+				{
+					const uint32_t choice = generator() % (asciiOdds + 7);
+					if (choice < asciiOdds)
+						text.push_back(static_cast<char>(generator() % 0x80));
+					else if (choice < asciiOdds + 2)
+						AppendUtf8(0x80 + generator() % 0x780, text);
+					else if (choice < asciiOdds + 4)
+						AppendUtf8(0x800 + generator() % 0xD000, text);
+					else if (choice < asciiOdds + 6)
+						AppendUtf8(0x10000 + generator() % 0x100000, text);
+					else if (generator() % 30 == 0)
+						text.push_back(static_cast<char>(generator() % 0x100));
+				}
+				ExpectSameAsUtfcpp(text);
+			}
+		});
+	}
+
+	TEST(Win32ApiStrings, ValidationAndReplacement_same_as_utfcpp)
+	{
+		ForEachAcceleration([]() {
+			std::mt19937 generator(2025);
+			for (int iteration = 0; iteration < 50000; ++iteration)
+			{
+				std::string text;
+				const size_t length = generator() % 400;
+				// (few invalid bytes in some, many in others)
+				const uint32_t invalidOdds = 1 + iteration % 3 * 20;
+				while (text.size() < length)
+				{
+					const uint32_t choice = generator() % 8;
+					if (choice < 4)
+						text.push_back(static_cast<char>(generator() % 0x80));
+					else if (choice < 6)
+						AppendUtf8(0x80 + generator() % 0xD000, text);
+					else if (choice < 7)
+						AppendUtf8(0x10000 + generator() % 0x100000, text);
+					else if (generator() % 1000 < invalidOdds)
+						text.push_back(static_cast<char>(0x80 + generator() % 0x80));
+				}
+
+				const size_t invalid = utf8::find_invalid(text);
+				ASSERT_EQ(invalid, Win32ApiStrings::FindInvalidUtf8(text));
+				ASSERT_EQ(invalid == std::string::npos, Win32ApiStrings::IsValidUtf8(text));
+				ASSERT_EQ(utf8::replace_invalid(text), Win32ApiStrings::ReplaceInvalidUtf8(text));
+				ASSERT_EQ(utf8::replace_invalid(text, U'?'), Win32ApiStrings::ReplaceInvalidUtf8(text, U'?'));
+			}
+		});
+	}
+
+	TEST(Win32ApiStrings, ReplaceInvalidUtf8)
+	{
+		EXPECT_EQ("valid", Win32ApiStrings::ReplaceInvalidUtf8("valid"));
+		EXPECT_EQ("a?b", Win32ApiStrings::ReplaceInvalidUtf8("a\xC0\x80\x80" "b", U'?'));
+		EXPECT_EQ("a??b", Win32ApiStrings::ReplaceInvalidUtf8("a\x80\xFF" "b", U'?'));
+		EXPECT_EQ("a?", Win32ApiStrings::ReplaceInvalidUtf8("a\xF0\x9F\x98", U'?'));
+		EXPECT_EQ("a?b", Win32ApiStrings::ReplaceInvalidUtf8("a\xED\xA0\x80" "b", U'?'));
+		EXPECT_EQ(reinterpret_cast<const char*>(u8"a\uFFFDb"), Win32ApiStrings::ReplaceInvalidUtf8("a\xE2\x82" "b"));
+	}
+
 	TEST(Win32ApiStrings, ToUtf16_ASCII_only)
 	{
 		const char given[] = "whatever in English";
@@ -49,6 +352,289 @@ namespace unit_tests
 		EXPECT_EQ(expected, mincpp::Win32ApiStrings::ToUtf16(reinterpret_cast<const char*>(given), 24));
 	}
 
+	TEST(Win32ApiStrings, ToWide_all_code_points)
+	{
+		std::string allCodePoints;
+		for (char32_t codePoint = 0; codePoint < 0x110000; ++codePoint)
+		{
+			if (codePoint < 0xD800 || codePoint > 0xDFFF)
+				AppendUtf8(codePoint, allCodePoints);
+		}
+
+		// (wide-chars are whatever encoding fits wchar_t)
+		std::wstring expected;
+		if constexpr (sizeof(wchar_t) == sizeof(char16_t))
+		{
+			const std::u16string utf16str = utf8::utf8to16(allCodePoints);
+			expected.assign(utf16str.begin(), utf16str.end());
+		}
+		else
+		{
+			const std::u32string utf32str = utf8::utf8to32(allCodePoints);
+			expected.assign(utf32str.begin(), utf32str.end());
+		}
+
+		ForEachAcceleration([&allCodePoints, &expected]() {
+			const std::wstring widestr = Win32ApiStrings::ToWide(allCodePoints);
+			ASSERT_EQ(expected, widestr);
+			ASSERT_EQ(allCodePoints, Win32ApiStrings::ToUtf8(std::wstring_view(widestr)));
+			EXPECT_EQ(L"excluído ausgeschloßen", Win32ApiStrings::ToWide(reinterpret_cast<const char*>(u8"excluído ausgeschloßen")));
+		});
+	}
+
+	TEST(Win32ApiStrings, ToUtf8Into_buffer)
+	{
+		const std::wstring given = reinterpret_cast<const wchar_t*>(u"excluído ausgeschloßen 漢字 😀");
+		const std::string expected = reinterpret_cast<const char*>(u8"excluído ausgeschloßen 漢字 😀");
+		EXPECT_EQ(expected.length(), Win32ApiStrings::RequiredUtf8Length(given));
+
+		char buffer[64];
+		const size_t length = Win32ApiStrings::ToUtf8Into(given, buffer);
+		ASSERT_EQ(expected.length(), length);
+		EXPECT_EQ(expected, std::string_view(buffer, length));
+
+		char smallBuffer[8];
+		EXPECT_EQ(expected.length(), Win32ApiStrings::ToUtf8Into(given, smallBuffer));
+		EXPECT_EQ(0, Win32ApiStrings::ToUtf8Into(L"", smallBuffer));
+		EXPECT_THROW(Win32ApiStrings::ToUtf8Into(L"lone \xDC00 trail", buffer), utf8::invalid_utf16);
+	}
+
+	TEST(Win32ApiStrings, ToUtf16Into_buffer)
+	{
+		const std::string given = reinterpret_cast<const char*>(u8"excluído ausgeschloßen 漢字 😀");
+		const std::wstring expected = reinterpret_cast<const wchar_t*>(u"excluído ausgeschloßen 漢字 😀");
+		EXPECT_EQ(expected.length(), Win32ApiStrings::RequiredUtf16Length(given));
+
+		wchar_t buffer[64];
+		const size_t length = Win32ApiStrings::ToUtf16Into(given, buffer);
+		ASSERT_EQ(expected.length(), length);
+		EXPECT_EQ(expected, std::wstring_view(buffer, length));
+
+		wchar_t smallBuffer[8];
+		EXPECT_EQ(expected.length(), Win32ApiStrings::ToUtf16Into(given, smallBuffer));
+		EXPECT_EQ(0, Win32ApiStrings::ToUtf16Into("", smallBuffer));
+		EXPECT_THROW(Win32ApiStrings::ToUtf16Into("invalid \xC0\x80", buffer), utf8::invalid_utf8);
+	}
+
+	TEST(Win32ApiStrings, ToSmallString)
+	{
+		const std::string path = reinterpret_cast<const char*>(u8"C:\\Benutzer\\Jürgen\\Dokumente\\Übersicht.txt");
+		const std::wstring widePath = reinterpret_cast<const wchar_t*>(u"C:\\Benutzer\\Jürgen\\Dokumente\\Übersicht.txt");
+
+		mincpp::SmallWString<> utf16str;
+		Win32ApiStrings::ToUtf16(path, utf16str);
+		EXPECT_TRUE(utf16str.IsInline());
+		EXPECT_EQ(widePath, utf16str.GetView());
+		EXPECT_EQ(widePath, utf16str.GetData());
+
+		mincpp::SmallString<> utf8str;
+		Win32ApiStrings::ToUtf8(widePath, utf8str);
+		EXPECT_TRUE(utf8str.IsInline());
+		EXPECT_EQ(path, utf8str.GetView());
+
+		// beyond the inline capacity
+		std::string longPath;
+		while (longPath.length() < 1000)
+			longPath += path;
+
+		Win32ApiStrings::ToUtf16(longPath, utf16str);
+		EXPECT_FALSE(utf16str.IsInline());
+		EXPECT_EQ(Win32ApiStrings::ToUtf16(longPath), utf16str.GetView());
+
+		Win32ApiStrings::ToUtf8(utf16str, utf8str);
+		EXPECT_FALSE(utf8str.IsInline());
+		EXPECT_EQ(longPath, utf8str.GetView());
+	}
+
+	TEST(Win32ApiStrings, ToUtf16Parallel_same_as_serial)
+	{
+		std::mt19937 generator(2025);
+		for (int iteration = 0; iteration < 200; ++iteration)
+		{
+			std::string text;
+			const size_t length = generator() % 3000;
+			while (text.size() < length)
+			{
+				const uint32_t choice = generator() % 8;
+				if (choice < 4)
+					text.push_back(static_cast<char>(generator() % 0x80));
+				else if (choice < 6)
+					AppendUtf8(0x80 + generator() % 0xD000, text);
+				else if (choice < 7)
+					AppendUtf8(0x10000 + generator() % 0x100000, text);
+				else if (generator() % 300 == 0)
+					text.push_back(static_cast<char>(generator() % 0x100));
+			}
+
+			for (unsigned int threadCount : { 1, 2, 3, 8, 33 })
+			{
+				mincpp::TranscodingParallelism parallelism;
+				parallelism.threadCount = threadCount;
+				parallelism.serialThreshold = 0;
+				ASSERT_EQ(
+					ToUtf16OrError([&text]() { return Win32ApiStrings::ToUtf16(text); }),
+					ToUtf16OrError([&]() { return Win32ApiStrings::ToUtf16Parallel(text, parallelism); }));
+			}
+		}
+	}
+
+	TEST(Win32ApiStrings, ToUtf8Parallel_same_as_serial)
+	{
+		std::mt19937 generator(2025);
+		for (int iteration = 0; iteration < 200; ++iteration)
+		{
+			std::u16string text;
+			const size_t length = generator() % 3000;
+			while (text.size() < length)
+			{
+				const uint32_t choice = generator() % 8;
+				if (choice < 4)
+					text.push_back(static_cast<char16_t>(generator() % 0x80));
+				else if (choice < 6)
+					AppendUtf16(0x80 + generator() % 0xD000, text);
+				else if (choice < 7)
+					AppendUtf16(0x10000 + generator() % 0x100000, text);
+				else if (generator() % 300 == 0)
+					text.push_back(static_cast<char16_t>(0xD800 + generator() % 0x800));
+			}
+
+			const std::wstring_view wideText(reinterpret_cast<const wchar_t*>(text.data()), text.size());
+			for (unsigned int threadCount : { 1, 2, 3, 8, 33 })
+			{
+				mincpp::TranscodingParallelism parallelism;
+				parallelism.threadCount = threadCount;
+				parallelism.serialThreshold = 0;
+				ASSERT_EQ(
+					ToUtf8OrError([&]() { return Win32ApiStrings::ToUtf8(wideText.data(), wideText.size()); }),
+					ToUtf8OrError([&]() { return Win32ApiStrings::ToUtf8Parallel(wideText, parallelism); }));
+			}
+		}
+	}
+
+	TEST(Win32ApiStrings, ToUtf16Parallel_with_executor)
+	{
+		std::string text;
+		while (text.length() < 1000)
+			text += reinterpret_cast<const char*>(u8"excluído ausgeschloßen 漢字 😀 ");
+
+		size_t taskCount = 0;
+		mincpp::TranscodingParallelism parallelism;
+		parallelism.threadCount = 4;
+		parallelism.serialThreshold = 100;
+		parallelism.executor = [&taskCount](size_t count, const std::function<void(size_t)>& task) {
+			taskCount = count;
+			for (size_t idx = 0; idx < count; ++idx)
+				task(idx);
+		};
+		EXPECT_EQ(Win32ApiStrings::ToUtf16(text), Win32ApiStrings::ToUtf16Parallel(text, parallelism));
+		EXPECT_EQ(4, taskCount);
+
+		// below the threshold
+		taskCount = 0;
+		EXPECT_EQ(Win32ApiStrings::ToUtf16(text.substr(0, 99)), Win32ApiStrings::ToUtf16Parallel(text.substr(0, 99), parallelism));
+		EXPECT_EQ(0, taskCount);
+	}
+
+	static void WriteBytes(const std::filesystem::path& filePath, std::string_view bytes)
+	{
+		std::ofstream(filePath, std::ios::binary).write(bytes.data(), bytes.size());
+	}
+
+	static std::string ReadBytes(const std::filesystem::path& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	TEST(Win32ApiStrings, TranscodeFile_back_and_forth)
+	{
+		const auto utf8FilePath = std::filesystem::temp_directory_path() / "mincpp_transcode_test.utf8.txt";
+		const auto utf16FilePath = std::filesystem::temp_directory_path() / "mincpp_transcode_test.utf16.txt";
+
+		// (larger than the buffer for writing)
+		std::string text;
+		while (text.length() < (3 << 20))
+			text += reinterpret_cast<const char*>(u8"excluído ausgeschloßen 漢字 😀 ");
+
+		WriteBytes(utf8FilePath, text);
+		Win32ApiStrings::TranscodeFile(
+			utf8FilePath, utf16FilePath, Win32ApiStrings::TranscodingDirection::Utf8ToUtf16);
+
+		const std::wstring expected = Win32ApiStrings::ToUtf16(text);
+		const std::string utf16Bytes = ReadBytes(utf16FilePath);
+		ASSERT_EQ(expected.size() * sizeof(wchar_t), utf16Bytes.size());
+		EXPECT_EQ(0, memcmp(expected.data(), utf16Bytes.data(), utf16Bytes.size()));
+
+		std::filesystem::remove(utf8FilePath);
+		Win32ApiStrings::TranscodeFile(
+			utf16FilePath, utf8FilePath, Win32ApiStrings::TranscodingDirection::Utf16ToUtf8);
+
+		EXPECT_EQ(text, ReadBytes(utf8FilePath));
+
+		// an empty file
+		WriteBytes(utf8FilePath, "");
+		Win32ApiStrings::TranscodeFile(
+			utf8FilePath, utf16FilePath, Win32ApiStrings::TranscodingDirection::Utf8ToUtf16);
+
+		EXPECT_EQ("", ReadBytes(utf16FilePath));
+
+		std::filesystem::remove(utf8FilePath);
+		std::filesystem::remove(utf16FilePath);
+	}
+
+	TEST(Win32ApiStrings, TranscodeFile_invalid_text)
+	{
+		const auto sourceFilePath = std::filesystem::temp_directory_path() / "mincpp_transcode_test.source.txt";
+		const auto destinationFilePath = std::filesystem::temp_directory_path() / "mincpp_transcode_test.destination.txt";
+
+		WriteBytes(sourceFilePath, "valid until \xC0\x80 here");
+		EXPECT_THROW(
+			Win32ApiStrings::TranscodeFile(
+				sourceFilePath, destinationFilePath, Win32ApiStrings::TranscodingDirection::Utf8ToUtf16),
+			mincpp::TraceableException);
+
+		// odd count of bytes
+		WriteBytes(sourceFilePath, std::string_view("a\0b\0c", 5));
+		EXPECT_THROW(
+			Win32ApiStrings::TranscodeFile(
+				sourceFilePath, destinationFilePath, Win32ApiStrings::TranscodingDirection::Utf16ToUtf8),
+			mincpp::TraceableException);
+
+		EXPECT_THROW(
+			Win32ApiStrings::TranscodeFile(
+				std::filesystem::temp_directory_path() / "mincpp_transcode_test.missing.txt",
+				destinationFilePath,
+				Win32ApiStrings::TranscodingDirection::Utf8ToUtf16),
+			mincpp::TraceableException);
+
+		std::filesystem::remove(sourceFilePath);
+		std::filesystem::remove(destinationFilePath);
+	}
+
+	TEST(Win32ApiStrings, ValidateUtf8File)
+	{
+		const auto filePath = std::filesystem::temp_directory_path() / "mincpp_validate_test.txt";
+
+		std::string text;
+		while (text.length() < (1 << 20))
+			text += reinterpret_cast<const char*>(u8"excluído ausgeschloßen 漢字 😀 ");
+
+		WriteBytes(filePath, text);
+		EXPECT_EQ(std::string_view::npos, Win32ApiStrings::ValidateUtf8File(filePath));
+
+		WriteBytes(filePath, text + "\xED\xA0\x80" + text);
+		EXPECT_EQ(text.length(), Win32ApiStrings::ValidateUtf8File(filePath));
+
+		// incomplete at the end
+		WriteBytes(filePath, text + "\xF0\x9F");
+		EXPECT_EQ(text.length(), Win32ApiStrings::ValidateUtf8File(filePath));
+
+		WriteBytes(filePath, "");
+		EXPECT_EQ(std::string_view::npos, Win32ApiStrings::ValidateUtf8File(filePath));
+
+		std::filesystem::remove(filePath);
+	}
+
 	TEST(Win32ApiStrings, UnicodeInStringStream)
 	{
 		int prevOutMode = _setmode(_fileno(stdout), _O_U16TEXT);
@@ -0,0 +1,62 @@
+﻿#include "pch.h"
+#include <MinCppXtra/win32_errors.hpp>
+
+#include <cerrno>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+#include <windows.h>
+
+namespace unit_tests
+{
+	TEST(Win32Errors, GetErrorMessage)
+	{
+		const std::string message = mincpp::Win32Errors::GetErrorMessage(ERROR_FILE_NOT_FOUND, "CreateFileW");
+		const std::string prefix = "CreateFileW returned error 2: ";
+		ASSERT_LT(prefix.length(), message.length());
+		EXPECT_EQ(prefix, message.substr(0, prefix.length()));
+		EXPECT_NE('\n', message.back());
+
+		// now from the catalog
+		EXPECT_EQ(message, mincpp::Win32Errors::GetErrorMessage(ERROR_FILE_NOT_FOUND, "CreateFileW"));
+
+		std::ostringstream oss;
+		mincpp::Win32Errors::AppendErrorMessage(ERROR_FILE_NOT_FOUND, "CreateFileW", oss);
+		EXPECT_EQ(message, oss.str());
+
+		std::pmr::monotonic_buffer_resource resource;
+		EXPECT_EQ(message, mincpp::Win32Errors::GetErrorMessage(ERROR_FILE_NOT_FOUND, "CreateFileW", &resource));
+	}
+
+	TEST(Win32Errors, GetErrorMessageOfUnknownCode)
+	{
+		for (int repetition = 0; repetition < 2; ++repetition)
+		{
+			EXPECT_EQ("Win32 API error code 3735928559: Unknown error 0xDEADBEEF",
+					  mincpp::Win32Errors::GetErrorMessage(0xDEADBEEF, nullptr));
+		}
+	}
+
+	TEST(Win32Errors, ErrorCode)
+	{
+		const std::error_code errorCode = mincpp::Win32Errors::MakeErrorCode(ERROR_ACCESS_DENIED);
+		EXPECT_STREQ("win32", errorCode.category().name());
+		EXPECT_EQ(std::errc::permission_denied, errorCode);
+
+		const std::string message = mincpp::Win32Errors::GetErrorMessage(ERROR_ACCESS_DENIED, nullptr);
+		EXPECT_EQ("Win32 API error code 5: " + errorCode.message(), message);
+	}
+
+	TEST(Win32Errors, GetErrnoMessage)
+	{
+		const std::string text = std::generic_category().message(ENOENT);
+		EXPECT_EQ("fopen returned errno 2: " + text, mincpp::Win32Errors::GetErrnoMessage(ENOENT, "fopen"));
+		EXPECT_EQ("errno 2: " + text, mincpp::Win32Errors::GetErrnoMessage(ENOENT, nullptr));
+
+		const std::error_code errorCode(ENOENT, mincpp::Win32Errors::GetErrnoCategory());
+		EXPECT_EQ(std::errc::no_such_file_or_directory, errorCode);
+		EXPECT_EQ(text, errorCode.message());
+	}
+}
@@ -3,8 +3,11 @@
 
 #include <MinCppXtra/call_stack_access_scope.hpp>
 #include <MinCppXtra/seh_translation_scope.hpp>
+#include <MinCppXtra/stack_overflow_guard_scope.hpp>
 #include <MinCppXtra/win32_exception.hpp>
 
+#include <optional>
+
 namespace unit_tests
 {
 	static __declspec(noinline) int DividePerZero(int number)
@@ -12,6 +15,18 @@ namespace unit_tests
 		return number / 0;
 	}
 
+	static __declspec(noinline) int ReadNull(volatile int* address)
+	{
+		return *address;
+	}
+
+	static __declspec(noinline) int Recurse(int depth)
+	{
+		volatile char frame[256]{};
+		frame[0] = static_cast<char>(depth);
+		return (depth < 0) ? 0 : Recurse(depth + 1) + frame[0];
+	}
+
 #ifdef NDEBUG
 	// release build crashes when walking stack upon SEH translation
 #   define HAS_STACK_TRACE false
@@ -52,4 +67,53 @@ namespace unit_tests
 			std::cout << ex.Serialize();
 		}
 	}
+
+	template <typename Fault>
+	static uint64_t GetFaultSiteKey(Fault fault)
+	{
+		try
+		{
+			mincpp::SehTranslationScope sehTranslationScope;
+			fault();
+		}
+		catch (mincpp::Win32Exception& ex)
+		{
+			return ex.GetThrowSiteKey();
+		}
+		return 0;
+	}
+
+	TEST(Win32Exception, FaultSiteKey)
+	{
+		const auto divide = []() { return DividePerZero(1); };
+		const auto read = []() { return ReadNull(nullptr); };
+
+		const uint64_t divisionKey = GetFaultSiteKey(divide);
+		EXPECT_NE(0, divisionKey);
+		EXPECT_EQ(divisionKey, GetFaultSiteKey(divide));
+		EXPECT_NE(divisionKey, GetFaultSiteKey(read));
+	}
+
+	TEST(Win32Exception, StackOverflowTranslation)
+	{
+		// the catch block runs on top of the overflown stack, so keep a copy for later
+		std::optional<mincpp::Win32Exception> caught;
+		try
+		{
+			mincpp::CallStackAccessScope callStackAccessScope;
+			mincpp::SehTranslationScope sehTranslationScope;
+			mincpp::StackOverflowGuardScope stackOverflowGuardScope;
+			Recurse(1);
+		}
+		catch (mincpp::Win32Exception& ex)
+		{
+			caught.emplace(ex);
+		}
+		EXPECT_TRUE(mincpp::StackOverflowGuardScope::RestoreGuardPage());
+
+		ASSERT_TRUE(caught.has_value()) << "stack overflow has not been translated!";
+		EXPECT_EQ(1, CountMatches(NAMEOF(EXCEPTION_STACK_OVERFLOW), caught->what()));
+		std::string cst = caught->GetCallStackTrace();
+		EXPECT_EQ(HAS_STACK_TRACE ? 1 : 0, CountMatches("repeated", cst)) << cst;
+	}
 }
\ No newline at end of file